@@ -23,7 +23,7 @@ void HCalRawDigi::onProcessStart() {
 }
 
 void HCalRawDigi::analyze(const framework::Event& event) {
-  auto digis{
+  const auto& digis{
       event.getObject<ldmx::HgcrocDigiCollection>(input_name_, input_pass_)};
   /**
    * we can do this incrementing of channel indices because the decoder
@@ -16,7 +16,10 @@
 #include "TVector3.h"
 
 // STL
+#include <array>
 #include <map>
+#include <stdexcept>
+#include <vector>
 
 namespace hcal {
 class HcalGeometryProvider;
@@ -63,25 +66,88 @@ class HcalGeometry : public framework::ConditionsObject {
   ScintillatorOrientation getScintillatorOrientation(
       const ldmx::HcalID id) const;
 
+  /**
+   * Get the dense index of a layer.
+   *
+   * Layers are packed in (section, layer) order, so the layers of a section
+   * are contiguous.
+   *
+   * @throw std::out_of_range if the layer is not in the geometry.
+   *
+   * @param isection
+   * @param layer (numbering starts at 1)
+   * @return index into the per-layer tables
+   */
+  std::size_t getLayerIndex(int isection, int layer) const {
+    if (isection < 0 or isection >= num_sections_ or layer < 1 or
+        layer > num_layers_[isection]) {
+      throw std::out_of_range("HcalGeometry: layer is not in the geometry");
+    }
+    return section_offsets_[isection] + layer - 1;
+  }
+
+  /**
+   * Get the dense index of a strip.
+   *
+   * Strips are packed in (section, layer, strip) order, so the strips of a
+   * layer are contiguous and start at getStripIndex({section, layer, 0}).
+   *
+   * @throw std::out_of_range if HcalID is not in the geometry.
+   *
+   * @param id HcalID of the strip
+   * @return index into getStripCenters()
+   */
+  std::size_t getStripIndex(ldmx::HcalID id) const {
+    const auto layer_index{getLayerIndex(id.section(), id.layer())};
+    const auto index{layer_offsets_[layer_index] + id.strip()};
+    if (index >= layer_offsets_[layer_index + 1]) {
+      throw std::out_of_range("HcalGeometry: strip is not in the geometry");
+    }
+    return index;
+  }
+
   /**
    * Get a strip center position from a combined hcal ID.
    *
    * @throw std::out_of_range if HcalID is not on map.
    *
    * @param HcalID
+   * @return The X, Y and Z position of the center of the bar [mm]
+   */
+  const std::array<double, 3> &getStripCenter(ldmx::HcalID id) const {
+    return strip_positions_[getStripIndex(id)];
+  }
+
+  /**
+   * Get a strip center position from a combined hcal ID.
+   *
+   * @see getStripCenter for a version that doesn't construct a TVector3
+   *
+   * @throw std::out_of_range if HcalID is not on map.
+   *
+   * @param HcalID
    * @return A TVector3 with the X, Y and Z position of the center of the bar.
    */
   TVector3 getStripCenterPosition(ldmx::HcalID id) const {
-    return strip_position_map_.at(id);
+    const auto &pos{getStripCenter(id)};
+    return TVector3(pos[0], pos[1], pos[2]);
   }
 
   /**
-   * Get the strip position map
+   * Get the center positions of all strips, indexed by getStripIndex.
    */
-  std::map<ldmx::HcalID, TVector3> getStripPositionMap() const {
-    return strip_position_map_;
+  const std::vector<std::array<double, 3>> &getStripCenters() const {
+    return strip_positions_;
   }
 
+  /**
+   * Get the strip position map
+   *
+   * This is built from the dense position table on each call, prefer
+   * getStripCenters() or getStripCenter() in loops.
+   */
+  std::map<ldmx::HcalID, TVector3> getStripPositionMap() const;
+
   /** Check whether a given layer corresponds to a horizontal (scintillator
    * length along the x-axis) or vertical layer in the back HCal. See the
    * back_horizontal_parity_ member for details.
@@ -97,9 +163,7 @@ class HcalGeometry : public framework::ConditionsObject {
    * @return half total width [mm]
    */
   double getHalfTotalWidth(int isection, int layer = 1) const {
-    // Layer numbering starts at 1, but a vector is zero-indexed
-    auto layer_index = layer - 1;
-    return half_total_width_.at(isection).at(layer_index);
+    return layer_half_width_[getLayerIndex(isection, layer)];
   }
 
   /**
@@ -204,6 +268,12 @@ class HcalGeometry : public framework::ConditionsObject {
   HcalGeometry(const framework::config::Parameters &ps);
   friend class hcal::HcalGeometryProvider;
 
+  /**
+   * Build the dense per-layer and per-strip index offsets along with the
+   * per-layer half widths.
+   */
+  void buildStripIndex();
+
   /**
    * Map builder of HcalID and position.
    * To build the map we loop over the number of Hcal sections, layers and
@@ -217,14 +287,14 @@ class HcalGeometry : public framework::ConditionsObject {
   void buildStripPositionMap();
   /**
    * Debugging utility, prints out the HcalID and corresponding value of all
-   * entries in the strip_position_map_ for a given section.
+   * entries in the strip position table for a given section.
    *
    * @param section The section number to print, see HcalID for details.
    */
   void printPositionMap(int section) const;
   /**
    * Debugging utility, prints out the HcalID and corresponding value of all
-   * entries in the strip_position_map_. For printing only one of the sections,
+   * entries in the strip position table. For printing only one of the sections,
    * see the overloaded version of this function taking a section parameter.
    *
    */
@@ -283,11 +353,19 @@ class HcalGeometry : public framework::ConditionsObject {
 
   bool is_prototype_{};
 
+  /// Index of the first layer of each section in the per-layer tables
+  std::vector<std::size_t> section_offsets_;
+  /// Index of the first strip of each layer, with one trailing end entry
+  std::vector<std::size_t> layer_offsets_;
+  /// Half total width of each layer, indexed by getLayerIndex [mm]
+  std::vector<double> layer_half_width_;
+
   /**
-   Map of the HcalID position of strip centers relative to world geometry.
-   The map is not configurable and is calculated by buildStripPositionMap().
+   Position of strip centers relative to world geometry, indexed by
+   getStripIndex. This is not configurable and is calculated by
+   buildStripPositionMap().
    */
-  std::map<ldmx::HcalID, TVector3> strip_position_map_;
+  std::vector<std::array<double, 3>> strip_positions_;
 };
 
 }  // namespace ldmx
@@ -40,6 +40,7 @@ HcalGeometry::HcalGeometry(const framework::config::Parameters &ps)
   scint_length_ =
       ps.getParameter<std::vector<std::vector<double>>>("scint_length");
 
+  buildStripIndex();
   buildStripPositionMap();
 
   if (verbose_ > 0) {
@@ -159,6 +160,36 @@ void HcalGeometry::printPositionMap(int section) const {
   }
 }
 
+std::map<ldmx::HcalID, TVector3> HcalGeometry::getStripPositionMap() const {
+  std::map<ldmx::HcalID, TVector3> position_map;
+  for (int section = 0; section < num_sections_; ++section) {
+    for (int layer = 1; layer <= num_layers_[section]; ++layer) {
+      for (int strip = 0; strip < getNumStrips(section, layer); ++strip) {
+        const ldmx::HcalID id(section, layer, strip);
+        position_map.emplace_hint(position_map.end(), id,
+                                  getStripCenterPosition(id));
+      }
+    }
+  }
+  return position_map;
+}
+
+void HcalGeometry::buildStripIndex() {
+  section_offsets_.assign(num_sections_ + 1, 0);
+  layer_offsets_.assign(1, 0);
+  layer_half_width_.clear();
+  for (int section = 0; section < num_sections_; section++) {
+    section_offsets_[section + 1] =
+        section_offsets_[section] + num_layers_.at(section);
+    for (int layer = 1; layer <= num_layers_[section]; layer++) {
+      layer_offsets_.push_back(layer_offsets_.back() +
+                               getNumStrips(section, layer));
+      layer_half_width_.push_back(half_total_width_.at(section).at(layer - 1));
+    }
+  }
+  strip_positions_.assign(layer_offsets_.back(), {-99999, -99999, -99999});
+}
+
 void HcalGeometry::buildStripPositionMap() {
   // We hard-code the number of sections as seen in HcalID
   for (unsigned int section = 0; section < num_sections_; section++) {
@@ -311,9 +342,7 @@ void HcalGeometry::buildStripPositionMap() {
         }
 
         y += y_offset_;
-        TVector3 pos;
-        pos.SetXYZ(x, y, z);
-        strip_position_map_[ldmx::HcalID(section, layer, strip)] = pos;
+        strip_positions_[getStripIndex(id)] = {x, y, z};
       }  // loop over strips
     }    // loop over layers
   }      // loop over sections
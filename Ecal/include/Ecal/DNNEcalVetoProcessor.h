@@ -60,6 +60,8 @@ class DNNEcalVetoProcessor : public framework::Producer {
 
   float disc_cut_ = -99;
   std::vector<std::vector<float>> data_;
+  /// output arrays of the DNN, re-used from event to event
+  ldmx::Ort::FloatArrays outputs_;
   std::unique_ptr<ldmx::Ort::ONNXRuntime> rt_;
 
   /** Name of the collection which will containt the results. */
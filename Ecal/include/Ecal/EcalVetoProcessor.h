@@ -63,17 +63,26 @@ class EcalVetoProcessor : public framework::Producer {
   ldmx::EcalID GetShowerCentroidIDAndRMS(
       const std::vector<ldmx::EcalHit>& ecalRecHits, double& showerRMS);
 
-  /* Function to load up empty vector of hit maps */
-  void fillHitMap(const std::vector<ldmx::EcalHit>& ecalRecHits,
-                  std::map<ldmx::EcalID, float>& cellMap_);
+  /* Function to build the nearest neighbour index tables from the geometry */
+  void buildNeighbourTables();
 
-  /* Function to take loaded hit maps and find isolated hits in them */
+  /* Function to mark the cells with a hit in the dense occupancy array */
+  void fillHitMap(const std::vector<ldmx::EcalHit>& ecalRecHits);
+
+  /* Function to find the isolated hits using the loaded occupancy array */
   void fillIsolatedHitMap(const std::vector<ldmx::EcalHit>& ecalRecHits,
                           ldmx::EcalID globalCentroid,
-                          std::map<ldmx::EcalID, float>& cellMap_,
-                          std::map<ldmx::EcalID, float>& cellMapIso_,
+                          std::vector<CellEnergyPair>& cellMapIso_,
                           bool doTight = false);
 
+  /* Index of a cell within its layer, used by the neighbour tables */
+  int flatCellIndex(ldmx::EcalID id) const {
+    return id.module() * nCellsPerModule_ + id.cell();
+  }
+
+  /* Check if the probe cell is a nearest neighbour of the centroid cell */
+  bool isNeighbour(int centroidFlatCell, int probeFlatCell) const;
+
   std::vector<XYCoords> getTrajectory(std::vector<double> momentum,
                                       std::vector<float> position);
 
@@ -102,9 +111,62 @@ class EcalVetoProcessor : public framework::Producer {
    */
   float distPtToLine(TVector3 h1, TVector3 p1, TVector3 p2);
 
+  /**
+   * Bucket the MIP tracking hits by layer, sorted by x within each layer,
+   * so that looking for hits near a point is a range query instead of a
+   * scan over the whole hit list.
+   *
+   * @param[in] hits MIP tracking hit list the buckets will index into
+   */
+  void indexTrackingHits(const std::vector<HitData>& hits);
+
+  /**
+   * Find the hit extending a straight track from the current hit: the first
+   * unused hit (in hit list order) one layer in front of it, or two layers in
+   * front if there is none, that is within the window in both x and y.
+   *
+   * @param[in] hits MIP tracking hit list sorted by decreasing layer
+   * @param[in] used flags for hits already claimed by a track
+   * @param[in] current index of the last hit in the track
+   * @param[in] window maximum x and y deviation [mm]
+   * @returns index of the next hit in the track or -1 if there is none
+   */
+  int nextStraightTrackHit(const std::vector<HitData>& hits,
+                           const std::vector<bool>& used, int current,
+                           float window) const;
+
+  /**
+   * Collect the unused hits within some distance of a center hit,
+   * not including the center hit itself.
+   *
+   * @param[in] hits MIP tracking hit list
+   * @param[in] used flags for hits already claimed by a track
+   * @param[in] center index of the hit at the center of the region
+   * @param[in] radius maximum distance from the center hit [mm]
+   * @param[out] region indices of hits in the region in hit list order
+   */
+  void findHitsInRegion(const std::vector<HitData>& hits,
+                        const std::vector<bool>& used, int center,
+                        float radius, std::vector<int>& region) const;
+
  private:
-  std::map<ldmx::EcalID, float> cellMap_;
-  std::map<ldmx::EcalID, float> cellMapTightIso_;
+  /// Isolated hits found for the tight isolation sum
+  std::vector<CellEnergyPair> cellMapTightIso_;
+
+  /// Number of cells in each module of the geometry the tables were built for
+  int nCellsPerModule_{0};
+  /// Number of cells in each layer of the geometry the tables were built for
+  int nCellsPerLayer_{0};
+  /// Geometry the neighbour tables were built from
+  const ldmx::EcalGeometry* nnGeometry_{nullptr};
+  /// Start of the neighbour list of each flat cell index in nnCells_
+  std::vector<int> nnOffsets_;
+  /// Flat cell indices of the nearest neighbours of each cell
+  std::vector<int> nnCells_;
+  /// Cells with a hit this event, indexed by layer and flat cell index
+  std::vector<char> cellOccupancy_;
+  /// Entries of cellOccupancy_ set this event so they can be reset
+  std::vector<int> occupiedCells_;
 
   std::vector<float> ecalLayerEdepRaw_;
   std::vector<float> ecalLayerEdepReadout_;
@@ -141,6 +203,8 @@ class EcalVetoProcessor : public framework::Producer {
   /// Distance between the projected photon and electron trajectories at the
   /// ECal face (currently unused)
   float epSep_{0};
+  /// MIP tracking hits in each layer as (x, index in hit list), sorted by x
+  std::vector<std::vector<std::pair<double, int>>> trackingHitsByLayer_;
 
   double bdtCutVal_{0};
 
@@ -158,6 +222,12 @@ class EcalVetoProcessor : public framework::Producer {
   std::string collectionName_{"EcalVeto"};
 
   std::unique_ptr<ldmx::Ort::ONNXRuntime> rt_;
+  /// Names of the BDT input and output nodes
+  const std::vector<std::string> bdtInputNames_{"features"};
+  const std::vector<std::string> bdtOutputNames_{"probabilities"};
+  /// BDT input and output arrays, re-used from event to event
+  ldmx::Ort::FloatArrays bdtInputs_{1};
+  ldmx::Ort::FloatArrays bdtOutputs_;
 
   /// handle to current geometry (to share with member functions)
   const ldmx::EcalGeometry* geometry_;
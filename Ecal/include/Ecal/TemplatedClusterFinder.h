@@ -7,6 +7,9 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <map>
 
 #include "Ecal/WorkingCluster.h"
@@ -26,40 +29,46 @@ class TemplatedClusterFinder {
     return a.centroid().E() > b.centroid().E();
   }
 
+  /**
+   * Merge clusters until the smallest weight between a seed and
+   * any other cluster reaches the cutoff.
+   *
+   * Clusters only gain energy when they are merged, so after the initial
+   * sort the seeds stay at the front of the list and a pair of clusters is
+   * a merge candidate when the first of them is a seed. For each seed we
+   * keep the partner further down the list with the smallest weight (ties
+   * going to the earlier partner), so each merge only re-evaluates the
+   * weights involving the two clusters that were merged instead of all of
+   * them. The pair merged at each step is the same one a full scan over
+   * all pairs would pick.
+   */
   void cluster(double seed_threshold, double cutoff) {
     int ncluster = clusters_.size();
     double minwgt = cutoff;
 
     std::sort(clusters_.begin(), clusters_.end(), compClusters);
-    do {
-      bool any = false;
-      size_t mi(0), mj(0);
 
-      int nseeds = 0;
+    std::size_t nseeds_initial = 0;
+    while (nseeds_initial < clusters_.size() &&
+           clusters_[nseeds_initial].centroid().E() >= seed_threshold)
+      nseeds_initial++;
+    int nseeds = nseeds_initial;
 
-      for (size_t i = 0; i < clusters_.size(); i++) {
-        if (clusters_[i].empty()) continue;
-
-        bool iseed = (clusters_[i].centroid().E() >= seed_threshold);
-        if (iseed) {
-          nseeds++;
-        } else {
-          // Since we sorted initially if we find a hit below seed threshold
-          // it is guaranteed that there will be no seeds after.
-          break;
-        }
+    nearest_.assign(nseeds_initial, NO_PARTNER);
+    nearestWgt_.assign(nseeds_initial, 0.);
+    for (std::size_t i = 0; i < nseeds_initial; i++) findNearest(i);
 
-        for (size_t j = i + 1; j < clusters_.size(); j++) {
-          if (clusters_[j].empty() ||
-              (!iseed && clusters_[j].centroid().E() < seed_threshold))
-            continue;
-          double wgt = wgt_(clusters_[i], clusters_[j]);
-          if (!any || wgt < minwgt) {
-            any = true;
-            minwgt = wgt;
-            mi = i;
-            mj = j;
-          }
+    do {
+      bool any = false;
+      std::size_t mi(0), mj(0);
+
+      for (std::size_t i = 0; i < nearest_.size(); i++) {
+        if (nearest_[i] == NO_PARTNER) continue;
+        if (!any || nearestWgt_[i] < minwgt) {
+          any = true;
+          minwgt = nearestWgt_[i];
+          mi = i;
+          mj = nearest_[i];
         }
       }
 
@@ -76,6 +85,8 @@ class TemplatedClusterFinder {
         clusters_[mj].clear();
         // decrement cluster count
         ncluster--;
+        if (mj < nseeds_initial) nseeds--;
+        updateNearest(mi, mj);
       }
 
     } while (minwgt < cutoff && ncluster > 1);
@@ -86,9 +97,51 @@ class TemplatedClusterFinder {
 
   int getNSeeds() const { return nseeds_; }
 
-  std::map<int, double> getWeights() const { return transitionWeights_; }
+  const std::map<int, double>& getWeights() const {
+    return transitionWeights_;
+  }
+
+  const std::vector<WorkingCluster>& getClusters() const { return clusters_; }
 
-  std::vector<WorkingCluster> getClusters() const { return clusters_; }
+ private:
+  /**
+   * Find the partner with the smallest weight for seed i
+   * among the non-empty clusters after it in the list.
+   */
+  void findNearest(std::size_t i) {
+    nearest_[i] = NO_PARTNER;
+    if (clusters_[i].empty()) return;
+    for (std::size_t j = i + 1; j < clusters_.size(); j++) {
+      if (clusters_[j].empty()) continue;
+      double wgt = wgt_(clusters_[i], clusters_[j]);
+      if (nearest_[i] == NO_PARTNER || wgt < nearestWgt_[i]) {
+        nearest_[i] = j;
+        nearestWgt_[i] = wgt;
+      }
+    }
+  }
+
+  /**
+   * Update the nearest partners after cluster merged was merged into
+   * cluster kept.
+   */
+  void updateNearest(std::size_t kept, std::size_t merged) {
+    if (merged < nearest_.size()) nearest_[merged] = NO_PARTNER;
+    for (std::size_t r = 0; r < nearest_.size(); r++) {
+      if (r == kept || nearest_[r] == NO_PARTNER) continue;
+      if (nearest_[r] == kept || nearest_[r] == merged) {
+        findNearest(r);
+      } else if (r < kept) {
+        double wgt = wgt_(clusters_[r], clusters_[kept]);
+        if (wgt < nearestWgt_[r] ||
+            (wgt == nearestWgt_[r] && kept < nearest_[r])) {
+          nearest_[r] = kept;
+          nearestWgt_[r] = wgt;
+        }
+      }
+    }
+    if (kept < nearest_.size()) findNearest(kept);
+  }
 
  private:
   WeightClass wgt_;
@@ -96,6 +149,13 @@ class TemplatedClusterFinder {
   int nseeds_;
   std::map<int, double> transitionWeights_;
   std::vector<WorkingCluster> clusters_;
+  /// marks a seed without any partner left
+  static constexpr std::size_t NO_PARTNER{
+      std::numeric_limits<std::size_t>::max()};
+  /// index of the partner with the smallest weight for each seed
+  std::vector<std::size_t> nearest_;
+  /// weight between each seed and its nearest partner
+  std::vector<double> nearestWgt_;
 };
 }  // namespace ecal
 
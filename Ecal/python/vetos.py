@@ -20,6 +20,7 @@ class EcalVetoProcessor(ldmxcfg.Producer) :
         self.bdt_file = makeBDTPath( "gabrielle" )
         self.cellxy_file = makeCellXYPath()
         self.disc_cut = 0.99
+        self.intra_op_threads = 1
         self.collection_name = "EcalVeto"
         self.rec_coll_name = 'EcalRecHits'
         self.rec_pass_name = ''
@@ -39,6 +40,7 @@ class DNNEcalVetoProcessor(ldmxcfg.Producer) :
         from LDMX.Ecal.makePath import makeBDTPath
         self.model_path = makeBDTPath("particle-net_ecal_v9")
         self.disc_cut = -1.
+        self.intra_op_threads = 1
         self.collection_name = "EcalVetoDNN"
 
 
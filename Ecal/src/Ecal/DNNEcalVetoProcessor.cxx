@@ -23,8 +23,11 @@ DNNEcalVetoProcessor::DNNEcalVetoProcessor(const std::string& name,
 void DNNEcalVetoProcessor::configure(
     framework::config::Parameters& parameters) {
   disc_cut_ = parameters.getParameter<double>("disc_cut");
+  ::Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(
+      parameters.getParameter<int>("intra_op_threads", 1));
   rt_ = std::make_unique<ldmx::Ort::ONNXRuntime>(
-      parameters.getParameter<std::string>("model_path"));
+      parameters.getParameter<std::string>("model_path"), &session_options);
 
   // debug mode
   debug_ = parameters.getParameter<bool>("debug");
@@ -41,7 +44,7 @@ void DNNEcalVetoProcessor::produce(framework::Event& event) {
       ldmx::EcalGeometry::CONDITIONS_OBJECT_NAME);
 
   // Get the collection of digitized Ecal hits from the event.
-  const auto ecalRecHits = event.getCollection<ldmx::EcalHit>("EcalRecHits");
+  const auto& ecalRecHits = event.getCollection<ldmx::EcalHit>("EcalRecHits");
   auto nhits = std::count_if(
       ecalRecHits.begin(), ecalRecHits.end(),
       [](const ldmx::EcalHit& hit) { return hit.getEnergy() > 0; });
@@ -50,8 +53,8 @@ void DNNEcalVetoProcessor::produce(framework::Event& event) {
     // make inputs
     make_inputs(ecal_geometry, ecalRecHits);
     // run the DNN
-    auto outputs = rt_->run(input_names_, data_)[0];
-    result.setDiscValue(outputs.at(1));
+    rt_->run(input_names_, data_, {}, outputs_);
+    result.setDiscValue(outputs_[0].at(1));
   } else {
     result.setDiscValue(-99);
   }
@@ -30,7 +30,7 @@ void EcalClusterProducer::produce(framework::Event& event) {
 
   TemplatedClusterFinder<MyClusterWeight> cf;
 
-  std::vector<ldmx::EcalHit> ecalHits =
+  const std::vector<ldmx::EcalHit>& ecalHits =
       event.getCollection<ldmx::EcalHit>("ecalDigis", digisPassName_);
   int nEcalDigis = ecalHits.size();
 
@@ -39,7 +39,7 @@ void EcalClusterProducer::produce(framework::Event& event) {
     return;
   }
 
-  for (ldmx::EcalHit& hit : ecalHits) {
+  for (const ldmx::EcalHit& hit : ecalHits) {
     // Skip zero energy digis.
     if (hit.getEnergy() == 0) {
       continue;
@@ -49,9 +49,9 @@ void EcalClusterProducer::produce(framework::Event& event) {
   }
 
   cf.cluster(seedThreshold_, cutoff_);
-  std::vector<WorkingCluster> wcVec = cf.getClusters();
+  const std::vector<WorkingCluster>& wcVec = cf.getClusters();
 
-  std::map<int, double> cWeights = cf.getWeights();
+  const std::map<int, double>& cWeights = cf.getWeights();
 
   ldmx::ClusterAlgoResult algoResult;
   algoResult.set(algoName_, 3, cWeights.rbegin()->first);
@@ -59,13 +59,13 @@ void EcalClusterProducer::produce(framework::Event& event) {
   algoResult.setAlgoVar(1, seedThreshold_);
   algoResult.setAlgoVar(2, cf.getNSeeds());
 
-  std::map<int, double>::iterator it = cWeights.begin();
+  std::map<int, double>::const_iterator it = cWeights.begin();
   for (it = cWeights.begin(); it != cWeights.end(); it++) {
     algoResult.setWeight(it->first, it->second / 100);
   }
 
   std::vector<ldmx::EcalCluster> ecalClusters;
-  for (int aWC = 0; aWC < wcVec.size(); aWC++) {
+  for (std::size_t aWC = 0; aWC < wcVec.size(); aWC++) {
     ldmx::EcalCluster cluster;
 
     cluster.setEnergy(wcVec[aWC].centroid().E());
@@ -102,7 +102,7 @@ void EcalDigiProducer::produce(framework::Event& event) {
   //  from G4CalorimeterHits to SimCalorimeterHits this class ensures that only
   //  one SimCalorimeterHit is generated per cell, but multiple "contributions"
   //  are still handled within SimCalorimeterHit
-  auto ecalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
+  const auto& ecalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
       inputCollName_, inputPassName_)};
 
   /* debug printout
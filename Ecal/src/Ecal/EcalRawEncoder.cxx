@@ -31,7 +31,7 @@ void EcalRawEncoder::produce(framework::Event& event) {
    */
   static const unsigned int common_mode_channel = roc_version_ == 2 ? 19 : 1;
 
-  auto digis{
+  const auto& digis{
       event.getObject<ldmx::HgcrocDigiCollection>(input_name_, input_pass_)};
   std::vector<std::map<
       uint16_t, std::map<uint16_t, std::map<uint32_t, uint32_t>  // channel to
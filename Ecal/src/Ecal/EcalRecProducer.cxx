@@ -48,7 +48,7 @@ void EcalRecProducer::produce(framework::Event& event) {
           EcalReconConditions::CONDITIONS_NAME));
 
   std::vector<ldmx::EcalHit> ecalRecHits;
-  auto ecalDigis =
+  const auto& ecalDigis =
       event.getObject<ldmx::HgcrocDigiCollection>(digiCollName_, digiPassName_);
   // loop through digis
   for (auto digi : ecalDigis) {
@@ -159,7 +159,7 @@ void EcalRecProducer::produce(framework::Event& event) {
   if (event.exists(simHitCollName_, simHitPassName_)) {
     // ecal sim hits exist ==> label which hits are real and which are pure
     // noise
-    auto ecalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
+    const auto& ecalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
         simHitCollName_, simHitPassName_)};
     std::set<int> real_hits;
     for (auto const& sim_hit : ecalSimHits) real_hits.insert(sim_hit.getID());
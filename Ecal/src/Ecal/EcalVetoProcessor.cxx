@@ -130,8 +130,11 @@ void EcalVetoProcessor::buildBDTFeatureVector(
 void EcalVetoProcessor::configure(framework::config::Parameters &parameters) {
   doBdt_ = parameters.getParameter<bool>("do_bdt");
   if (doBdt_) {
+    ::Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(
+        parameters.getParameter<int>("intra_op_threads", 1));
     rt_ = std::make_unique<ldmx::Ort::ONNXRuntime>(
-        parameters.getParameter<std::string>("bdt_file"));
+        parameters.getParameter<std::string>("bdt_file"), &session_options);
   }
 
   cellFileNamexy_ = parameters.getParameter<std::string>("cellxy_file");
@@ -155,6 +158,7 @@ void EcalVetoProcessor::configure(framework::config::Parameters &parameters) {
   ecalLayerEdepRaw_.resize(nEcalLayers_, 0);
   ecalLayerEdepReadout_.resize(nEcalLayers_, 0);
   ecalLayerTime_.resize(nEcalLayers_, 0);
+  trackingHitsByLayer_.resize(nEcalLayers_);
 
   // Set the collection name as defined in the configuration
   collectionName_ = parameters.getParameter<std::string>("collection_name");
@@ -163,7 +167,8 @@ void EcalVetoProcessor::configure(framework::config::Parameters &parameters) {
 }
 
 void EcalVetoProcessor::clearProcessor() {
-  cellMap_.clear();
+  for (int index : occupiedCells_) cellOccupancy_[index] = 0;
+  occupiedCells_.clear();
   cellMapTightIso_.clear();
   bdtFeatures_.clear();
 
@@ -195,6 +200,8 @@ void EcalVetoProcessor::produce(framework::Event &event) {
   geometry_ = &getCondition<ldmx::EcalGeometry>(
       ldmx::EcalGeometry::CONDITIONS_OBJECT_NAME);
 
+  if (geometry_ != nnGeometry_) buildNeighbourTables();
+
   ldmx::EcalVetoResult result;
 
   clearProcessor();
@@ -299,11 +306,10 @@ void EcalVetoProcessor::produce(framework::Event &event) {
   ldmx::EcalID globalCentroid =
       GetShowerCentroidIDAndRMS(ecalRecHits, showerRMS_);
   /* ~~ Fill the hit map ~~ O(n)  */
-  fillHitMap(ecalRecHits, cellMap_);
+  fillHitMap(ecalRecHits);
   bool doTight = true;
   /* ~~ Fill the isolated hit maps ~~ O(n)  */
-  fillIsolatedHitMap(ecalRecHits, globalCentroid, cellMap_, cellMapTightIso_,
-                     doTight);
+  fillIsolatedHitMap(ecalRecHits, globalCentroid, cellMapTightIso_, doTight);
 
   // Loop over the hits from the event to calculate the rest of the important
   // quantities
@@ -322,6 +328,13 @@ void EcalVetoProcessor::produce(framework::Event &event) {
   std::vector<float> outsideContainmentYmean(nregions, 0.0);
   std::vector<float> outsideContainmentXstd(nregions, 0.0);
   std::vector<float> outsideContainmentYstd(nregions, 0.0);
+  // energy-weighted second moments, so the spreads are found in the same
+  // pass over the hits as the means
+  std::vector<double> outsideContainmentX2(nregions, 0.0);
+  std::vector<double> outsideContainmentY2(nregions, 0.0);
+  double x2Sum = 0;
+  double y2Sum = 0;
+  double layer2Sum = 0;
 
   // MIP tracking:  vector of hits to be used in the MIP tracking algorithm. All
   // hits inside the electron ROC (or all hits in the ECal if the event is
@@ -342,6 +355,9 @@ void EcalVetoProcessor::produce(framework::Event &event) {
       auto [x, y, z] = geometry_->getPosition(id);
       xMean += x * hit.getEnergy();
       yMean += y * hit.getEnergy();
+      x2Sum += x * x * hit.getEnergy();
+      y2Sum += y * y * hit.getEnergy();
+      layer2Sum += id.layer() * id.layer() * hit.getEnergy();
       avgLayerHit_ += id.layer();
       wavgLayerHit += id.layer() * hit.getEnergy();
       if (deepestLayerHit_ < id.layer()) {
@@ -378,6 +394,10 @@ void EcalVetoProcessor::produce(framework::Event &event) {
           outsideContainmentNHits[ireg] += 1;
           outsideContainmentXmean[ireg] += xy_pair.first * hit.getEnergy();
           outsideContainmentYmean[ireg] += xy_pair.second * hit.getEnergy();
+          outsideContainmentX2[ireg] +=
+              xy_pair.first * xy_pair.first * hit.getEnergy();
+          outsideContainmentY2[ireg] +=
+              xy_pair.second * xy_pair.second * hit.getEnergy();
         }
       }
 
@@ -416,52 +436,12 @@ void EcalVetoProcessor::produce(framework::Event &event) {
     yMean = 0;
   }
 
-  for (unsigned int ireg = 0; ireg < nregions; ireg++) {
-    if (outsideContainmentEnergy[ireg] > 0) {
-      outsideContainmentXmean[ireg] /= outsideContainmentEnergy[ireg];
-      outsideContainmentYmean[ireg] /= outsideContainmentEnergy[ireg];
-    }
-  }
-
-  // Loop over hits a second time to find the standard deviations.
-  for (const ldmx::EcalHit &hit : ecalRecHits) {
-    ldmx::EcalID id(hit.getID());
-    auto [x, y, z] = geometry_->getPosition(id);
-    if (hit.getEnergy() > 0) {
-      xStd_ += pow((x - xMean), 2) * hit.getEnergy();
-      yStd_ += pow((y - yMean), 2) * hit.getEnergy();
-      stdLayerHit_ += pow((id.layer() - wavgLayerHit), 2) * hit.getEnergy();
-    }
-    XYCoords xy_pair = std::make_pair(x, y);
-    float distance_ele_trajectory =
-        ele_trajectory.size()
-            ? sqrt(pow((xy_pair.first - ele_trajectory[id.layer()].first), 2) +
-                   pow((xy_pair.second - ele_trajectory[id.layer()].second), 2))
-            : -1.0;
-    float distance_photon_trajectory =
-        photon_trajectory.size()
-            ? sqrt(pow((xy_pair.first - photon_trajectory[id.layer()].first),
-                       2) +
-                   pow((xy_pair.second - photon_trajectory[id.layer()].second),
-                       2))
-            : -1.0;
-    for (unsigned int ireg = 0; ireg < nregions; ireg++) {
-      if (distance_ele_trajectory > (ireg + 1) * ele_radii[id.layer()] &&
-          distance_photon_trajectory > (ireg + 1) * photon_radii[id.layer()]) {
-        outsideContainmentXstd[ireg] +=
-            pow((xy_pair.first - outsideContainmentXmean[ireg]), 2) *
-            hit.getEnergy();
-        outsideContainmentYstd[ireg] +=
-            pow((xy_pair.second - outsideContainmentYmean[ireg]), 2) *
-            hit.getEnergy();
-      }
-    }
-  }
-
+  // standard deviations from the second moments: <x^2> - <x>^2
   if (nReadoutHits_ > 0) {
-    xStd_ = sqrt(xStd_ / summedDet_);
-    yStd_ = sqrt(yStd_ / summedDet_);
-    stdLayerHit_ = sqrt(stdLayerHit_ / summedDet_);
+    xStd_ = sqrt(std::max(0., x2Sum / summedDet_ - xMean * xMean));
+    yStd_ = sqrt(std::max(0., y2Sum / summedDet_ - yMean * yMean));
+    stdLayerHit_ = sqrt(std::max(
+        0., layer2Sum / summedDet_ - wavgLayerHit * wavgLayerHit));
   } else {
     xStd_ = 0;
     yStd_ = 0;
@@ -470,10 +450,16 @@ void EcalVetoProcessor::produce(framework::Event &event) {
 
   for (unsigned int ireg = 0; ireg < nregions; ireg++) {
     if (outsideContainmentEnergy[ireg] > 0) {
-      outsideContainmentXstd[ireg] =
-          sqrt(outsideContainmentXstd[ireg] / outsideContainmentEnergy[ireg]);
-      outsideContainmentYstd[ireg] =
-          sqrt(outsideContainmentYstd[ireg] / outsideContainmentEnergy[ireg]);
+      outsideContainmentXmean[ireg] /= outsideContainmentEnergy[ireg];
+      outsideContainmentYmean[ireg] /= outsideContainmentEnergy[ireg];
+      outsideContainmentXstd[ireg] = sqrt(std::max(
+          0., outsideContainmentX2[ireg] / outsideContainmentEnergy[ireg] -
+                  outsideContainmentXmean[ireg] *
+                      outsideContainmentXmean[ireg]));
+      outsideContainmentYstd[ireg] = sqrt(std::max(
+          0., outsideContainmentY2[ireg] / outsideContainmentEnergy[ireg] -
+                  outsideContainmentYmean[ireg] *
+                      outsideContainmentYmean[ireg]));
     }
   }
 
@@ -629,7 +615,13 @@ void EcalVetoProcessor::produce(framework::Event &event) {
   }
 
   float cellWidth = 8.7;
+  // Bucket the hits by layer so that extending a track is a neighbourhood
+  // query. Hits that end up in a track are flagged as used rather than erased
+  // from the list, so the indices in the buckets stay valid.
+  indexTrackingHits(trackingHitList);
+  std::vector<bool> usedHits(trackingHitList.size(), false);
   for (int iHit = 0; iHit < trackingHitList.size(); iHit++) {
+    if (usedHits[iHit]) continue;
     int track[34];  // list of hit numbers in track (34 = maximum theoretical
                     // length)
     int currenthit;
@@ -643,21 +635,14 @@ void EcalVetoProcessor::produce(framework::Event &event) {
     // repeatedly find hits in the front two layers with same x & y positions
     // but since v14 the odd layers are offset, so we allow half a cellWidth
     // deviation and then add to track until no more hits are found
-    int jHit = iHit;
-    while (jHit < trackingHitList.size()) {
-      if ((trackingHitList[jHit].layer ==
-               trackingHitList[currenthit].layer - 1 ||
-           trackingHitList[jHit].layer ==
-               trackingHitList[currenthit].layer - 2) &&
-          abs(trackingHitList[jHit].pos.X() -
-              trackingHitList[currenthit].pos.X()) <= 0.5 * cellWidth &&
-          abs(trackingHitList[jHit].pos.Y() -
-              trackingHitList[currenthit].pos.Y()) <= 0.5 * cellWidth) {
-        track[trackLen] = jHit;
-        trackLen++;
-        currenthit = jHit;
-      }
-      jHit++;
+    int jHit = nextStraightTrackHit(trackingHitList, usedHits, currenthit,
+                                    0.5 * cellWidth);
+    while (jHit >= 0) {
+      track[trackLen] = jHit;
+      trackLen++;
+      currenthit = jHit;
+      jHit = nextStraightTrackHit(trackingHitList, usedHits, currenthit,
+                                  0.5 * cellWidth);
     }
 
     // Confirm that the track is valid:
@@ -690,17 +675,17 @@ void EcalVetoProcessor::produce(framework::Event &event) {
     // from future consideration
     if (trackLen >= 2) {
       std::vector<HitData> temp_track_list;
-      int n_remove = 0;
       for (int kHit = 0; kHit < trackLen; kHit++) {
-        temp_track_list.push_back(trackingHitList[track[kHit] - n_remove]);
-        trackingHitList.erase(trackingHitList.begin() + track[kHit] - n_remove);
-        n_remove++;
+        temp_track_list.push_back(trackingHitList[track[kHit]]);
+        usedHits[track[kHit]] = true;
       }
       // print trackingHitList
       if (verbose_) {
-        ldmx_log(debug) << "====== Tracking hit list (after erase) length"
-                        << trackingHitList.size() << " ======";
+        ldmx_log(debug) << "====== Tracking hit list (after removal) length"
+                        << std::count(usedHits.begin(), usedHits.end(), false)
+                        << " ======";
         for (int i = 0; i < trackingHitList.size(); i++) {
+          if (usedHits[i]) continue;
           std::cout << "[" << trackingHitList[i].pos.X() << ", "
                     << trackingHitList[i].pos.Y() << ", "
                     << trackingHitList[i].layer << "] ";
@@ -710,9 +695,6 @@ void EcalVetoProcessor::produce(framework::Event &event) {
       }
 
       track_list.push_back(temp_track_list);
-      // The *current* hit will have been removed, so iHit is currently pointing
-      // to the next hit. Decrement iHit so no hits will get skipped by iHit++
-      iHit--;
     }
   }
 
@@ -792,47 +774,37 @@ void EcalVetoProcessor::produce(framework::Event &event) {
 
   // Linreg tracking:
 
-  ldmx_log(debug) << "Finding linreg tracks from " << trackingHitList.size()
+  ldmx_log(debug) << "Finding linreg tracks from "
+                  << std::count(usedHits.begin(), usedHits.end(), false)
                   << " hits";
 
+  std::vector<int> hitsInRegion;  // Hits being considered at one time
   for (int iHit = 0; iHit < trackingHitList.size(); iHit++) {
+    if (usedHits[iHit]) continue;
     int track[34];
     int trackLen;
-    int currenthit;
-    int hitsInRegion[50];  // Hits being considered at one time
-    int nHitsInRegion;     // Number of hits under consideration
     TMatrixD svdMatrix(3, 3);
     TMatrixD Vm(3, 3);
     TMatrixD hdt(3, 3);
     TVector3 slopeVec;
     TVector3 hmean;
     TVector3 hpoint;
-    float r_corr_best;
-    int hitNums_best[3];  // Hit numbers of current best track candidate
+    float r_corr_best{0.};
     int hitNums[3];
 
     trackLen = 0;
-    nHitsInRegion = 1;
-    currenthit = iHit;
-    hitsInRegion[0] = iHit;
     // Find all hits within 2 cells of the primary hit:
-    for (int jHit = 0; jHit < trackingHitList.size(); jHit++) {
-      float dstToHit =
-          (trackingHitList[iHit].pos - trackingHitList[jHit].pos).Mag();
-      if (dstToHit <= 2 * cellWidth) {
-        hitsInRegion[nHitsInRegion] = jHit;
-        nHitsInRegion++;
-      }
-    }
+    findHitsInRegion(trackingHitList, usedHits, iHit, 2 * cellWidth,
+                     hitsInRegion);
+    int nHitsInRegion = hitsInRegion.size();
 
     // Look at combinations of hits within the region (do not consider the same
     // combination twice):
     hitNums[0] = iHit;
-    for (int jHit = 1; jHit < nHitsInRegion - 1; jHit++) {
-      if (trackingHitList.size() < 3) break;
-      hitNums[1] = jHit;
+    for (int jHit = 0; jHit < nHitsInRegion - 1; jHit++) {
+      hitNums[1] = hitsInRegion[jHit];
       for (int kHit = jHit + 1; kHit < nHitsInRegion; kHit++) {
-        hitNums[2] = kHit;
+        hitNums[2] = hitsInRegion[kHit];
         for (int hInd = 0; hInd < 3; hInd++) {
           // hmean = geometric mean, subtract off from hits to improve SVD
           // performance
@@ -899,9 +871,8 @@ void EcalVetoProcessor::produce(framework::Event &event) {
     if (trackLen >= 2) {
       nLinregTracks_++;
       for (int kHit = 0; kHit < trackLen; kHit++) {
-        trackingHitList.erase(trackingHitList.begin() + track[kHit]);
+        usedHits[track[kHit]] = true;
       }
-      iHit--;
     }
   }
 
@@ -919,8 +890,10 @@ void EcalVetoProcessor::produce(framework::Event &event) {
 
   if (doBdt_) {
     buildBDTFeatureVector(result);
-    ldmx::Ort::FloatArrays inputs({bdtFeatures_});
-    float pred = rt_->run({"features"}, inputs, {"probabilities"})[0].at(1);
+    // input and output arrays are kept between events to re-use their memory
+    bdtInputs_[0] = bdtFeatures_;
+    rt_->run(bdtInputNames_, bdtInputs_, bdtOutputNames_, bdtOutputs_);
+    float pred = bdtOutputs_[0].at(1);
     // Removing electron-photon separation step, near photon step due to lower
     // v12 performance; may reconsider
     bool passesTrackingVeto = (nStraightTracks_ < 3) && (nLinregTracks_ == 0);
@@ -992,56 +965,86 @@ ldmx::EcalID EcalVetoProcessor::GetShowerCentroidIDAndRMS(
                       returnCellId.cell());  // flatten
 }
 
+void EcalVetoProcessor::buildNeighbourTables() {
+  nCellsPerModule_ = geometry_->getNumCellsPerModule();
+  nCellsPerLayer_ = geometry_->getNumModulesPerLayer() * nCellsPerModule_;
+  nnOffsets_.clear();
+  nnCells_.clear();
+  for (int module = 0; module < geometry_->getNumModulesPerLayer(); module++) {
+    for (int cell = 0; cell < nCellsPerModule_; cell++) {
+      nnOffsets_.push_back(nnCells_.size());
+      for (const ldmx::EcalID &nn :
+           geometry_->getNN(ldmx::EcalID(0, module, cell)))
+        nnCells_.push_back(flatCellIndex(nn));
+    }
+  }
+  nnOffsets_.push_back(nnCells_.size());
+  cellOccupancy_.assign(geometry_->getNumLayers() * nCellsPerLayer_, 0);
+  occupiedCells_.clear();
+  nnGeometry_ = geometry_;
+}
+
+bool EcalVetoProcessor::isNeighbour(int centroidFlatCell,
+                                    int probeFlatCell) const {
+  for (int i = nnOffsets_[centroidFlatCell];
+       i < nnOffsets_[centroidFlatCell + 1]; i++) {
+    if (nnCells_[i] == probeFlatCell) return true;
+  }
+  return false;
+}
+
 /**
- * Function to load up empty vector of hit maps
+ * Function to mark the cells with a hit in the occupancy array
  */
 void EcalVetoProcessor::fillHitMap(
-    const std::vector<ldmx::EcalHit> &ecalRecHits,
-    std::map<ldmx::EcalID, float> &cellMap_) {
+    const std::vector<ldmx::EcalHit> &ecalRecHits) {
   for (const ldmx::EcalHit &hit : ecalRecHits) {
     ldmx::EcalID id(hit.getID());
-    cellMap_.emplace(id, hit.getEnergy());
+    int index = id.layer() * nCellsPerLayer_ + flatCellIndex(id);
+    if (index >= cellOccupancy_.size() or cellOccupancy_[index]) continue;
+    cellOccupancy_[index] = 1;
+    occupiedCells_.push_back(index);
   }
 }
 
 void EcalVetoProcessor::fillIsolatedHitMap(
     const std::vector<ldmx::EcalHit> &ecalRecHits, ldmx::EcalID globalCentroid,
-    std::map<ldmx::EcalID, float> &cellMap_,
-    std::map<ldmx::EcalID, float> &cellMapIso_, bool doTight) {
+    std::vector<CellEnergyPair> &cellMapIso_, bool doTight) {
+  int centroidFlatCell = flatCellIndex(globalCentroid);
   for (const ldmx::EcalHit &hit : ecalRecHits) {
-    auto isolatedHit = std::make_pair(true, ldmx::EcalID());
     ldmx::EcalID id(hit.getID());
+    int flatCell = flatCellIndex(id);
     if (doTight) {
       // Disregard hits that are on the centroid.
       if (id == globalCentroid) continue;
 
       // Skip hits that are on centroid inner ring
-      if (geometry_->isNN(globalCentroid, id)) {
+      if (id.layer() == globalCentroid.layer() and
+          isNeighbour(centroidFlatCell, flatCell)) {
         continue;
       }
     }
 
+    // Skip hits in layers outside of the occupancy array, like fillHitMap
+    std::size_t layerBegin = id.layer() * nCellsPerLayer_;
+    if (layerBegin + nCellsPerLayer_ > cellOccupancy_.size()) continue;
+
     // Skip hits that have a readout neighbor
-    // Get neighboring cell id's and try to look them up in the full cell map
-    // (constant speed algo.)
-    //  these ideas are only cell/module (must ignore layer)
-    std::vector<ldmx::EcalID> cellNbrIds = geometry_->getNN(id);
-
-    for (int k = 0; k < cellNbrIds.size(); k++) {
-      // update neighbor ID to the current layer
-      cellNbrIds[k] = ldmx::EcalID(id.layer(), cellNbrIds[k].module(),
-                                   cellNbrIds[k].cell());
-      // look in cell hit map to see if it is there
-      if (cellMap_.find(cellNbrIds[k]) != cellMap_.end()) {
-        isolatedHit = std::make_pair(false, cellNbrIds[k]);
+    // Look up the neighboring cells of the same layer in the occupancy
+    // array (constant speed algo.)
+    const char *layerOccupancy = cellOccupancy_.data() + layerBegin;
+    bool isolated{true};
+    for (int i = nnOffsets_[flatCell]; i < nnOffsets_[flatCell + 1]; i++) {
+      if (layerOccupancy[nnCells_[i]]) {
+        isolated = false;
         break;
       }
     }
-    if (!isolatedHit.first) {
+    if (!isolated) {
       continue;
     }
     // Insert isolated hit
-    cellMapIso_.emplace(id, hit.getEnergy());
+    cellMapIso_.emplace_back(id, hit.getEnergy());
   }
 }
 
@@ -1064,6 +1067,69 @@ std::vector<std::pair<float, float>> EcalVetoProcessor::getTrajectory(
 
 // MIP tracking functions:
 
+void EcalVetoProcessor::indexTrackingHits(const std::vector<HitData> &hits) {
+  for (auto &layer_hits : trackingHitsByLayer_) layer_hits.clear();
+  for (int iHit = 0; iHit < hits.size(); iHit++) {
+    int layer = hits[iHit].layer;
+    if (layer >= trackingHitsByLayer_.size())
+      trackingHitsByLayer_.resize(layer + 1);
+    trackingHitsByLayer_[layer].emplace_back(hits[iHit].pos.X(), iHit);
+  }
+  for (auto &layer_hits : trackingHitsByLayer_)
+    std::sort(layer_hits.begin(), layer_hits.end());
+}
+
+int EcalVetoProcessor::nextStraightTrackHit(const std::vector<HitData> &hits,
+                                            const std::vector<bool> &used,
+                                            int current, float window) const {
+  const HitData &curr = hits[current];
+  // hits are sorted by decreasing layer, so scanning the list from the
+  // current hit meets the first candidate one layer in front before
+  // any candidate two layers in front
+  for (int front = 1; front <= 2; front++) {
+    int layer = curr.layer - front;
+    if (layer < 0 or layer >= trackingHitsByLayer_.size()) continue;
+    const auto &layer_hits{trackingHitsByLayer_[layer]};
+    // loose range in x, the window cut itself is applied below
+    auto it = std::lower_bound(
+        layer_hits.begin(), layer_hits.end(),
+        std::make_pair(curr.pos.X() - 2 * window, -1));
+    int next{-1};
+    for (; it != layer_hits.end() and it->first <= curr.pos.X() + 2 * window;
+         ++it) {
+      int jHit = it->second;
+      if (used[jHit] or (next >= 0 and jHit > next)) continue;
+      if (std::abs(hits[jHit].pos.X() - curr.pos.X()) <= window &&
+          std::abs(hits[jHit].pos.Y() - curr.pos.Y()) <= window)
+        next = jHit;
+    }
+    if (next >= 0) return next;
+  }
+  return -1;
+}
+
+void EcalVetoProcessor::findHitsInRegion(const std::vector<HitData> &hits,
+                                         const std::vector<bool> &used,
+                                         int center, float radius,
+                                         std::vector<int> &region) const {
+  region.clear();
+  const TVector3 &pos{hits[center].pos};
+  for (const auto &layer_hits : trackingHitsByLayer_) {
+    if (layer_hits.empty() or
+        std::abs(hits[layer_hits.front().second].pos.Z() - pos.Z()) > radius)
+      continue;
+    auto it = std::lower_bound(layer_hits.begin(), layer_hits.end(),
+                               std::make_pair(pos.X() - radius, -1));
+    for (; it != layer_hits.end() and it->first <= pos.X() + radius; ++it) {
+      int jHit = it->second;
+      if (jHit == center or used[jHit]) continue;
+      if ((pos - hits[jHit].pos).Mag() <= radius) region.push_back(jHit);
+    }
+  }
+  // keep the hit list order so combinations are tried in a fixed sequence
+  std::sort(region.begin(), region.end());
+}
+
 float EcalVetoProcessor::distTwoLines(TVector3 v1, TVector3 v2, TVector3 w1,
                                       TVector3 w2) {
   TVector3 e1 = v1 - v2;
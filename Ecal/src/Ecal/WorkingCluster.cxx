@@ -46,10 +46,7 @@ void WorkingCluster::add(const WorkingCluster& wc) {
 
   centroid_.SetPxPyPzE(newCentroidX, newCentroidY, newCentroidZ, newE);
 
-  std::vector<const ldmx::EcalHit*> clusterHits = wc.getHits();
-
-  for (size_t i = 0; i < clusterHits.size(); i++) {
-    hits_.push_back(clusterHits[i]);
-  }
+  const std::vector<const ldmx::EcalHit*>& clusterHits = wc.getHits();
+  hits_.insert(hits_.end(), clusterHits.begin(), clusterHits.end());
 }
 }  // namespace ecal
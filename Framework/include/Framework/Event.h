@@ -268,6 +268,14 @@ class Event {
    * @throws Exception if mismatching type
    * @see Bus::get
    *
+   * @note The object stays on the bus for the rest of the event, so
+   * bind the result to a const reference. Writing
+   * ```cpp
+   * auto hits{event.getCollection<ldmx::SimCalorimeterHit>("EcalSimHits")};
+   * ```
+   * deduces a value type and deep-copies the whole collection;
+   * use `const auto& hits{...}` instead.
+   *
    * @tparam T type of object we should be getting
    * @param collectionName name of collection you want
    * @param passName name of pass you want
@@ -0,0 +1,114 @@
+/**
+ * @file FileCache.h
+ * @brief Helpers for binary cache files derived from slow to read inputs
+ */
+
+#ifndef FRAMEWORK_FILECACHE_H_
+#define FRAMEWORK_FILECACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace framework {
+
+/**
+ * @class FileCache
+ * @brief Shared pieces of the caches that jobs keep of expensive inputs.
+ *
+ * Several modules convert an input that is slow to read (a text field map,
+ * a GDML detector, a raw data file) into a binary file that later jobs load
+ * instead. This class holds what all of them need: where the caches live,
+ * how to recognize that a cache still matches its input and how to write a
+ * cache without other jobs ever reading a partial file.
+ *
+ * Caches live in a directory the user can write to, since the inputs are
+ * usually installed read-only. It is LDMX_CACHE_DIR if that environment
+ * variable is set, otherwise $XDG_CACHE_HOME/ldmx or ~/.cache/ldmx.
+ */
+class FileCache {
+ public:
+  /// Starting value of hash, the 64-bit FNV-1a offset basis
+  static constexpr std::uint64_t HASH_SEED = 14695981039346656037ull;
+
+  /// Size and modification time of a file, identifying its version
+  struct Stamp {
+    /// size in bytes
+    std::uint64_t size{0};
+    /// modification time in ns
+    std::int64_t mtime{0};
+  };
+
+  /**
+   * 64-bit FNV-1a hash of a block of bytes
+   *
+   * @param[in] data the bytes to hash
+   * @param[in] size number of bytes
+   * @param[in] seed hash of the preceding blocks, to hash several blocks
+   * @return the hash
+   */
+  static std::uint64_t hash(const void* data, std::size_t size,
+                            std::uint64_t seed = HASH_SEED);
+
+  /// 64-bit FNV-1a hash of a string
+  static std::uint64_t hash(const std::string& str,
+                            std::uint64_t seed = HASH_SEED) {
+    return hash(str.data(), str.size(), seed);
+  }
+
+  /// The hash as 16 hex digits, to use in file names
+  static std::string hex(std::uint64_t hash);
+
+  /**
+   * Get the size and modification time of a file
+   *
+   * @param[in] file path to the file
+   * @param[out] stamp size and modification time of the file
+   * @return false if the file does not exist
+   */
+  static bool stamp(const std::string& file, Stamp& stamp);
+
+  /**
+   * Directory to keep caches in, created if it does not exist yet
+   *
+   * @param[in] dir directory chosen by the user, the default cache
+   * directory if empty
+   * @return the directory, empty if it cannot be created
+   */
+  static std::string directory(const std::string& dir = "");
+
+  /**
+   * Path of the cache for an input file in the cache directory
+   *
+   * The name holds a hash of the full path of the input, so inputs with
+   * the same name in different directories get separate caches.
+   *
+   * @param[in] input path to the input the cache is derived from
+   * @param[in] suffix extension of the cache file
+   * @param[in] dir directory chosen by the user, the default if empty
+   * @return path to the cache file, empty if there is no cache directory
+   */
+  static std::string path(const std::string& input, const std::string& suffix,
+                          const std::string& dir = "");
+
+  /**
+   * Write a cache file atomically
+   *
+   * The content is written to a file private to this process which is only
+   * moved into place once it is complete, so concurrent jobs never see a
+   * partially written cache. Failures are logged as warnings, a cache is
+   * only an optimization and the caller carries on without it.
+   *
+   * @param[in] file path to the cache file
+   * @param[in] fill writes the content to the stream, returns false on error
+   * @return true if the cache file was written
+   */
+  static bool write(const std::string& file,
+                    const std::function<bool(std::ostream&)>& fill);
+};
+
+}  // namespace framework
+
+#endif  // FRAMEWORK_FILECACHE_H_
@@ -0,0 +1,61 @@
+#pragma once
+
+//--- C++ ---//
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace framework {
+
+/**
+ * Call work(index, worker) for every index in [0, n) using up to n_workers
+ * threads.
+ *
+ * The calling thread is worker 0 and the other workers are started for the
+ * duration of the call. Indices are handed out through a shared counter, so
+ * which worker gets which index depends on scheduling: work may only write
+ * into per-index or per-worker state. With a single worker the indices are
+ * processed in order on the calling thread.
+ *
+ * A worker stops at the first exception it catches while the others carry
+ * on. Once all workers are done, the exception of the lowest-numbered
+ * failing worker is rethrown.
+ *
+ * @param n number of indices to process
+ * @param n_workers maximum number of concurrent workers
+ * @param work callable taking (std::size_t index, int worker)
+ */
+template <typename Work>
+void parallelFor(std::size_t n, int n_workers, Work&& work) {
+  const int workers =
+      static_cast<int>(std::min<std::size_t>(std::max(n_workers, 1), n));
+  if (workers <= 1) {
+    for (std::size_t index = 0; index < n; ++index) work(index, 0);
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::vector<std::exception_ptr> errors(workers);
+  auto run = [&](int worker) {
+    try {
+      for (std::size_t index = next++; index < n; index = next++)
+        work(index, worker);
+    } catch (...) {
+      errors[worker] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < workers; ++worker)
+    threads.emplace_back(run, worker);
+  run(0);
+  for (auto& thread : threads) thread.join();
+
+  for (auto& error : errors)
+    if (error) std::rethrow_exception(error);
+}
+
+}  // namespace framework
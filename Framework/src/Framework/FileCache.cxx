@@ -0,0 +1,137 @@
+#include "Framework/FileCache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+// POSIX
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Framework/Logger.h"
+
+namespace framework {
+
+namespace {
+
+/// The logger shared by the static cache helpers
+logging::logger& cacheLogger() {
+  static logging::logger log{logging::makeLogger("FileCache")};
+  return log;
+}
+
+/// Create the directory and its parents, like mkdir -p
+bool makeDirectories(const std::string& dir) {
+  std::size_t slash{0};
+  do {
+    slash = dir.find('/', slash + 1);
+    std::string parent = dir.substr(0, slash);
+    if (::mkdir(parent.c_str(), 0755) != 0 and errno != EEXIST) return false;
+  } while (slash != std::string::npos);
+  struct stat info;
+  return stat(dir.c_str(), &info) == 0 and S_ISDIR(info.st_mode);
+}
+
+}  // namespace
+
+std::uint64_t FileCache::hash(const void* data, std::size_t size,
+                              std::uint64_t seed) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    seed = (seed ^ bytes[i]) * 1099511628211ull;
+  }
+  return seed;
+}
+
+std::string FileCache::hex(std::uint64_t hash) {
+  char digits[17];
+  std::snprintf(digits, sizeof(digits), "%016llx",
+                static_cast<unsigned long long>(hash));
+  return digits;
+}
+
+bool FileCache::stamp(const std::string& file, Stamp& stamp) {
+  struct stat info;
+  if (::stat(file.c_str(), &info) != 0) return false;
+  stamp.size = info.st_size;
+  stamp.mtime = info.st_mtim.tv_sec * 1000000000ll + info.st_mtim.tv_nsec;
+  return true;
+}
+
+std::string FileCache::directory(const std::string& dir) {
+  auto& theLog_{cacheLogger()};
+  std::string cache_dir = dir;
+  if (cache_dir.empty()) {
+    if (const char* env = std::getenv("LDMX_CACHE_DIR"); env and *env) {
+      cache_dir = env;
+    } else if (const char* xdg = std::getenv("XDG_CACHE_HOME");
+               xdg and *xdg) {
+      cache_dir = std::string(xdg) + "/ldmx";
+    } else if (const char* home = std::getenv("HOME"); home and *home) {
+      cache_dir = std::string(home) + "/.cache/ldmx";
+    } else {
+      ldmx_log(warn) << "No cache directory: neither LDMX_CACHE_DIR, "
+                        "XDG_CACHE_HOME nor HOME is set";
+      return "";
+    }
+  }
+  while (cache_dir.size() > 1 and cache_dir.back() == '/')
+    cache_dir.pop_back();
+  if (!makeDirectories(cache_dir)) {
+    ldmx_log(warn) << "Unable to create the cache directory " << cache_dir
+                   << ": " << std::strerror(errno);
+    return "";
+  }
+  return cache_dir;
+}
+
+std::string FileCache::path(const std::string& input,
+                            const std::string& suffix,
+                            const std::string& dir) {
+  std::string cache_dir = directory(dir);
+  if (cache_dir.empty()) return "";
+
+  std::string full_path = input;
+  if (char* resolved = ::realpath(input.c_str(), nullptr)) {
+    full_path = resolved;
+    std::free(resolved);
+  }
+  auto slash = full_path.find_last_of('/');
+  std::string name =
+      slash == std::string::npos ? full_path : full_path.substr(slash + 1);
+  return cache_dir + "/" + name + "." + hex(hash(full_path)) + suffix;
+}
+
+bool FileCache::write(const std::string& file,
+                      const std::function<bool(std::ostream&)>& fill) {
+  auto& theLog_{cacheLogger()};
+  // Write to a file private to this process and move it into place at the
+  // end, so concurrent jobs never see a partially written cache
+  std::string tmp_file = file + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream out(tmp_file, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      ldmx_log(warn) << "Unable to open the cache file " << tmp_file
+                     << " for writing: " << std::strerror(errno);
+      return false;
+    }
+    bool filled = fill(out);
+    out.close();
+    if (!filled or !out) {
+      ldmx_log(warn) << "Failed to write the cache file " << tmp_file;
+      std::remove(tmp_file.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_file.c_str(), file.c_str()) != 0) {
+    ldmx_log(warn) << "Unable to move the cache file into place at " << file
+                   << ": " << std::strerror(errno);
+    std::remove(tmp_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace framework
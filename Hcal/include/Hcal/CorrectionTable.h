@@ -0,0 +1,80 @@
+/**
+ * @file CorrectionTable.h
+ * @brief Lookup table for the HCal reconstruction corrections
+ */
+
+#ifndef HCAL_CORRECTIONTABLE_H_
+#define HCAL_CORRECTIONTABLE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TGraph.h"
+
+namespace hcal {
+
+/**
+ * @class CorrectionTable
+ * @brief Piecewise-linear curve sampled on a uniform grid
+ *
+ * The correction curves used in reconstruction are resampled onto a grid
+ * that is uniform either in x or in log(x), so finding the interval that
+ * contains an input value takes one multiplication instead of a search.
+ * Outside of the sampled range, the curve is extrapolated linearly from the
+ * first or last two points of the input graph, as TGraph::Eval does.
+ */
+class CorrectionTable {
+ public:
+  /// Empty table, only usable after assigning a filled table to it
+  CorrectionTable() = default;
+
+  /**
+   * Resample the input graph.
+   *
+   * @param[in] curve graph to sample, its points must be sorted in x
+   * @param[in] n_points number of points on the grid, at least two
+   * @param[in] log_axis make the grid uniform in log(x) instead of x,
+   * the graph then must only have positive x
+   */
+  CorrectionTable(const TGraph& curve, std::size_t n_points,
+                  bool log_axis = false);
+
+  /**
+   * Evaluate the curve
+   *
+   * @param[in] x point to evaluate at
+   * @return linearly interpolated value of the curve at x
+   */
+  double eval(double x) const {
+    if (x <= x_min_) return y_.front() + (x - x_min_) * slope_min_;
+    if (x >= x_max_) return y_.back() + (x - x_max_) * slope_max_;
+    double u = ((log_axis_ ? std::log(x) : x) - u_min_) * inv_du_;
+    std::size_t i = std::min(static_cast<std::size_t>(u), y_.size() - 2);
+    double frac = u - i;
+    return y_[i] + frac * (y_[i + 1] - y_[i]);
+  }
+
+ private:
+  /// is the grid uniform in log(x)?
+  bool log_axis_{false};
+
+  /// start of grid in x or log(x)
+  double u_min_{0.};
+
+  /// inverse of grid spacing in x or log(x)
+  double inv_du_{0.};
+
+  /// range of the grid in x
+  double x_min_{0.}, x_max_{0.};
+
+  /// slopes to extrapolate below and above the grid
+  double slope_min_{0.}, slope_max_{0.};
+
+  /// values of the curve on the grid
+  std::vector<double> y_;
+};
+
+}  // namespace hcal
+
+#endif  // HCAL_CORRECTIONTABLE_H_
@@ -1,17 +1,23 @@
 #ifndef HCALALIGNPOLARFIRES_H
 #define HCALALIGNPOLARFIRES_H
-#include <queue>
+#include <deque>
 
 #include "Framework/EventProcessor.h"
 #include "Recon/Event/HgcrocDigiCollection.h"
 
 namespace hcal {
 /**
- * Align the two polarfires with drop/keep hints signalling successful merge
+ * Align any number of polarfires with drop/keep hints signalling successful
+ * merge
  *
  * - Only checking for /dropped/ events
  * - assuming that ticks and spills are already in correct ORDER
- * - assuming spill numbering is NOT the same between the two DPMs
+ * - assuming spill numbering is NOT the same between the DPMs
+ *
+ * Each event, the next package of decoding from each polarfire is put into
+ * its queue. The earliest event at the front of the queues is then merged
+ * with the fronts of all other queues that are within the tick window of it.
+ * The event is only marked as aligned if all polarfires contributed to it.
  */
 class HcalAlignPolarfires : public framework::Producer {
   /// input decoded objects (vector index == polarfire index)
@@ -21,7 +27,9 @@ class HcalAlignPolarfires : public framework::Producer {
   /// output object name
   std::string output_name_;
   /// number of 5MHz ticks difference to consider polarfires aligned
-  static int max_tick_diff_;
+  int max_tick_diff_;
+  /// maximum number of events to buffer for each polarfire, no limit if zero
+  int max_queue_size_;
 
  public:
   struct PolarfireQueueEntry {
@@ -34,18 +42,24 @@ class HcalAlignPolarfires : public framework::Producer {
                         const std::string& input_name,
                         const std::string& input_pass,
                         std::pair<int, int>& spill_counter);
-    bool same_event(const PolarfireQueueEntry& rhs) {
-      return (spill == rhs.spill and abs(ticks - rhs.ticks) < max_tick_diff_);
+    bool same_event(const PolarfireQueueEntry& rhs, int max_tick_diff) const {
+      return (spill == rhs.spill and abs(ticks - rhs.ticks) < max_tick_diff);
     }
-    bool earlier_event(const PolarfireQueueEntry& rhs) {
+    bool earlier_event(const PolarfireQueueEntry& rhs) const {
       if (spill == rhs.spill) return ticks < rhs.ticks;
       return spill < rhs.spill;
     }
   };
-  /// queue of unmatched digis
-  std::queue<PolarfireQueueEntry> pf0_queue, pf1_queue;
-  /// spill counter
-  std::pair<int, int> pf0_spill_counter{0, -1}, pf1_spill_counter{0, -1};
+  /// queue of unmatched digis for each polarfire
+  std::vector<std::deque<PolarfireQueueEntry>> queues_;
+  /// spill counter for each polarfire
+  std::vector<std::pair<int, int>> spill_counters_;
+  /// number of events of each polarfire merged with all others
+  std::vector<long int> n_aligned_;
+  /// number of events of each polarfire missing another polarfire
+  std::vector<long int> n_orphans_;
+  /// number of events of each polarfire dropped because its queue was full
+  std::vector<long int> n_discarded_;
 
  public:
   HcalAlignPolarfires(const std::string& n, framework::Process& p)
@@ -53,6 +67,8 @@ class HcalAlignPolarfires : public framework::Producer {
   virtual ~HcalAlignPolarfires() = default;
   void configure(framework::config::Parameters& ps) override;
   void produce(framework::Event& event) override;
+  /// print how many events of each polarfire could be aligned
+  void onProcessEnd() override;
 };
 
 }  // namespace hcal
@@ -4,8 +4,10 @@
 //----------------//
 //   C++ StdLib   //
 //----------------//
+#include <array>
 #include <memory>  //for smart pointers
 #include <set>     //for tracking used detector IDs
+#include <vector>
 
 //----------//
 //   LDMX   //
@@ -50,6 +52,53 @@ class HcalDigiProducer : public framework::Producer {
   void produce(framework::Event& event) override;
 
  private:
+  /// Digis produced by a single bar, at most one for each end
+  struct BarDigis {
+    /// number of digis filled
+    int n{0};
+    /// raw HcalDigiID of each digi
+    std::array<unsigned int, 2> ids;
+    /// samples of each digi
+    std::array<std::vector<ldmx::HgcrocDigiCollection::Sample>, 2> samples;
+  };
+
+  /**
+   * Digitize the sim hits of a single bar
+   *
+   * The arriving pulses at both ends of the bar are built from the sim
+   * hits grouped into the bar and then digitized with the input emulator.
+   * Only the emulator's random stream is modified so bars can be digitized
+   * concurrently as long as each thread has its own emulator.
+   *
+   * @param[in] iBar index of bar in the grouping of this event
+   * @param[in] hcalGeometry geometry to find the distance to the bar ends
+   * @param[in] simHits sim hits of this event
+   * @param[in] hgcroc emulator to digitize the pulses with
+   * @param[in,out] pulses_posend buffer for pulses at positive end
+   * @param[in,out] pulses_negend buffer for pulses at negative end
+   * @param[out] digis digis produced by this bar
+   */
+  void digitizeBar(std::size_t iBar, const ldmx::HcalGeometry& hcalGeometry,
+                   const std::vector<ldmx::SimCalorimeterHit>& simHits,
+                   const ldmx::HgcrocEmulator& hgcroc,
+                   std::vector<std::pair<double, double>>& pulses_posend,
+                   std::vector<std::pair<double, double>>& pulses_negend,
+                   BarDigis& digis) const;
+
+  /**
+   * Digitize all of the bars of this event concurrently
+   *
+   * Each thread has its own emulator which is re-seeded for every bar with
+   * a seed derived from the bar ID and a number drawn once per event. This
+   * makes the digis independent of the order the bars are handled in.
+   *
+   * @param[in] hcalGeometry geometry to find the distance to the bar ends
+   * @param[in] simHits sim hits of this event
+   */
+  void digitizeBarsConcurrently(
+      const ldmx::HcalGeometry& hcalGeometry,
+      const std::vector<ldmx::SimCalorimeterHit>& simHits);
+
   ///////////////////////////////////////////////////////////////////////////////////////
   // Python Configuration Parameters
 
@@ -77,6 +126,9 @@ class HcalDigiProducer : public framework::Producer {
   /// Strip attenuation length [m]
   double attlength_;
 
+  /// Number of threads to digitize bars with
+  int nThreads_{1};
+
   ///////////////////////////////////////////////////////////////////////////////////////
   // Other member variables
 
@@ -95,6 +147,29 @@ class HcalDigiProducer : public framework::Producer {
 
   /// Generates Gaussian noise on top of real hits
   std::unique_ptr<TRandom3> noiseInjector_;
+
+  /// Emulators for each thread when digitizing bars concurrently
+  std::vector<std::unique_ptr<ldmx::HgcrocEmulator>> threadHgcrocs_;
+
+  /// Draws the per-event number the per-bar seeds are derived from
+  std::unique_ptr<TRandom3> barSeeder_;
+
+  /// (ID, index) of the sim hits in this event sorted by ID
+  std::vector<std::pair<unsigned int, unsigned int>> hitOrder_;
+
+  /// IDs of the bars with sim hits in this event in increasing order
+  std::vector<unsigned int> barIDs_;
+
+  /**
+   * Offsets of the bars into hitOrder_
+   *
+   * The sim hits of bar i are hitOrder_[barOffsets_[i]] up to (excluding)
+   * hitOrder_[barOffsets_[i+1]].
+   */
+  std::vector<std::size_t> barOffsets_;
+
+  /// Digis produced by each bar in this event
+  std::vector<BarDigis> barDigis_;
 };
 }  // namespace hcal
 
@@ -31,6 +31,22 @@ class HcalDoubleEndRecProducer : public framework::Producer {
   /// length of clock cycle [ns]
   double clock_cycle_;
 
+  /// geometry the bar indices were built for
+  const ldmx::HcalGeometry* barGeometry_{nullptr};
+  /// index of the first bar in each back Hcal layer, indexed by layer
+  std::vector<int> layerOffsets_;
+  /// indices of the (positive, negative) end hits of each back Hcal bar
+  std::vector<std::pair<int, int>> barEnds_;
+  /// back Hcal bars with hits in this event
+  std::vector<int> hitBars_;
+
+  /**
+   * Build the table of first bar index per layer of the back Hcal
+   *
+   * @param[in] hcalGeometry geometry to count the strips of
+   */
+  void buildBarIndex(const ldmx::HcalGeometry& hcalGeometry);
+
  public:
   HcalDoubleEndRecProducer(const std::string& n, framework::Process& p)
       : Producer(n, p) {}
@@ -1,6 +1,10 @@
 #ifndef HCALPEDESTALANALYZER_H
 #define HCALPEDESTALANALYZER_H
 
+#include <array>
+#include <unordered_map>
+#include <vector>
+
 #include "DetDescr/HcalDigiID.h"
 #include "Framework/EventProcessor.h"
 #include "Recon/Event/HgcrocDigiCollection.h"
@@ -14,26 +18,36 @@ class HcalPedestalAnalyzer : public framework::Analyzer {
   bool filter_noTOA;
   int low_cutoff_, high_cutoff_;
 
+  /// Number of possible ADC values, the ADC is a 10-bit measurement
+  static constexpr int ADC_RANGE{1024};
+
   struct Channel {
-    Channel() : hist{0}, sum{0}, sum_sq{0}, entries{0}, rejects{4, 0} {}
-    /// collection of hits accumulated to produce appropriately-binned
-    /// histograms
-    std::vector<int> adcs;
-    /// Histogram, if used
-    TH1* hist;
-    /// Sum of values
-    uint64_t sum;
-    /// Sum of values squared
-    double sum_sq;
     /// Number of entries
-    int entries;
+    uint64_t entries{0};
+    /// Running mean of values, updated with Welford's algorithm
+    double mean{0};
+    /// Running sum of squared deviations from the mean
+    double m2{0};
     /// counts of various rejections
-    std::vector<int> rejects;
+    std::array<int, 4> rejects{};
   };
 
-  std::map<ldmx::HcalDigiID, Channel> pedestal_data_;
+  /// Index of each channel in the flat per-channel arrays
+  std::unordered_map<ldmx::HcalDigiID::RawValue, std::size_t> channel_index_;
+  /// ID of each channel, in the order they were first seen
+  std::vector<ldmx::HcalDigiID> channel_ids_;
+  /// Accumulated statistics of each channel
+  std::vector<Channel> channels_;
+  /// ADC counts of each channel, ADC_RANGE bins per channel, if make_histos_
+  std::vector<uint32_t> adc_counts_;
+
+  /**
+   * Get the index of a channel in the flat arrays, adding it if it is new.
+   */
+  std::size_t channel_index(ldmx::HcalDigiID detid);
 
-  void create_and_fill(Channel& chan, ldmx::HcalDigiID detid);
+  /// Build the channel histogram from its accumulated ADC counts
+  void create_and_fill(std::size_t index);
 
  public:
   HcalPedestalAnalyzer(const std::string& n, framework::Process& p)
@@ -4,6 +4,8 @@
 #include <bitset>
 #include <iomanip>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "DetDescr/HcalElectronicsID.h"
 #include "DetDescr/HcalID.h"
@@ -64,6 +66,8 @@ class HcalRawDecoder : public framework::Producer {
   void beforeNewRun(ldmx::RunHeader& rh) override;
   /// use read function to decode data, then translate EIDs into DetIDs
   void produce(framework::Event& event) override;
+  /// print the decoding counters
+  void onProcessEnd() override;
 
  private:
   /**
@@ -76,9 +80,7 @@ class HcalRawDecoder : public framework::Producer {
    * some point but for now, best to leave alone
    */
   template <typename ReaderType>
-  std::map<ldmx::HcalElectronicsID,
-           std::vector<ldmx::HgcrocDigiCollection::Sample>>
-  read(ReaderType& reader, PolarfireEventHeader& eh) {
+  void read(ReaderType& reader, PolarfireEventHeader& eh) {
     /**
      * Static parameters depending on ROC version
      */
@@ -176,10 +178,8 @@ class HcalRawDecoder : public framework::Producer {
      * have time to re-group the signals across multiple bunches (samples)
      * by their channel ID. We need to do that here.
      */
-    // fill map of **electronic** IDs to the digis that were read out
-    std::map<ldmx::HcalElectronicsID,
-             std::vector<ldmx::HgcrocDigiCollection::Sample>>
-        eid_to_samples;
+    // fill slots of **electronic** IDs with the samples that were read out
+    if (eids_.empty()) n_samples_ = eh.nsamples;
     std::size_t i_sample{0};
     while (i_event < eventlen) {
       reader >> head1 >> head2;
@@ -358,8 +358,8 @@ class HcalRawDecoder : public framework::Producer {
             ldmx::HcalElectronicsID eid(fpga, i_link,
                                         j - 1 - 1 * (j > common_mode_channel) -
                                             1 * (j > calib_channel));
-            // copy data into EID->sample map
-            eid_to_samples[eid].emplace_back(w);
+            // copy data into the slot of this EID
+            addSample(eid.index(), w);
           }  // type of channel
         }    // loop over channels (j in Table 4)
       }      // loop over links
@@ -390,8 +390,33 @@ class HcalRawDecoder : public framework::Producer {
       // special footer words
       reader >> head1 >> head2;
     }
+  }
 
-    return eid_to_samples;
+  /**
+   * Add a sample to the slot of the input electronics index
+   *
+   * Channels get a slot with space for the number of samples in
+   * this event the first time they are read out. Samples beyond that
+   * are only counted so that the channel can be skipped later.
+   *
+   * @param[in] index packed index of the electronics ID of the channel
+   * @param[in] w raw sample word
+   */
+  void addSample(unsigned int index, uint32_t w) {
+    if (index >= eid_slot_.size()) {
+      EXCEPTION_RAISE("BadEID", "Electronics index " + std::to_string(index) +
+                                    " is out of range.");
+    }
+    int& slot{eid_slot_[index]};
+    if (slot < 0) {
+      slot = eids_.size();
+      eids_.push_back(index);
+      sample_counts_.push_back(0);
+      samples_.resize(samples_.size() + n_samples_);
+    }
+    unsigned int& count{sample_counts_[slot]};
+    if (count < n_samples_) samples_[slot * n_samples_ + count] = w;
+    count++;
   }
 
  private:
@@ -415,6 +440,26 @@ class HcalRawDecoder : public framework::Producer {
  private:
   /// the file reader (if we are doing that)
   packing::utility::Reader file_reader_;
+
+  /// slot of each electronics index in this event, -1 if not read out
+  std::vector<int> eid_slot_;
+  /// electronics indices read out in this event
+  std::vector<unsigned int> eids_;
+  /// raw samples of all slots, n_samples_ for each slot
+  std::vector<uint32_t> samples_;
+  /// number of samples read out for each slot
+  std::vector<unsigned int> sample_counts_;
+  /// number of samples per channel in this event
+  unsigned int n_samples_{0};
+
+  /// number of events decoded
+  long int n_events_{0};
+  /// number of digis put onto the event bus
+  long int n_digis_{0};
+  /// number of channels skipped because they are not in the detector map
+  long int n_unmapped_{0};
+  /// number of channels skipped because of a wrong number of samples
+  long int n_bad_length_{0};
 };
 }  // namespace hcal
 #endif /* HCALRAWDECODER_H */
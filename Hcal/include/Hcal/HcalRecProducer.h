@@ -23,14 +23,9 @@
 #include "DetDescr/HcalGeometry.h"
 #include "DetDescr/HcalID.h"
 #include "Framework/EventProcessor.h"
+#include "Hcal/CorrectionTable.h"
 #include "Recon/Event/HgcrocDigiCollection.h"
 
-//---------//
-//  ROOT   //
-//---------//
-#include "TF1.h"
-#include "TGraph.h"
-
 namespace hcal {
 
 /**
@@ -74,6 +69,34 @@ class HcalRecProducer : public framework::Producer {
   void produce(framework::Event& event) override;
 
  private:
+  /**
+   * Evaluate the pulse shape with unit amplitude peaking at t = 0.
+   *
+   * This is the same shape as is emulated in the HgcrocEmulator
+   *
+   *  [0]*((1+exp([1]*(-[2]+[3])))*(1+exp([5]*(-[6]+[3]))))/
+   *    ((1+exp([1]*(t-[2]+[3]-[4])))*(1+exp([5]*(t-[6]+[3]-[4]))))
+   *
+   * with [0] = 1 and [4] = 0.
+   *
+   * @param[in] t time relative to the peak [ns]
+   * @return pulse height relative to the peak
+   */
+  double pulseShape(double t) const;
+
+  /**
+   * Find the time at which the rising edge of the unit pulse crosses
+   * the input fraction of its peak.
+   *
+   * The pulse shape is unimodal, so there is exactly one crossing
+   * between the start of the ADC buffer and the peak which we find by
+   * bisection.
+   *
+   * @param[in] fraction height relative to the peak, in (0,1)
+   * @return time relative to the peak [ns], negative
+   */
+  double pulseRiseTime(double fraction) const;
+
   /// Digi Collection Name to use as input
   std::string digiCollName_;
 
@@ -104,16 +127,15 @@ class HcalRecProducer : public framework::Producer {
   /// Strip attenuation length [m]
   double attlength_;
 
-  /// Pulse function
-  mutable TF1 pulseFunc_;
-
   /**
    * Correction to the pulse's measured amplitude at the peak.
    * The correction is calculated by comparing the amplitude at the sample time
    *(T) over its correct value (1.0) with the ratio between sample T and sample
    *T+25ns.
+   *
+   * The curve is sampled on a grid uniform in the amplitude fraction.
    **/
-  mutable TGraph correctionAmpl_;
+  CorrectionTable correctionAmpl_;
 
   /**
    * Correction to the measured TOA relative to the peak.
@@ -123,8 +145,11 @@ class HcalRecProducer : public framework::Producer {
    * measured relative to the peak (i.e. the time at which the pulse crosses the
    * TOA threshold) with the amplitude at the sample time (T) over its correct
    * value (1.0).
+   *
+   * The curve is sampled on a grid uniform in log(amplitude) since the time
+   * walk rises steeply towards the threshold.
    */
-  mutable TGraph correctionTOA_;
+  CorrectionTable correctionTOA_;
 
   /// Minimum amplitude fraction to apply amplitude correction
   double minAmplFraction_;
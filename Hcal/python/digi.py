@@ -72,6 +72,10 @@ class HcalDigiProducer(Producer) :
         Name of input pass 
     digiCollName : str    
         Name of digi collection                                                                                                                                                                          
+    nThreads : int
+        Number of threads to digitize bars with. With more than one thread,
+        each bar gets its own random stream so the digis do not depend on
+        the number of threads but differ from the single-threaded ones.
     """
 
     def __init__(self, instance_name = 'hcalDigis') :
@@ -99,6 +103,9 @@ class HcalDigiProducer(Producer) :
         self.inputPassName = ''
         self.digiCollName = 'HcalDigis'
 
+        # digitize bars in parallel
+        self.nThreads = 1
+
 class HcalRecProducer(Producer) :
     """Configuration for the HcalRecProducer
 
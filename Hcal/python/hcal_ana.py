@@ -13,9 +13,11 @@ class HcalPedestalAnalyzer(ldmxcfg.Analyzer) :
     input_pass : str
         Name of the input pass (or empty for default)
     output_file : str
-        Filename for output calibration file
+        Filename for output calibration file (empty to skip writing it)
     make_histos : bool
-        Make individual channel histograms (default = false)
+        Make individual channel histograms (default = false).
+        The ADC counts are accumulated in a fixed 1024-bin table per channel
+        and the histograms are filled from it at the end of processing.
     filter_noTOA : bool
         Ignore any event for a channel where the TOA fired in any sample (default=true)
     filter_noTOT : bool
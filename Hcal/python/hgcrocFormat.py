@@ -45,33 +45,38 @@ class HcalRawDecoder(Producer) :
             self.translate_eid = True
 
 class HcalAlignPolarfires(Producer) :
-    """Align the two polarfires from testbeam into singular events
+    """Align the polarfires from testbeam into singular events
 
     Parameters
     ----------
     output_name : str
         Name of event object with aligned digis
     input_names : list[str]
-        The event objects of the decoded digis from the two polarfires
+        The event objects of the decoded digis from the polarfires
     input_pass : str
         pass generating decoded digis
     max_tick_diff : int
-        Maximum number of ticks to consider the two polarfires on the same event
+        Maximum number of ticks to consider the polarfires on the same event
+    max_queue_size : int
+        Maximum number of events to buffer for each polarfire while waiting
+        for the others, the oldest are discarded beyond it (0 for no limit)
     drop_lonely_events : bool
-        True if you want to drop events that only have data from one polarfire
+        True if you want to drop events that are missing data from a polarfire
     keep_inputs : bool
         True if you want to keep both copies of the decoded data,
         effectively doubles the size of the output file, only use in debugging/developing
     """
 
     def __init__(self, output_name, input_names, input_pass = '',
-            max_tick_diff = 10, drop_lonely_events = False, keep_inputs = False) :
+            max_tick_diff = 10, drop_lonely_events = False, keep_inputs = False,
+            max_queue_size = 0) :
         super().__init__('hcalalign','hcal::HcalAlignPolarfires','Hcal')
 
         self.output_name = output_name
         self.input_names = input_names
         self.input_pass = input_pass
         self.max_tick_diff = max_tick_diff
+        self.max_queue_size = max_queue_size
 
         from LDMX.Framework import ldmxcfg
         p = ldmxcfg.Process.lastProcess
@@ -0,0 +1,40 @@
+#include "Hcal/CorrectionTable.h"
+
+#include "Framework/Exception/Exception.h"
+
+namespace hcal {
+
+CorrectionTable::CorrectionTable(const TGraph& curve, std::size_t n_points,
+                                 bool log_axis)
+    : log_axis_{log_axis} {
+  int n = curve.GetN();
+  if (n < 2 or n_points < 2) {
+    EXCEPTION_RAISE("BadTable",
+                    "A correction table needs at least two points.");
+  }
+  const double* x = curve.GetX();
+  const double* y = curve.GetY();
+  x_min_ = x[0];
+  x_max_ = x[n - 1];
+  if (log_axis_ and x_min_ <= 0.) {
+    EXCEPTION_RAISE("BadTable",
+                    "A logarithmic correction table needs positive x.");
+  }
+  slope_min_ = (y[1] - y[0]) / (x[1] - x[0]);
+  slope_max_ = (y[n - 1] - y[n - 2]) / (x[n - 1] - x[n - 2]);
+
+  double u_max = log_axis_ ? std::log(x_max_) : x_max_;
+  u_min_ = log_axis_ ? std::log(x_min_) : x_min_;
+  double du = (u_max - u_min_) / (n_points - 1);
+  inv_du_ = 1. / du;
+
+  y_.resize(n_points);
+  y_.front() = y[0];
+  y_.back() = y[n - 1];
+  for (std::size_t i{1}; i + 1 < n_points; i++) {
+    double u = u_min_ + i * du;
+    y_[i] = curve.Eval(log_axis_ ? std::exp(u) : u);
+  }
+}
+
+}  // namespace hcal
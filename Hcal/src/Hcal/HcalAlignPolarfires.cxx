@@ -1,7 +1,6 @@
 
 #include "Hcal/HcalAlignPolarfires.h"
 namespace hcal {
-int HcalAlignPolarfires::max_tick_diff_ = 10;
 HcalAlignPolarfires::PolarfireQueueEntry::PolarfireQueueEntry(
     const framework::Event& event, const std::string& input_name,
     const std::string& input_pass, std::pair<int, int>& spill_counter) {
@@ -20,71 +19,97 @@ void HcalAlignPolarfires::configure(framework::config::Parameters& ps) {
   input_pass_ = ps.getParameter<std::string>("input_pass");
   output_name_ = ps.getParameter<std::string>("output_name");
   max_tick_diff_ = ps.getParameter<int>("max_tick_diff");
+  max_queue_size_ = ps.getParameter<int>("max_queue_size", 0);
+
+  queues_.clear();
+  queues_.resize(input_names_.size());
+  spill_counters_.assign(input_names_.size(), {0, -1});
+  n_aligned_.assign(input_names_.size(), 0);
+  n_orphans_.assign(input_names_.size(), 0);
+  n_discarded_.assign(input_names_.size(), 0);
 }  // configure
 
 void HcalAlignPolarfires::produce(framework::Event& event) {
-  // put next package of decoding into the queues
-  pf0_queue.emplace(event, input_names_[0], input_pass_, pf0_spill_counter);
-  pf1_queue.emplace(event, input_names_[1], input_pass_, pf1_spill_counter);
+  std::size_t n_pf{queues_.size()};
+  // put next package of decoding into the queues and find the earliest
+  // event at the front of the queues
+  int earliest{-1};
+  for (std::size_t i_pf{0}; i_pf < n_pf; i_pf++) {
+    auto& queue{queues_[i_pf]};
+    queue.emplace_back(event, input_names_[i_pf], input_pass_,
+                       spill_counters_[i_pf]);
+
+    // remove empty events from front of queues for end-of-file condition
+    while (queue.size() > 0 and queue.front().digis.getNumDigis() == 0)
+      queue.pop_front();
+
+    // drop the oldest events if this polarfire has gotten too far ahead
+    while (max_queue_size_ > 0 and
+           queue.size() > static_cast<std::size_t>(max_queue_size_)) {
+      queue.pop_front();
+      n_discarded_[i_pf]++;
+    }
 
-  // remove empty events from front of queues for end-of-file condition
-  while (pf0_queue.size() > 0 and pf0_queue.front().digis.getNumDigis() == 0)
-    pf0_queue.pop();
-  while (pf1_queue.size() > 0 and pf1_queue.front().digis.getNumDigis() == 0)
-    pf1_queue.pop();
+    if (queue.size() > 0 and
+        (earliest < 0 or
+         queue.front().earlier_event(queues_[earliest].front())))
+      earliest = i_pf;
+  }
 
   bool aligned{false};
   ldmx::HgcrocDigiCollection merged;
-  if (pf0_queue.size() > 0 and pf1_queue.size() > 0) {
-    // we have non-empty events in the queues, start alignment procedure
-    if (pf0_queue.front().same_event(pf1_queue.front())) {
-      // same spill and ticks within max_tick_diff_ of each other
-      // add them together and put them into same object
-      merged = pf0_queue.front().digis;
-      const auto& unmerged{pf1_queue.front().digis};
-      for (int i{0}; i < unmerged.getNumDigis(); i++) {
-        auto digi{unmerged.getDigi(i)};
-        std::vector<ldmx::HgcrocDigiCollection::Sample> samples;
-        for (int j{0}; j < unmerged.getNumSamplesPerDigi(); j++) {
-          samples.push_back(digi.at(i));
-        }
-        merged.addDigi(digi.id(), samples);
+  if (earliest >= 0) {
+    // the polarfires with events within max_tick_diff_ of the earliest one
+    const auto& first{queues_[earliest].front()};
+    std::vector<bool> matched(n_pf, false);
+    std::size_t n_matched{0};
+    for (std::size_t i_pf{0}; i_pf < n_pf; i_pf++) {
+      matched[i_pf] = (i_pf == static_cast<std::size_t>(earliest)) or
+                      (queues_[i_pf].size() > 0 and
+                       queues_[i_pf].front().same_event(first, max_tick_diff_));
+      if (matched[i_pf]) n_matched++;
+    }
+    aligned = (n_matched == n_pf);
+
+    // add them together and put them into same object in polarfire order,
+    // moving the first and appending the others
+    bool empty{true};
+    for (std::size_t i_pf{0}; i_pf < n_pf; i_pf++) {
+      if (not matched[i_pf]) continue;
+      auto& digis{queues_[i_pf].front().digis};
+      if (empty) {
+        merged = std::move(digis);
+        empty = false;
+      } else {
+        merged.append(digis);
       }
-      aligned = true;
-      pf0_queue.pop();
-      pf1_queue.pop();
-      setStorageHint(framework::hint_shouldKeep);
-    } else if (pf0_queue.front().earlier_event(pf1_queue.front())) {
-      // should add pf0 but signal event is unmerged
-      merged = pf0_queue.front().digis;
-      pf0_queue.pop();
-      setStorageHint(framework::hint_shouldDrop);
-    } else {
-      // should add pf1 but signal event is unmerged
-      merged = pf1_queue.front().digis;
-      pf1_queue.pop();
-      setStorageHint(framework::hint_shouldDrop);
+      queues_[i_pf].pop_front();
+      if (aligned)
+        n_aligned_[i_pf]++;
+      else
+        n_orphans_[i_pf]++;
     }
-  } else if (pf0_queue.size() > 0) {
-    // only pf0 has non-empty events left
-    // should add pf0 but signal event is unmerged
-    merged = pf0_queue.front().digis;
-    pf0_queue.pop();
-    setStorageHint(framework::hint_shouldDrop);
-  } else if (pf1_queue.size() > 0) {
-    // only pf1 has non-empty events left
-    // should add pf1 but signal event is unmerged
-    merged = pf1_queue.front().digis;
-    pf1_queue.pop();
-    setStorageHint(framework::hint_shouldDrop);
+
+    // signal if the event is missing a polarfire
+    setStorageHint(aligned ? framework::hint_shouldKeep
+                           : framework::hint_shouldDrop);
   } else {
-    // no more events, both decoders are returning empty events
+    // no more events, all decoders are returning empty events
     abortEvent();
   }
 
   event.add(output_name_, merged);
   event.add(output_name_ + "Aligned", aligned);
 }  // produce
+
+void HcalAlignPolarfires::onProcessEnd() {
+  for (std::size_t i_pf{0}; i_pf < queues_.size(); i_pf++) {
+    ldmx_log(info) << input_names_[i_pf] << ": " << n_aligned_[i_pf]
+                   << " aligned, " << n_orphans_[i_pf] << " unmatched, "
+                   << n_discarded_[i_pf] << " discarded from a full queue, "
+                   << queues_[i_pf].size() << " left in queue";
+  }
+}
 }  // namespace hcal
 
 DECLARE_PRODUCER_NS(hcal, HcalAlignPolarfires);
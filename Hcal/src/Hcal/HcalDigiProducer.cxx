@@ -8,7 +8,11 @@
 
 #include "Hcal/HcalDigiProducer.h"
 
+#include <algorithm>
+
+#include "Framework/ParallelFor.h"
 #include "Framework/RandomNumberSeedService.h"
+#include "TROOT.h"
 
 namespace hcal {
 
@@ -35,6 +39,16 @@ void HcalDigiProducer::configure(framework::config::Parameters& ps) {
   iSOI_ = hgcrocParams.getParameter<int>("iSOI");
   noise_ = hgcrocParams.getParameter<bool>("noise");
 
+  // each thread digitizing bars needs its own emulator
+  nThreads_ = ps.getParameter<int>("nThreads", 1);
+  threadHgcrocs_.clear();
+  if (nThreads_ > 1) {
+    ROOT::EnableThreadSafety();
+    for (int iThread = 0; iThread < nThreads_; iThread++)
+      threadHgcrocs_.push_back(
+          std::make_unique<ldmx::HgcrocEmulator>(hgcrocParams));
+  }
+
   // collection names
   inputCollName_ = ps.getParameter<std::string>("inputCollName");
   inputPassName_ = ps.getParameter<std::string>("inputPassName");
@@ -80,6 +94,12 @@ void HcalDigiProducer::produce(framework::Event& event) {
         framework::RandomNumberSeedService::CONDITIONS_OBJECT_NAME);
     hgcroc_->seedGenerator(rseed.getSeed("HcalDigiProducer::HgcrocEmulator"));
   }
+  if (nThreads_ > 1 and barSeeder_.get() == nullptr) {
+    const auto& rseed = getCondition<framework::RandomNumberSeedService>(
+        framework::RandomNumberSeedService::CONDITIONS_OBJECT_NAME);
+    barSeeder_ = std::make_unique<TRandom3>(
+        rseed.getSeed("HcalDigiProducer::BarSeeder"));
+  }
 
   // Get the Hgcroc Conditions
   hgcroc_->condition(
@@ -94,180 +114,50 @@ void HcalDigiProducer::produce(framework::Event& event) {
   hcalDigis.setNumSamplesPerDigi(nADCs_);
   hcalDigis.setSampleOfInterestIndex(iSOI_);
 
-  std::map<unsigned int, std::vector<const ldmx::SimCalorimeterHit*>> hitsByID;
-
   // get simulated hcal hits from Geant4 and group them by id
-  auto hcalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
+  //  sorting (id, index) pairs keeps the hits of a bar in the order they
+  //  were simulated
+  const auto& hcalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
       inputCollName_, inputPassName_)};
 
-  for (auto const& simHit : hcalSimHits) {
-    // get ID
-    unsigned int hitID = simHit.getID();
-
-    auto idh = hitsByID.find(hitID);
-    if (idh == hitsByID.end()) {
-      hitsByID[hitID] = std::vector<const ldmx::SimCalorimeterHit*>(1, &simHit);
-    } else {
-      idh->second.push_back(&simHit);
+  hitOrder_.clear();
+  hitOrder_.reserve(hcalSimHits.size());
+  for (unsigned int iHit = 0; iHit < hcalSimHits.size(); iHit++)
+    hitOrder_.emplace_back(hcalSimHits[iHit].getID(), iHit);
+  std::sort(hitOrder_.begin(), hitOrder_.end());
+
+  barIDs_.clear();
+  barOffsets_.clear();
+  for (std::size_t iHit = 0; iHit < hitOrder_.size(); iHit++) {
+    if (iHit == 0 or hitOrder_[iHit].first != barIDs_.back()) {
+      barIDs_.push_back(hitOrder_[iHit].first);
+      barOffsets_.push_back(iHit);
     }
   }
+  barOffsets_.push_back(hitOrder_.size());
 
   /******************************************************************************************
    * HGCROC Emulation on Simulated Hits (grouped by HcalID)
    ******************************************************************************************/
-  for (auto const& simBar : hitsByID) {
-    ldmx::HcalID detID(simBar.first);
-    int section = detID.section();
-    int layer = detID.layer();
-    int strip = detID.strip();
-
-    // get position
-    double half_total_width = hcalGeometry.getHalfTotalWidth(section, layer);
-    double ecal_dx = hcalGeometry.getEcalDx();
-    double ecal_dy = hcalGeometry.getEcalDy();
-
-    // contributions
-    std::vector<std::pair<double, double>> pulses_posend;
-    std::vector<std::pair<double, double>> pulses_negend;
-
-    for (auto psimHit : simBar.second) {
-      const ldmx::SimCalorimeterHit& simHit = *psimHit;
-
-      std::vector<float> position = simHit.getPosition();
-
-      /**
-       * Define two pulses: with positive and negative ends.
-       * For this we need to:
-       * (1) Find the position along the bar:
-       *     For back Hcal: x (y) for horizontal (vertical) layers.
-       *     For side Hcal: x (top,bottom) and y (left,right).
-       *
-       * (2) Define the end of the bar:
-       *     The end of an HcalDigiID is based on its distance (x,y) along the
-       *     bar.
-       *     - A positive end (endID=0), corresponds to top,left.
-       *     - A negative end (endID=1), corresponds to bottom,right.
-       *     For back Hcal:
-       *     - if the position along the bar > 0, the close pulse's end is 0,
-       *     else 1.
-       *     For side Hcal:
-       *     - if the position along the bar > half_width point of the bar, the
-       *     close pulse's end is 0, else 1.
-       *     The far pulse's end will be opposite to the close pulse's end.
-       *
-       * (3) Find the distance to each end (positive and negative) from the
-       *     origin.
-       *     For the back Hcal, the half point of the bar coincides with the
-       *     coordinates of the origin.
-       *     For the side Hcal, the length of the bar from the origin is:
-       *     - 2 *(half_width) - Ecal_dx(y)/2 away from the positive end, and,
-       *     - Ecal_dx(y) away from the negative end.
-       */
-      float distance_along_bar, distance_ecal;
-      float distance_close, distance_far;
-      int end_close;
-      const auto orientation{hcalGeometry.getScintillatorOrientation(detID)};
-      if (section == ldmx::HcalID::HcalSection::BACK) {
-        distance_along_bar =
-            (orientation ==
-             ldmx::HcalGeometry::ScintillatorOrientation::horizontal)
-                ? position[0]
-                : position[1];
-        end_close = (distance_along_bar > 0) ? 0 : 1;
-        distance_close = half_total_width;
-        distance_far = half_total_width;
-      } else {
-        if ((section == ldmx::HcalID::HcalSection::TOP) ||
-            ((section == ldmx::HcalID::HcalSection::BOTTOM))) {
-          distance_along_bar = position[0];
-          distance_ecal = ecal_dx;
-        } else if ((section == ldmx::HcalID::HcalSection::LEFT) ||
-                   (section == ldmx::HcalID::HcalSection::RIGHT)) {
-          distance_along_bar = position[1];
-          distance_ecal = ecal_dy;
-        }
-        end_close = (distance_along_bar > half_total_width) ? 0 : 1;
-        distance_close = (end_close == 0)
-                             ? 2 * half_total_width - distance_ecal / 2
-                             : distance_ecal / 2;
-        distance_far = (end_close == 0)
-                           ? distance_ecal / 2
-                           : 2 * half_total_width - distance_ecal / 2;
-      }
-
-      // Calculate voltage attenuation and time shift for the close and far
-      // pulse.
-      float v = 299.792 /
-                1.6;  // velocity of light in Polystyrene, n = 1.6 = c/v mm/ns
-      double att_close =
-          exp(-1. * ((distance_close - fabs(distance_along_bar)) / 1000.) /
-              attlength_);
-      double att_far =
-          exp(-1. * ((distance_far + fabs(distance_along_bar)) / 1000.) /
-              attlength_);
-      double shift_close =
-          fabs((distance_close - fabs(distance_along_bar)) / v);
-      double shift_far = fabs((distance_far + fabs(distance_along_bar)) / v);
-
-      // Get voltages and times.
-      for (int iContrib = 0; iContrib < simHit.getNumberOfContribs();
-           iContrib++) {
-        double voltage = simHit.getContrib(iContrib).edep * MeV_;
-        double time =
-            simHit.getContrib(iContrib).time;  // global time (t=0ns at target)
-        time -= position.at(2) /
-                299.702547;  // shift light-speed particle traveling along z
-
-        if (end_close == 0) {
-          pulses_posend.emplace_back(voltage * att_close, time + shift_close);
-          pulses_negend.emplace_back(voltage * att_far, time + shift_far);
-        } else {
-          pulses_posend.emplace_back(voltage * att_far, time + shift_far);
-          pulses_negend.emplace_back(voltage * att_close, time + shift_close);
-        }
-      }
+  if (nThreads_ > 1) {
+    for (auto& hgcroc : threadHgcrocs_)
+      hgcroc->condition(getCondition<conditions::DoubleTableCondition>(
+          "HcalHgcrocConditions"));
+    digitizeBarsConcurrently(hcalGeometry, hcalSimHits);
+    for (std::size_t iBar = 0; iBar < barIDs_.size(); iBar++) {
+      for (int iDigi = 0; iDigi < barDigis_[iBar].n; iDigi++)
+        hcalDigis.addDigi(barDigis_[iBar].ids[iDigi],
+                          barDigis_[iBar].samples[iDigi]);
     }
-
-    /**
-     * Now we have all the sub-hits from all the simhits
-     * Digitize:
-     * For back Hcal return two digis.
-     * For side Hcal we choose which pulse to readout based on
-     * the position of the hit and the sub-section.
-     * For Top and Left we read the positive end digi.
-     * For Bottom and Right we read the negative end digi.
-     **/
-    if (section == ldmx::HcalID::HcalSection::BACK) {
-      std::vector<ldmx::HgcrocDigiCollection::Sample> digiToAddPosend,
-          digiToAddNegend;
-      ldmx::HcalDigiID posendID(section, layer, strip, 0);
-      ldmx::HcalDigiID negendID(section, layer, strip, 1);
-      if (hgcroc_->digitize(posendID.raw(), pulses_posend, digiToAddPosend) &&
-          hgcroc_->digitize(negendID.raw(), pulses_negend, digiToAddNegend)) {
-        hcalDigis.addDigi(posendID.raw(), digiToAddPosend);
-        hcalDigis.addDigi(negendID.raw(), digiToAddNegend);
-      }  // Back Hcal needs to digitize both pulses or none
-    } else {
-      bool is_posend = false;
-      std::vector<ldmx::HgcrocDigiCollection::Sample> digiToAdd;
-      if ((section == ldmx::HcalID::HcalSection::TOP) ||
-          (section == ldmx::HcalID::HcalSection::LEFT)) {
-        is_posend = true;
-      } else if ((section == ldmx::HcalID::HcalSection::BOTTOM) ||
-                 (section == ldmx::HcalID::HcalSection::RIGHT)) {
-        is_posend = false;
-      }
-      if (is_posend) {
-        ldmx::HcalDigiID digiID(section, layer, strip, 0);
-        if (hgcroc_->digitize(digiID.raw(), pulses_posend, digiToAdd)) {
-          hcalDigis.addDigi(digiID.raw(), digiToAdd);
-        }
-      } else {
-        ldmx::HcalDigiID digiID(section, layer, strip, 1);
-        if (hgcroc_->digitize(digiID.raw(), pulses_negend, digiToAdd)) {
-          hcalDigis.addDigi(digiID.raw(), digiToAdd);
-        }
-      }
+  } else {
+    barDigis_.resize(1);
+    std::vector<std::pair<double, double>> pulses_posend, pulses_negend;
+    for (std::size_t iBar = 0; iBar < barIDs_.size(); iBar++) {
+      digitizeBar(iBar, hcalGeometry, hcalSimHits, *hgcroc_, pulses_posend,
+                  pulses_negend, barDigis_[0]);
+      for (int iDigi = 0; iDigi < barDigis_[0].n; iDigi++)
+        hcalDigis.addDigi(barDigis_[0].ids[iDigi],
+                          barDigis_[0].samples[iDigi]);
     }
   }
 
@@ -295,6 +185,7 @@ void HcalDigiProducer::produce(framework::Event& event) {
     auto noiseHitAmplitudes{
         noiseGenerator_->generateNoiseHits(numEmptyChannels)};
     std::vector<std::pair<double, double>> fake_pulse(1, {0., 0.});
+    std::set<unsigned int> noiseIDs;
     for (double noiseHit : noiseHitAmplitudes) {
       // generate detector ID for noise hit
       // making sure that it is in an empty channel
@@ -318,9 +209,9 @@ void HcalDigiProducer::produce(framework::Event& event) {
         }
         auto detID = ldmx::HcalDigiID(sectionID, layerID, stripID, endID);
         noiseID = detID.raw();
-      } while (hitsByID.find(noiseID) != hitsByID.end());
-      hitsByID[noiseID] =
-          std::vector<const ldmx::SimCalorimeterHit*>();  // mark this as used
+      } while (std::binary_search(barIDs_.begin(), barIDs_.end(), noiseID) or
+               noiseIDs.find(noiseID) != noiseIDs.end());
+      noiseIDs.insert(noiseID);  // mark this as used
 
       // get a time for this noise hit
       fake_pulse[0].second = noiseInjector_->Uniform(clockCycle_);
@@ -356,6 +247,187 @@ void HcalDigiProducer::produce(framework::Event& event) {
   return;
 }  // produce
 
+void HcalDigiProducer::digitizeBar(
+    std::size_t iBar, const ldmx::HcalGeometry& hcalGeometry,
+    const std::vector<ldmx::SimCalorimeterHit>& simHits,
+    const ldmx::HgcrocEmulator& hgcroc,
+    std::vector<std::pair<double, double>>& pulses_posend,
+    std::vector<std::pair<double, double>>& pulses_negend,
+    BarDigis& digis) const {
+  ldmx::HcalID detID(barIDs_[iBar]);
+  int section = detID.section();
+  int layer = detID.layer();
+  int strip = detID.strip();
+
+  // get position
+  double half_total_width = hcalGeometry.getHalfTotalWidth(section, layer);
+  double ecal_dx = hcalGeometry.getEcalDx();
+  double ecal_dy = hcalGeometry.getEcalDy();
+
+  // contributions
+  pulses_posend.clear();
+  pulses_negend.clear();
+
+  for (std::size_t iHit = barOffsets_[iBar]; iHit < barOffsets_[iBar + 1];
+       iHit++) {
+    const ldmx::SimCalorimeterHit& simHit = simHits[hitOrder_[iHit].second];
+
+    std::vector<float> position = simHit.getPosition();
+
+    /**
+     * Define two pulses: with positive and negative ends.
+     * For this we need to:
+     * (1) Find the position along the bar:
+     *     For back Hcal: x (y) for horizontal (vertical) layers.
+     *     For side Hcal: x (top,bottom) and y (left,right).
+     *
+     * (2) Define the end of the bar:
+     *     The end of an HcalDigiID is based on its distance (x,y) along the
+     *     bar.
+     *     - A positive end (endID=0), corresponds to top,left.
+     *     - A negative end (endID=1), corresponds to bottom,right.
+     *     For back Hcal:
+     *     - if the position along the bar > 0, the close pulse's end is 0,
+     *     else 1.
+     *     For side Hcal:
+     *     - if the position along the bar > half_width point of the bar, the
+     *     close pulse's end is 0, else 1.
+     *     The far pulse's end will be opposite to the close pulse's end.
+     *
+     * (3) Find the distance to each end (positive and negative) from the
+     *     origin.
+     *     For the back Hcal, the half point of the bar coincides with the
+     *     coordinates of the origin.
+     *     For the side Hcal, the length of the bar from the origin is:
+     *     - 2 *(half_width) - Ecal_dx(y)/2 away from the positive end, and,
+     *     - Ecal_dx(y) away from the negative end.
+     */
+    float distance_along_bar, distance_ecal;
+    float distance_close, distance_far;
+    int end_close;
+    const auto orientation{hcalGeometry.getScintillatorOrientation(detID)};
+    if (section == ldmx::HcalID::HcalSection::BACK) {
+      distance_along_bar =
+          (orientation ==
+           ldmx::HcalGeometry::ScintillatorOrientation::horizontal)
+              ? position[0]
+              : position[1];
+      end_close = (distance_along_bar > 0) ? 0 : 1;
+      distance_close = half_total_width;
+      distance_far = half_total_width;
+    } else {
+      if ((section == ldmx::HcalID::HcalSection::TOP) ||
+          ((section == ldmx::HcalID::HcalSection::BOTTOM))) {
+        distance_along_bar = position[0];
+        distance_ecal = ecal_dx;
+      } else if ((section == ldmx::HcalID::HcalSection::LEFT) ||
+                 (section == ldmx::HcalID::HcalSection::RIGHT)) {
+        distance_along_bar = position[1];
+        distance_ecal = ecal_dy;
+      }
+      end_close = (distance_along_bar > half_total_width) ? 0 : 1;
+      distance_close = (end_close == 0)
+                           ? 2 * half_total_width - distance_ecal / 2
+                           : distance_ecal / 2;
+      distance_far = (end_close == 0)
+                         ? distance_ecal / 2
+                         : 2 * half_total_width - distance_ecal / 2;
+    }
+
+    // Calculate voltage attenuation and time shift for the close and far
+    // pulse.
+    float v = 299.792 /
+              1.6;  // velocity of light in Polystyrene, n = 1.6 = c/v mm/ns
+    double att_close =
+        exp(-1. * ((distance_close - fabs(distance_along_bar)) / 1000.) /
+            attlength_);
+    double att_far =
+        exp(-1. * ((distance_far + fabs(distance_along_bar)) / 1000.) /
+            attlength_);
+    double shift_close = fabs((distance_close - fabs(distance_along_bar)) / v);
+    double shift_far = fabs((distance_far + fabs(distance_along_bar)) / v);
+
+    // Get voltages and times.
+    for (int iContrib = 0; iContrib < simHit.getNumberOfContribs();
+         iContrib++) {
+      double voltage = simHit.getContrib(iContrib).edep * MeV_;
+      double time =
+          simHit.getContrib(iContrib).time;  // global time (t=0ns at target)
+      time -= position.at(2) /
+              299.702547;  // shift light-speed particle traveling along z
+
+      if (end_close == 0) {
+        pulses_posend.emplace_back(voltage * att_close, time + shift_close);
+        pulses_negend.emplace_back(voltage * att_far, time + shift_far);
+      } else {
+        pulses_posend.emplace_back(voltage * att_far, time + shift_far);
+        pulses_negend.emplace_back(voltage * att_close, time + shift_close);
+      }
+    }
+  }
+
+  /**
+   * Now we have all the sub-hits from all the simhits
+   * Digitize:
+   * For back Hcal return two digis.
+   * For side Hcal we choose which pulse to readout based on
+   * the position of the hit and the sub-section.
+   * For Top and Left we read the positive end digi.
+   * For Bottom and Right we read the negative end digi.
+   **/
+  digis.n = 0;
+  if (section == ldmx::HcalID::HcalSection::BACK) {
+    ldmx::HcalDigiID posendID(section, layer, strip, 0);
+    ldmx::HcalDigiID negendID(section, layer, strip, 1);
+    if (hgcroc.digitize(posendID.raw(), pulses_posend, digis.samples[0]) &&
+        hgcroc.digitize(negendID.raw(), pulses_negend, digis.samples[1])) {
+      digis.ids = {posendID.raw(), negendID.raw()};
+      digis.n = 2;
+    }  // Back Hcal needs to digitize both pulses or none
+  } else {
+    bool is_posend = false;
+    if ((section == ldmx::HcalID::HcalSection::TOP) ||
+        (section == ldmx::HcalID::HcalSection::LEFT)) {
+      is_posend = true;
+    } else if ((section == ldmx::HcalID::HcalSection::BOTTOM) ||
+               (section == ldmx::HcalID::HcalSection::RIGHT)) {
+      is_posend = false;
+    }
+    ldmx::HcalDigiID digiID(section, layer, strip, is_posend ? 0 : 1);
+    if (hgcroc.digitize(digiID.raw(),
+                        is_posend ? pulses_posend : pulses_negend,
+                        digis.samples[0])) {
+      digis.ids[0] = digiID.raw();
+      digis.n = 1;
+    }
+  }
+}
+
+void HcalDigiProducer::digitizeBarsConcurrently(
+    const ldmx::HcalGeometry& hcalGeometry,
+    const std::vector<ldmx::SimCalorimeterHit>& simHits) {
+  barDigis_.resize(std::max(barDigis_.size(), barIDs_.size()));
+  uint64_t eventSeed = barSeeder_->Integer(0xffffffff);
+
+  // pulse buffers of each thread
+  std::vector<std::vector<std::pair<double, double>>> pulses_posend(nThreads_),
+      pulses_negend(nThreads_);
+  auto digitizeSeededBar = [&](std::size_t iBar, int iThread) {
+    // mix the event and bar numbers (splitmix64) into the bar's seed
+    uint64_t seed = (eventSeed << 32) + barIDs_[iBar];
+    seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9;
+    seed = (seed ^ (seed >> 27)) * 0x94d049bb133111eb;
+    seed ^= seed >> 31;
+    // TRandom3 only uses the lower 32 bits and picks a time-dependent
+    // seed for zero
+    auto& hgcroc{*threadHgcrocs_[iThread]};
+    hgcroc.seedGenerator((seed & 0xffffffff) == 0 ? 1 : seed);
+    digitizeBar(iBar, hcalGeometry, simHits, hgcroc, pulses_posend[iThread],
+                pulses_negend[iThread], barDigis_[iBar]);
+  };
+  framework::parallelFor(barIDs_.size(), nThreads_, digitizeSeededBar);
+}
+
 }  // namespace hcal
 
 DECLARE_PRODUCER_NS(hcal, HcalDigiProducer);
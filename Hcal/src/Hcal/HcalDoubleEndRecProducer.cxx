@@ -1,5 +1,8 @@
 #include "Hcal/HcalDoubleEndRecProducer.h"
 
+#include <algorithm>
+#include <string>
+
 namespace hcal {
 
 void HcalDoubleEndRecProducer::configure(framework::config::Parameters& p) {
@@ -21,62 +24,68 @@ void HcalDoubleEndRecProducer::produce(framework::Event& event) {
   const auto& conditions{
       getCondition<HcalReconConditions>(HcalReconConditions::CONDITIONS_NAME)};
 
-  auto hcalRecHits = event.getCollection<ldmx::HcalHit>(coll_name_, pass_name_);
+  const auto& hcalRecHits =
+      event.getCollection<ldmx::HcalHit>(coll_name_, pass_name_);
 
   std::vector<ldmx::HcalHit> doubleHcalRecHits;
 
-  // group hcal rechits by the same HcalID
-  std::map<ldmx::HcalID, std::vector<ldmx::HcalHit>> hitsByID;
-  for (auto const& hit : hcalRecHits) {
-    ldmx::HcalID id(hit.getSection(), hit.getLayer(), hit.getStrip());
-
-    auto idh = hitsByID.find(id);
-    if (idh == hitsByID.end()) {
-      hitsByID[id] = std::vector<ldmx::HcalHit>(1, hit);
-    } else {
-      idh->second.push_back(hit);
-    }
-  }
+  // reset the bars of the previous event, which may have stopped before
+  // its bars were reconstructed
+  for (int bar : hitBars_) barEnds_[bar] = {-1, -1};
+  if (&hcalGeometry != barGeometry_) buildBarIndex(hcalGeometry);
 
   // make pairs of hcal rechits indices that belong to the same pulse
   // @TODO: for now we just take the first two indices that have opposite-ends
   //        we do not cover the case where two hits come separated in time
-  std::map<ldmx::HcalID, std::pair<int, int>> indicesByID;
-  for (auto const& hcalBar : hitsByID) {
-    auto id = hcalBar.first;
-
-    std::pair<int, int> indices(-1, -1);
-    int iHit = 0;
-    while (iHit < hcalBar.second.size()) {
-      auto hit = hcalBar.second.at(iHit);
-
-      ldmx::HcalDigiID digi_id(hit.getSection(), hit.getLayer(), hit.getStrip(),
-                               hit.getEnd());
-      if (digi_id.isNegativeEnd() && indices.second == -1) {
-        indices.second = iHit;
-      }
-      if (!digi_id.isNegativeEnd() && indices.first == -1) {
-        indices.first = iHit;
-      }
-      iHit++;
+  hitBars_.clear();
+  for (int iHit = 0; iHit < hcalRecHits.size(); iHit++) {
+    const auto& hit{hcalRecHits[iHit]};
+
+    // skip non-double-ended layers
+    if (hit.getSection() != ldmx::HcalID::HcalSection::BACK) continue;
+
+    int layer = hit.getLayer(), strip = hit.getStrip();
+    if (layer < 1 or layer >= static_cast<int>(layerOffsets_.size()) or
+        strip < 0 or strip >= layerOffsets_[layer] - layerOffsets_[layer - 1]) {
+      EXCEPTION_RAISE("BadHcalID",
+                      "Back Hcal hit in layer " + std::to_string(layer) +
+                          " and strip " + std::to_string(strip) +
+                          " is not in the geometry.");
+    }
+    int bar = layerOffsets_[layer - 1] + strip;
+
+    auto& indices{barEnds_[bar]};
+    if (indices.first == -1 and indices.second == -1) hitBars_.push_back(bar);
+
+    ldmx::HcalDigiID digi_id(hit.getSection(), hit.getLayer(), hit.getStrip(),
+                             hit.getEnd());
+    if (digi_id.isNegativeEnd() && indices.second == -1) {
+      indices.second = iHit;
+    }
+    if (!digi_id.isNegativeEnd() && indices.first == -1) {
+      indices.first = iHit;
     }
-    indicesByID[id] = indices;
   }
 
   // reconstruct double-ended hits
-  for (auto const& hcalBar : hitsByID) {
-    auto id = hcalBar.first;
+  //  bar indices increase with the HcalID so the hits come out in ID order
+  std::sort(hitBars_.begin(), hitBars_.end());
+  for (int bar : hitBars_) {
+    const auto& indices{barEnds_[bar]};
 
-    // get bar position from geometry
-    auto position = hcalGeometry.getStripCenterPosition(id);
-    const auto orientation{hcalGeometry.getScintillatorOrientation(id)};
-
-    // skip non-double-ended layers
-    if (id.section() != ldmx::HcalID::HcalSection::BACK) continue;
+    // both ends are needed to reconstruct
+    if (indices.first == -1 or indices.second == -1) continue;
 
     // get two hits to reconstruct
-    auto hitPosEnd = hcalBar.second.at(indicesByID[id].first);
-    auto hitNegEnd = hcalBar.second.at(indicesByID[id].second);
+    const auto& hitPosEnd{hcalRecHits[indices.first]};
+    const auto& hitNegEnd{hcalRecHits[indices.second]};
+
+    ldmx::HcalID id(hitPosEnd.getSection(), hitPosEnd.getLayer(),
+                    hitPosEnd.getStrip());
+
+    // get bar position from geometry
+    auto position = hcalGeometry.getStripCenter(id);
+    const auto orientation{hcalGeometry.getScintillatorOrientation(id)};
 
     // update TOA hit with negative end with mean shift
     ldmx::HcalDigiID digi_id_pos(hitPosEnd.getSection(), hitPosEnd.getLayer(),
@@ -109,13 +118,13 @@ void HcalDoubleEndRecProducer::produce(framework::Event& event) {
     double position_bar = position_bar_sign * fabs(hitTimeDiff) * v / 2;
     if (orientation ==
         ldmx::HcalGeometry::ScintillatorOrientation::horizontal) {
-      position_unchanged = position.X();
+      position_unchanged = position[0];
       isX = 1;
-      position.SetX(position_bar);
+      position[0] = position_bar;
     } else {
-      position_unchanged = position.Y();
+      position_unchanged = position[1];
       isX = 0;
-      position.SetY(position_bar);
+      position[1] = position_bar;
     }
     // std::cout << "position unchanged " << position_unchanged << " isx " <<
     // isX << std::endl; std::cout << "newposition " << position.X() << " " <<
@@ -135,9 +144,9 @@ void HcalDoubleEndRecProducer::produce(framework::Event& event) {
     // reconstructed Hit
     ldmx::HcalHit recHit;
     recHit.setID(id.raw());
-    recHit.setXPos(position.X());
-    recHit.setYPos(position.Y());
-    recHit.setZPos(position.Z());
+    recHit.setXPos(position[0]);
+    recHit.setYPos(position[1]);
+    recHit.setZPos(position[2]);
     recHit.setSection(id.section());
     recHit.setStrip(id.strip());
     recHit.setLayer(id.layer());
@@ -159,5 +168,18 @@ void HcalDoubleEndRecProducer::produce(framework::Event& event) {
   event.add(rec_coll_name_, doubleHcalRecHits);
 }
 
+void HcalDoubleEndRecProducer::buildBarIndex(
+    const ldmx::HcalGeometry& hcalGeometry) {
+  int section = ldmx::HcalID::HcalSection::BACK;
+  int numLayers = hcalGeometry.getNumLayers(section);
+  layerOffsets_.assign(1, 0);
+  for (int layer = 1; layer <= numLayers; layer++) {
+    layerOffsets_.push_back(layerOffsets_.back() +
+                            hcalGeometry.getNumStrips(section, layer));
+  }
+  barEnds_.assign(layerOffsets_.back(), {-1, -1});
+  barGeometry_ = &hcalGeometry;
+}
+
 }  // namespace hcal
 DECLARE_PRODUCER_NS(hcal, HcalDoubleEndRecProducer);
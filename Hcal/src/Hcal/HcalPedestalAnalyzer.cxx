@@ -3,6 +3,11 @@
 
 #include "Hcal/HcalPedestalAnalyzer.h"
 
+#include <algorithm>
+#include <numeric>
+
+#include "TH1D.h"
+
 namespace hcal {
 
 void HcalPedestalAnalyzer::analyze(const framework::Event& event) {
@@ -13,7 +18,8 @@ void HcalPedestalAnalyzer::analyze(const framework::Event& event) {
     auto d{digis.getDigi(i_digi)};
     ldmx::HcalDigiID detid(d.id());
 
-    Channel& chan = pedestal_data_[detid];
+    const std::size_t index{channel_index(detid)};
+    Channel& chan = channels_[index];
 
     bool has_tot = false;
     bool has_toa = false;
@@ -40,46 +46,95 @@ void HcalPedestalAnalyzer::analyze(const framework::Event& event) {
       continue;  // ignore this, set threshold larger than 1024 to disable
                  // requirement
 
+    uint32_t* counts{nullptr};
+    if (make_histos_) counts = &adc_counts_[index * ADC_RANGE];
     for (int i = 0; i < digis.getNumSamplesPerDigi(); i++) {
       int adc = d.at(i).adc_t();
 
-      chan.sum += adc;
-      chan.sum_sq += adc * adc;
       chan.entries++;
-      if (chan.hist)
-        chan.hist->Fill(adc);
-      else if (make_histos_)
-        chan.adcs.push_back(adc);
+      double delta = adc - chan.mean;
+      chan.mean += delta / chan.entries;
+      chan.m2 += delta * (adc - chan.mean);
+      if (counts) counts[std::clamp(adc, 0, ADC_RANGE - 1)]++;
     }
+  }
+}
 
-    // histogram-related business
-    if (make_histos_ && !chan.hist && chan.entries > 250)
-      create_and_fill(chan, detid);
+std::size_t HcalPedestalAnalyzer::channel_index(ldmx::HcalDigiID detid) {
+  auto [it, inserted] =
+      channel_index_.try_emplace(detid.raw(), channels_.size());
+  if (inserted) {
+    channel_ids_.push_back(detid);
+    channels_.emplace_back();
+    if (make_histos_) adc_counts_.resize(channels_.size() * ADC_RANGE, 0);
   }
+  return it->second;
 }
 
-void HcalPedestalAnalyzer::create_and_fill(Channel& chan,
-                                           ldmx::HcalDigiID detid) {
+void HcalPedestalAnalyzer::create_and_fill(std::size_t index) {
+  const Channel& chan{channels_[index]};
   if (chan.entries == 0) return;
 
+  const ldmx::HcalDigiID& detid{channel_ids_[index]};
   TDirectory* hdir = getHistoDirectory();
   hdir->cd();
   char hname[120];
   sprintf(hname, "pedestal_%d_%d_%d_%d", detid.section(), detid.layer(),
           detid.strip(), detid.end());
-  // logic: 100 bins to +/- 5 sigma based on first 250 events.
-  double mean = (chan.sum * 1.0) / chan.entries;
-  double rms = sqrt(chan.sum_sq / chan.entries - mean * mean);
+  // logic: 100 bins to +/- 5 sigma based on all accepted entries.
+  double mean = chan.mean;
+  double rms = sqrt(chan.m2 / chan.entries);
+  TH1* hist;
   if (rms * 5 < 50)
-    chan.hist = new TH1D(hname, hname, 30, int(mean) - 15, int(mean) + 15);
+    hist = new TH1D(hname, hname, 30, int(mean) - 15, int(mean) + 15);
   else
-    chan.hist = new TH1D(hname, hname, 100, mean - 5 * rms, mean + 5 * rms);
-  for (auto x : chan.adcs) chan.hist->Fill(x);
-  chan.adcs.clear();
+    hist = new TH1D(hname, hname, 100, mean - 5 * rms, mean + 5 * rms);
+  // Set the bins from the counts rather than with a weighted Fill, which
+  // would switch on Sumw2 and count one entry per ADC value. The contents,
+  // errors, entries and statistics are the same as filling every sample.
+  const uint32_t* counts{&adc_counts_[index * ADC_RANGE]};
+  double stats[4] = {0., 0., 0., 0.};
+  double total{0.};
+  for (int adc = 0; adc < ADC_RANGE; adc++) {
+    if (counts[adc] == 0) continue;
+    double n = counts[adc];
+    int bin = hist->FindBin(adc);
+    hist->SetBinContent(bin, hist->GetBinContent(bin) + n);
+    total += n;
+    // Fill leaves the under- and overflow out of the statistics
+    if (bin > 0 && bin <= hist->GetNbinsX()) {
+      stats[0] += n;
+      stats[1] += n;
+      stats[2] += n * adc;
+      stats[3] += n * adc * adc;
+    }
+  }
+  hist->PutStats(stats);
+  hist->SetEntries(total);
 }
 
 void HcalPedestalAnalyzer::onProcessEnd() {
+  // write out channels in order of their IDs
+  std::vector<std::size_t> order(channels_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+    return channel_ids_[a] < channel_ids_[b];
+  });
+
+  if (make_histos_) {
+    for (auto index : order) create_and_fill(index);
+  }
+
+  if (output_file_.empty()) {
+    ldmx_log(warn) << "No output_file given, not writing pedestal CSV";
+    return;
+  }
+
   FILE* fout = fopen(output_file_.c_str(), "w");
+  if (!fout) {
+    EXCEPTION_RAISE("FileError",
+                    "Unable to open pedestal file '" + output_file_ + "'");
+  }
 
   time_t t = time(NULL);
   struct tm* gmtm = gmtime(&t);
@@ -89,19 +144,19 @@ void HcalPedestalAnalyzer::onProcessEnd() {
   fprintf(fout, "# Produced %s\n", times);
   fprintf(fout, "DetID,PEDESTAL_ADC,PEDESTAL_RMS_ADC\n");
 
-  for (auto ichan : pedestal_data_) {
-    if (ichan.second.entries == 0) {
-      std::cout << "All entries filtered for " << ichan.first << " for TOT "
-                << ichan.second.rejects[0] << " for TOA "
-                << ichan.second.rejects[1] << " for underthreshold "
-                << ichan.second.rejects[2] << " for overthreshold "
-                << ichan.second.rejects[3] << std::endl;
+  for (auto index : order) {
+    const Channel& chan{channels_[index]};
+    if (chan.entries == 0) {
+      std::cout << "All entries filtered for " << channel_ids_[index]
+                << " for TOT " << chan.rejects[0] << " for TOA "
+                << chan.rejects[1] << " for underthreshold " << chan.rejects[2]
+                << " for overthreshold " << chan.rejects[3] << std::endl;
       continue;  // all entries were filtered out
     }
 
-    double mean = ichan.second.sum * 1.0 / ichan.second.entries;
-    double rms = sqrt(ichan.second.sum_sq / ichan.second.entries - mean * mean);
-    fprintf(fout, "0x%08x,%9.3f,%9.3f\n", ichan.first.raw(), mean, rms);
+    double rms = sqrt(chan.m2 / chan.entries);
+    fprintf(fout, "0x%08x,%9.3f,%9.3f\n", channel_ids_[index].raw(),
+            chan.mean, rms);
   }
 
   fclose(fout);
@@ -1,8 +1,8 @@
 
 
 #include "Hcal/HcalRawDecoder.h"
-// un comment for HcalRawDecoder-specific debug printouts to std::cout
-//#define DEBUG
+
+#include <algorithm>
 
 namespace hcal {
 
@@ -33,21 +33,6 @@ class Reader {
 
 }  // namespace utility
 
-namespace debug {
-
-struct hex {
-  uint32_t word_;
-  hex(uint32_t w) : word_{w} {}
-};
-
-}  // namespace debug
-
-inline std::ostream& operator<<(std::ostream& os, const debug::hex& h) {
-  os << "0x" << std::setfill('0') << std::setw(8) << std::hex << h.word_
-     << std::dec;
-  return os;
-}
-
 /**
  * Struct to help interface between raw decoder read function
  * and putting stuff onto event bus
@@ -94,89 +79,95 @@ void HcalRawDecoder::beforeNewRun(ldmx::RunHeader& rh) {
 }
 
 void HcalRawDecoder::produce(framework::Event& event) {
-  std::map<ldmx::HcalElectronicsID,
-           std::vector<ldmx::HgcrocDigiCollection::Sample>>
-      eid_to_samples;
+  // clear the slots filled in the previous event
+  if (eid_slot_.empty())
+    eid_slot_.assign(ldmx::HcalElectronicsID::MAX_INDEX, -1);
+  for (auto index : eids_) eid_slot_[index] = -1;
+  eids_.clear();
+  samples_.clear();
+  sample_counts_.clear();
+
   PolarfireEventHeader eh;
   if (read_from_file_) {
     if (!file_reader_ or file_reader_.eof()) return;
-    eid_to_samples = this->read(file_reader_, eh);
+    this->read(file_reader_, eh);
   } else {
     for (const auto& name : input_names_) {
       hcal::utility::Reader bus_reader(
           event.getCollection<uint8_t>(name, input_pass_));
-      auto single_pf_samples = this->read(bus_reader, eh);
-      for (const auto& [id, samples] : single_pf_samples) {
-        eid_to_samples[id] = samples;
-      }
+      this->read(bus_reader, eh);
     }
   }
 
   eh.board(event, output_name_);
+  n_events_++;
 
   ldmx::HgcrocDigiCollection digis;
   // assume all channels have same number of samples
-  digis.setNumSamplesPerDigi(eid_to_samples.begin()->second.size());
+  digis.setNumSamplesPerDigi(n_samples_);
   digis.setSampleOfInterestIndex(0);  // TODO configurable
   digis.setVersion(roc_version_);
+  digis.reserve(eids_.size());
+
+  // digis are ordered by electronics ID
+  std::sort(eids_.begin(), eids_.end());
+
+  const HcalDetectorMap* detmap{nullptr};
   if (translate_eid_) {
-    /**
-     * Translation
-     *
-     * Now the HgcrocDigiCollection::Sample class handles the
-     * unpacking of individual samples; however, we still need
-     * to translate electronic IDs into detector IDs.
-     */
-#ifdef DEBUG
-    std::cout << "Translating EIDs into DetIDs. Printing skipped EIDs..."
-              << std::endl;
-#endif
-    auto detmap{
-        getCondition<HcalDetectorMap>(HcalDetectorMap::CONDITIONS_OBJECT_NAME)};
-    for (auto const& [eid, digi] : eid_to_samples) {
-      // The electronics map returns an empty ID of the correct
-      // type when the electronics ID is not found.
-      //  need to check if the electronics ID exists
-      //  TODO: do we want to end processing if this happens?
-      if (detmap.exists(eid)) {
-        uint32_t did_raw = detmap.get(eid).raw();
-        digis.addDigi(did_raw, digi);
-      } else {
-        /** DO NOTHING
-         *  skip hits where the EID aren't in the detector mapping
-         *  no zero supp during test beam on the front-end,
-         *  so channels that aren't connected to anything are still
-         *  being readout.
-         */
-#ifdef DEBUG
-        std::cout << "EID(" << eid.fiber() << "," << eid.elink() << ","
-                  << eid.channel() << ") ";
-        for (auto& s : digi) std::cout << debug::hex(s.raw()) << " ";
-        std::cout << std::endl;
-#endif
-      }
+    detmap = &getCondition<HcalDetectorMap>(
+        HcalDetectorMap::CONDITIONS_OBJECT_NAME);
+  }
+  for (auto index : eids_) {
+    int slot = eid_slot_[index];
+    if (sample_counts_[slot] != n_samples_) {
+      n_bad_length_++;
+      continue;
     }
-  } else {
-    /**
-     * no EID translation, just add the digis to the digi collection
-     * with their raw electronic ID
-     * TODO: remove this, we shouldn't be able to get past
-     *       the decoding stage without translating the EID
-     *       into a detector ID to avoid confusion in recon
-     */
-    for (auto const& [eid, digi] : eid_to_samples) {
-      digis.addDigi(eid.raw(), digi);
+    uint32_t id_raw;
+    if (translate_eid_) {
+      /**
+       * Translation
+       *
+       * Now the HgcrocDigiCollection::Sample class handles the
+       * unpacking of individual samples; however, we still need
+       * to translate electronic IDs into detector IDs.
+       *
+       * The electronics map has a raw ID of zero when the
+       * electronics ID is not found. We skip these hits since
+       * there is no zero supp during test beam on the front-end,
+       * so channels that aren't connected to anything are still
+       * being readout.
+       */
+      id_raw = detmap->getRaw(index);
+      if (id_raw == 0) {
+        n_unmapped_++;
+        continue;
+      }
+    } else {
+      /**
+       * no EID translation, just add the digis to the digi collection
+       * with their raw electronic ID
+       * TODO: remove this, we shouldn't be able to get past
+       *       the decoding stage without translating the EID
+       *       into a detector ID to avoid confusion in recon
+       */
+      id_raw = ldmx::HcalElectronicsID::idFromIndex(index).raw();
     }
+    digis.addRawDigi(id_raw, samples_.data() + slot * n_samples_);
   }
 
-#ifdef DEBUG
-  std::cout << "adding " << digis.getNumDigis() << " digis each with "
-            << digis.getNumSamplesPerDigi() << " samples to event bus"
-            << std::endl;
-#endif
+  n_digis_ += digis.getNumDigis();
   event.add(output_name_, digis);
   return;
 }  // produce
 
+void HcalRawDecoder::onProcessEnd() {
+  ldmx_log(info) << "Decoded " << n_events_ << " events into " << n_digis_
+                 << " digis";
+  ldmx_log(info) << "Skipped " << n_unmapped_
+                 << " channels not in the detector map and " << n_bad_length_
+                 << " channels with the wrong number of samples";
+}
+
 }  // namespace hcal
 DECLARE_PRODUCER_NS(hcal, HcalRawDecoder);
@@ -7,13 +7,63 @@
 
 #include "Hcal/HcalRecProducer.h"
 
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "Hcal/Event/HcalHit.h"
 #include "Hcal/HcalReconConditions.h"
 #include "Recon/Event/HgcrocDigiCollection.h"
 #include "SimCore/Event/SimCalorimeterHit.h"
+#include "TGraph.h"
 
 namespace hcal {
 
+namespace {
+
+/**
+ * Refine the interval between two points of the curve s -> (x(s), y(s))
+ * until the curve at the midpoint in s is within tolerance of the straight
+ * line between the end points, appending the points in order of s.
+ */
+template <typename Curve>
+void refineCurve(const Curve& curve, double s0, std::pair<double, double> p0,
+                 double s1, std::pair<double, double> p1, double tolerance,
+                 int depth, TGraph& graph) {
+  double s_mid = 0.5 * (s0 + s1);
+  auto p_mid = curve(s_mid);
+  double y_line = p0.second;
+  if (p1.first != p0.first)
+    y_line += (p_mid.first - p0.first) * (p1.second - p0.second) /
+              (p1.first - p0.first);
+  if (depth < 32 and fabs(p_mid.second - y_line) > tolerance) {
+    refineCurve(curve, s0, p0, s_mid, p_mid, tolerance, depth + 1, graph);
+    refineCurve(curve, s_mid, p_mid, s1, p1, tolerance, depth + 1, graph);
+  } else {
+    graph.SetPoint(graph.GetN(), p1.first, p1.second);
+  }
+}
+
+/**
+ * Sample the curve s -> (x(s), y(s)) into the graph starting from the
+ * input seeds in s and adaptively refining between them so that linear
+ * interpolation in the graph is within tolerance of the curve.
+ */
+template <typename Curve>
+void sampleCurve(const Curve& curve, const std::vector<double>& seeds,
+                 double tolerance, TGraph& graph) {
+  graph.Set(0);
+  auto p0 = curve(seeds.front());
+  graph.SetPoint(0, p0.first, p0.second);
+  for (std::size_t i{1}; i < seeds.size(); i++) {
+    auto p1 = curve(seeds[i]);
+    refineCurve(curve, seeds[i - 1], p0, seeds[i], p1, tolerance, 0, graph);
+    p0 = p1;
+  }
+}
+
+}  // namespace
+
 HcalRecProducer::HcalRecProducer(const std::string& name,
                                  framework::Process& process)
     : Producer(name, process) {}
@@ -35,52 +85,82 @@ void HcalRecProducer::configure(framework::config::Parameters& ps) {
   nADCs_ = ps.getParameter<int>("nADCs");
 
   // configuring corrections graphs derived on the fly
-  // TODO: maybe we should save these as a graph instead?
   rateUpSlope_ = ps.getParameter<double>("rateUpSlope");
   timeUpSlope_ = ps.getParameter<double>("timeUpSlope");
   rateDnSlope_ = ps.getParameter<double>("rateDnSlope");
   timeDnSlope_ = ps.getParameter<double>("timeDnSlope");
   timePeak_ = ps.getParameter<double>("timePeak");
-  pulseFunc_ =
-      TF1("pulseFunc",
-          "[0]*((1.0+exp([1]*(-[2]+[3])))*(1.0+exp([5]*(-[6]+[3]))))/"
-          "((1.0+exp([1]*(x-[2]+[3]-[4])))*(1.0+exp([5]*(x-[6]+[3]-[4]))))",
-          (double)nADCs_ * clock_cycle_ * -1, (double)nADCs_ * clock_cycle_);
-  pulseFunc_.FixParameter(1, rateUpSlope_);
-  pulseFunc_.FixParameter(2, timeUpSlope_);
-  pulseFunc_.FixParameter(3, timePeak_);
-  pulseFunc_.FixParameter(5, rateDnSlope_);
-  pulseFunc_.FixParameter(6, timeDnSlope_);
-  pulseFunc_.FixParameter(4, 0);
-  pulseFunc_.FixParameter(0, 1);
 
   // build amplitude correction (Ampl[t-1]/Ampl[t]) with pulse-shape
-  int n = 0;
-  for (double t = -clock_cycle_; t < clock_cycle_; t += 0.01) {
-    double ampl_t = pulseFunc_.Eval(t);
-    double ampl_tm1 = pulseFunc_.Eval(t - clock_cycle_);
-    if (ampl_tm1 > ampl_t) continue;
-    correctionAmpl_.SetPoint(n, ampl_tm1 / ampl_t, ampl_t);
-    if (n == 0) minAmplFraction_ = ampl_tm1 / ampl_t;
-    n++;
+  //  the ratio rises monotonically from t = -clock_cycle until the sample
+  //  before stops being smaller than the sample itself, just after the peak
+  double t_min{-clock_cycle_}, t_max{clock_cycle_};
+  auto rising = [&](double t) {
+    return pulseShape(t - clock_cycle_) <= pulseShape(t);
+  };
+  if (not rising(t_max)) {
+    double lo{t_min};
+    while (t_max - lo > 1e-6) {
+      double mid{0.5 * (lo + t_max)};
+      if (rising(mid))
+        lo = mid;
+      else
+        t_max = mid;
+    }
+    t_max = lo;
   }
+  std::vector<double> seeds;
+  for (int i{0}; i <= 64; i++)
+    seeds.push_back(t_min + i * (t_max - t_min) / 64);
+  TGraph curve;
+  sampleCurve(
+      [&](double t) {
+        double ampl_t = pulseShape(t);
+        return std::make_pair(pulseShape(t - clock_cycle_) / ampl_t, ampl_t);
+      },
+      seeds, 1e-5, curve);
+  curve.SetBit(TGraph::kIsSortedX);
+  minAmplFraction_ = curve.GetX()[0];
+  correctionAmpl_ = CorrectionTable(curve, 1024);
 
   // build TOA timewalk correction with pulse-shape
+  //  scaling the pulse by ampl, the threshold is crossed where the unit
+  //  pulse crosses toaThreshold/ampl so we only need to invert the rising edge
   double toaThreshold = ps.getParameter<double>("avgToaThreshold");
   double gain = ps.getParameter<double>("avgGain");
   double pedestal = ps.getParameter<double>("avgPedestal");
-  n = 0;
-  for (double ampl = toaThreshold + 0.1; ampl < 10000; ampl += 0.01) {
-    pulseFunc_.FixParameter(0, ampl);
-    double ampl_t = gain * pedestal + pulseFunc_.Eval(0);
-    double toa =
-        fabs(pulseFunc_.GetX(toaThreshold, (double)nADCs_ * clock_cycle_ * -1,
-                             (double)nADCs_ * clock_cycle_));
-    correctionTOA_.SetPoint(n, ampl_t, toa);
-    if (n == 0) minAmpl_ = ampl_t;
-    n++;
+  double ampl_min{toaThreshold + 0.1}, ampl_max{10000.};
+  seeds.clear();
+  for (int i{0}; i <= 32; i++)
+    seeds.push_back(ampl_min * std::pow(ampl_max / ampl_min, i / 32.));
+  sampleCurve(
+      [&](double ampl) {
+        return std::make_pair(gain * pedestal + ampl,
+                              fabs(pulseRiseTime(toaThreshold / ampl)));
+      },
+      seeds, 1e-4, curve);
+  curve.SetBit(TGraph::kIsSortedX);
+  minAmpl_ = curve.GetX()[0];
+  correctionTOA_ = CorrectionTable(curve, 4096, true);
+}
+
+double HcalRecProducer::pulseShape(double t) const {
+  return ((1.0 + exp(rateUpSlope_ * (-timeUpSlope_ + timePeak_))) *
+          (1.0 + exp(rateDnSlope_ * (-timeDnSlope_ + timePeak_)))) /
+         ((1.0 + exp(rateUpSlope_ * (t - timeUpSlope_ + timePeak_))) *
+          (1.0 + exp(rateDnSlope_ * (t - timeDnSlope_ + timePeak_))));
+}
+
+double HcalRecProducer::pulseRiseTime(double fraction) const {
+  double lo{-nADCs_ * clock_cycle_}, hi{0.};
+  while (hi - lo > 1e-9) {
+    double mid{0.5 * (lo + hi)};
+    if (pulseShape(mid) < fraction)
+      lo = mid;
+    else
+      hi = mid;
   }
-  correctionTOA_.SetBit(TGraph::kIsSortedX);
+  return 0.5 * (lo + hi);
 }
 
 double HcalRecProducer::getTOA(
@@ -122,7 +202,7 @@ void HcalRecProducer::produce(framework::Event& event) {
       getCondition<HcalReconConditions>(HcalReconConditions::CONDITIONS_NAME)};
 
   std::vector<ldmx::HcalHit> hcalRecHits;
-  auto hcalDigis =
+  const auto& hcalDigis =
       event.getObject<ldmx::HgcrocDigiCollection>(digiCollName_, digiPassName_);
   int numDigiHits = hcalDigis.getNumDigis();
 
@@ -139,7 +219,7 @@ void HcalRecProducer::produce(framework::Event& event) {
     ldmx::HcalID id(id_posend.section(), id_posend.layer(), id_posend.strip());
 
     // position from ID
-    auto position = hcalGeometry.getStripCenterPosition(id);
+    auto position = hcalGeometry.getStripCenter(id);
     double half_total_width =
         hcalGeometry.getHalfTotalWidth(id.section(), id.layer());
     double ecal_dx = hcalGeometry.getEcalDx();
@@ -199,8 +279,8 @@ void HcalRecProducer::produce(framework::Event& event) {
         // above the boundary of the correction)
         if (amplTm1_posend / amplT_posend > minAmplFraction_ &&
             amplTm1_negend / amplT_negend > minAmplFraction_) {
-          amplT_posend *= correctionAmpl_.Eval(amplTm1_posend / amplT_posend);
-          amplT_negend *= correctionAmpl_.Eval(amplTm1_negend / amplT_negend);
+          amplT_posend *= correctionAmpl_.eval(amplTm1_posend / amplT_posend);
+          amplT_negend *= correctionAmpl_.eval(amplTm1_negend / amplT_negend);
         }
 
         // set voltage
@@ -222,8 +302,8 @@ void HcalRecProducer::produce(framework::Event& event) {
       // correction otherwise, one TOA gets corrected and the other does not,
       // which results in a large TOA difference and an out-of-bounds position
       if (amplT_posend > minAmpl_ && amplT_negend > minAmpl_) {
-        TOA_posend = correctionTOA_.Eval(amplT_posend) - TOA_posend;
-        TOA_negend = correctionTOA_.Eval(amplT_negend) - TOA_negend;
+        TOA_posend = correctionTOA_.eval(amplT_posend) - TOA_posend;
+        TOA_negend = correctionTOA_.eval(amplT_negend) - TOA_negend;
       }
 
       // get x(y) coordinate from TOA measurement = (dt*v/2)
@@ -254,9 +334,9 @@ void HcalRecProducer::produce(framework::Event& event) {
       // set position along the bar
       if (orientation ==
           ldmx::HcalGeometry::ScintillatorOrientation::horizontal) {
-        position.SetX(position_bar);
+        position[0] = position_bar;
       } else {
-        position.SetY(position_bar);
+        position[1] = position_bar;
       }
 
       // set hit time
@@ -310,7 +390,7 @@ void HcalRecProducer::produce(framework::Event& event) {
           getTOA(digi_posend, the_conditions.adcPedestal(id_posend), iSOI);
 
       // correct TOA
-      TOA = correctionTOA_.Eval(amplT) - TOA;
+      TOA = correctionTOA_.eval(amplT) - TOA;
 
       // set hit time
       hitTime = TOA;  // ns
@@ -347,9 +427,9 @@ void HcalRecProducer::produce(framework::Event& event) {
     // copy over information to rec hit structure in new collection
     ldmx::HcalHit recHit;
     recHit.setID(id.raw());
-    recHit.setXPos(position.X());
-    recHit.setYPos(position.Y());
-    recHit.setZPos(position.Z());
+    recHit.setXPos(position[0]);
+    recHit.setYPos(position[1]);
+    recHit.setZPos(position[2]);
     recHit.setSection(id.section());
     recHit.setStrip(id.strip());
     recHit.setLayer(id.layer());
@@ -364,7 +444,7 @@ void HcalRecProducer::produce(framework::Event& event) {
   if (event.exists(simHitCollName_, simHitPassName_)) {
     // hcal sim hits exist ==> label which hits are real and which are pure
     // noise
-    auto hcalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
+    const auto& hcalSimHits{event.getCollection<ldmx::SimCalorimeterHit>(
         simHitCollName_, simHitPassName_)};
     std::set<int> real_hits;
     for (auto const& sim_hit : hcalSimHits) real_hits.insert(sim_hit.getID());
@@ -73,7 +73,7 @@ void HcalSingleEndRecProducer::produce(framework::Event& event) {
   const auto& conditions{
       getCondition<HcalReconConditions>(HcalReconConditions::CONDITIONS_NAME)};
 
-  auto hcalDigis =
+  const auto& hcalDigis =
       event.getObject<ldmx::HgcrocDigiCollection>(coll_name_, pass_name_);
 
   std::vector<ldmx::HcalHit> hcalRecHits;
@@ -105,14 +105,14 @@ void HcalSingleEndRecProducer::produce(framework::Event& event) {
     double hitTime = toa;
 
     // position single ended (taken directly from geometry)
-    auto position = hcalGeometry.getStripCenterPosition(id);
+    const auto& position = hcalGeometry.getStripCenter(id);
 
     // reconstructed Hit
     ldmx::HcalHit recHit;
     recHit.setID(id.raw());
-    recHit.setXPos(position.X());
-    recHit.setYPos(position.Y());
-    recHit.setZPos(position.Z());
+    recHit.setXPos(position[0]);
+    recHit.setYPos(position[1]);
+    recHit.setZPos(position[2]);
     recHit.setSection(id.section());
     recHit.setStrip(id.strip());
     recHit.setLayer(id.layer());
@@ -13,10 +13,10 @@ WorkingCluster::WorkingCluster(const ldmx::HcalHit* eh,
 void WorkingCluster::add(const ldmx::HcalHit* eh,
                          const ldmx::HcalGeometry& hex) {
   double hitE = eh->getEnergy();
-  TVector3 hitpos = hex.getStripCenterPosition(eh->getID());
-  double hitX = hitpos.x();
-  double hitY = hitpos.y();
-  double hitZ = hitpos.z();
+  const auto& hitpos = hex.getStripCenter(eh->getID());
+  double hitX = hitpos[0];
+  double hitY = hitpos[1];
+  double hitZ = hitpos[2];
   double hitT = eh->getTime();
   // Based on weight for  Center-of-Gravity by hitpos*hiE/totalE
   double newE = hitE + centroid_.E();
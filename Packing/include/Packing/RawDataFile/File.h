@@ -1,10 +1,13 @@
 #ifndef PACKING_RAWDATAFILE_FILE_H_
 #define PACKING_RAWDATAFILE_FILE_H_
 
+#include <memory>
+
 #include "Framework/Configure/Parameters.h"
 #include "Framework/Event.h"
 #include "Framework/RunHeader.h"
 #include "Packing/RawDataFile/EventPacket.h"
+#include "Packing/RawDataFile/MappedFile.h"
 #include "Packing/Utility/Reader.h"
 #include "Packing/Utility/Writer.h"
 
@@ -34,6 +37,18 @@ class File {
    */
   bool nextEvent();
 
+  /**
+   * Move to the input entry, so it is the one loaded by the next call
+   * to nextEvent.
+   *
+   * When the input file is memory mapped, this is a constant time jump.
+   * Otherwise, we have to decode all of the event packets in between.
+   *
+   * @param[in] entry index of the entry to go to
+   * @return false if there is no such entry in the file
+   */
+  bool seek(uint32_t entry);
+
   /**
    * Write the run header
    */
@@ -63,12 +78,18 @@ class File {
   uint32_t entries_{0};
   /// current entry index (may not be same as event number)
   uint32_t i_entry_{0};
+  /// one past the last entry to read
+  uint32_t end_entry_{0};
   /// handle to the event bus we are reading from or writing to
   framework::Event* event_{nullptr};
   /// run number corresponding to this file of raw data
   uint32_t run_;
   /// utility class for reading binary data files
   utility::Reader reader_;
+  /// memory mapped input file, used instead of reader_ if set
+  std::unique_ptr<MappedFile> mapped_;
+  /// event packet decoded by reader_
+  EventPacket read_event_;
   /// utility class for writing binary data files
   utility::Writer writer_;
   /// crc calculator for output mode
@@ -0,0 +1,152 @@
+#ifndef PACKING_RAWDATAFILE_MAPPEDFILE_H_
+#define PACKING_RAWDATAFILE_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace packing {
+namespace rawdatafile {
+
+/**
+ * @class MappedFile
+ * Random access to the events of a raw data file.
+ *
+ * The whole file is memory mapped and an index holding the position of
+ * every event packet and of every subsystem packet within it is built
+ * once when the file is opened. Any event can then be reached directly,
+ * skipping events costs nothing and several readers can each take their
+ * own range of entries from the same file. The payloads are handed out as
+ * views into the mapping so nothing is copied until the caller asks for it.
+ *
+ * Building the index means walking the headers of all packets in the
+ * file, so the index can be written to a sidecar file in the cache
+ * directory of framework::FileCache and loaded from there the next time
+ * the file is opened. The sidecar records the size and modification time
+ * of the raw file it was built from and is rebuilt if they do not match
+ * or if it is damaged.
+ *
+ * All const methods can be called from several threads at once.
+ */
+class MappedFile {
+ public:
+  /**
+   * The data words of a single subsystem packet
+   *
+   * This is a view into the mapped file and is only valid as long as the
+   * MappedFile it came from.
+   */
+  class Payload {
+   public:
+    Payload(uint16_t id, const uint32_t* data, std::size_t size)
+        : id_{id}, data_{data}, size_{size} {}
+    /// electronics ID of the subsystem
+    uint16_t id() const { return id_; }
+    /// pointer to the first data word
+    const uint32_t* data() const { return data_; }
+    /// number of data words
+    std::size_t size() const { return size_; }
+    const uint32_t* begin() const { return data_; }
+    const uint32_t* end() const { return data_ + size_; }
+
+   private:
+    uint16_t id_;
+    const uint32_t* data_;
+    std::size_t size_;
+  };  // Payload
+
+  /**
+   * Map the input file and index its events
+   *
+   * @throws Exception if the file cannot be mapped or is not a valid
+   * raw data file
+   *
+   * @param[in] filename path to the raw data file
+   * @param[in] index_file path to the sidecar index file, no sidecar is
+   * used if it is empty
+   */
+  MappedFile(const std::string& filename, const std::string& index_file = "");
+
+  /// unmap the file
+  ~MappedFile();
+
+  /**
+   * Default path of the sidecar index file of a raw data file
+   *
+   * @param[in] filename path to the raw data file
+   * @return path in the cache directory, empty if there is no cache
+   * directory
+   */
+  static std::string indexPath(const std::string& filename);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// run number from the file header
+  uint32_t run() const { return run_; }
+
+  /// number of events in the file
+  std::size_t entries() const { return event_offsets_.size() - 1; }
+
+  /// event number of the input entry
+  uint32_t eventID(std::size_t entry) const {
+    return words_[event_offsets_[entry]];
+  }
+
+  /// number of subsystem packets in the input entry
+  std::size_t nSubsystems(std::size_t entry) const {
+    return subsys_begin_[entry + 1] - subsys_begin_[entry];
+  }
+
+  /// payload of the i'th subsystem packet in the input entry
+  Payload subsystem(std::size_t entry, std::size_t i) const;
+
+  /// all words of the file
+  const uint32_t* words() const { return words_; }
+
+  /// number of words in the file
+  std::size_t size() const { return n_words_; }
+
+  /// checksum stored at the end of the file
+  uint32_t crc() const { return words_[n_words_ - 1]; }
+
+  /// whether the index was loaded from the sidecar file
+  bool indexFromFile() const { return index_from_file_; }
+
+ private:
+  /// walk the packet headers to fill the index
+  void buildIndex(const std::string& filename);
+
+  /// load the index from the sidecar file, false if it is not usable
+  bool readIndex(const std::string& index_file, uint64_t source_size,
+                 int64_t source_mtime);
+
+  /// write the index to the sidecar file, false on failure
+  bool writeIndex(const std::string& index_file, uint64_t source_size,
+                  int64_t source_mtime) const;
+
+  /// start of the mapping
+  void* mapping_{nullptr};
+  /// length of the mapping in bytes
+  std::size_t mapping_size_{0};
+  /// the mapped file as words
+  const uint32_t* words_{nullptr};
+  /// number of words in the file
+  std::size_t n_words_{0};
+  /// run number from the file header
+  uint32_t run_{0};
+  /// word offset of each event packet, one more than entries for the trailer
+  std::vector<uint64_t> event_offsets_;
+  /// first subsystem of each event in subsys_offsets_, one more than entries
+  std::vector<uint64_t> subsys_begin_;
+  /// word offset of each subsystem packet of all events
+  std::vector<uint64_t> subsys_offsets_;
+  /// whether the index was loaded from the sidecar file
+  bool index_from_file_{false};
+};  // MappedFile
+
+}  // namespace rawdatafile
+}  // namespace packing
+
+#endif  // PACKING_RAWDATAFILE_MAPPEDFILE_H_
@@ -1,17 +1,90 @@
 #ifndef PACKING_UTILITY_CRC_H_
 #define PACKING_UTILITY_CRC_H_
 
-#include <boost/crc.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace packing {
 namespace utility {
 
+namespace crc {
+
+/// number of bytes processed per step of the slicing algorithm
+constexpr std::size_t SLICES = 8;
+
+/// the CRC-32 polynomial in reflected bit order
+constexpr uint32_t POLYNOMIAL = 0xEDB88320;
+
+/// lookup tables for the slicing algorithm
+using Tables = std::array<std::array<uint32_t, 256>, SLICES>;
+
+/**
+ * Build the lookup tables for the slicing algorithm
+ *
+ * The first table is the usual byte-wise CRC table, table s gives the
+ * contribution of a byte that still has s more bytes following it within
+ * the same step.
+ */
+constexpr Tables makeTables() {
+  Tables t{};
+  for (uint32_t i{0}; i < 256; i++) {
+    uint32_t c = i;
+    for (int k{0}; k < 8; k++) c = (c & 1) ? (c >> 1) ^ POLYNOMIAL : c >> 1;
+    t[0][i] = c;
+  }
+  for (uint32_t i{0}; i < 256; i++) {
+    for (std::size_t s{1}; s < SLICES; s++) {
+      t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xff];
+    }
+  }
+  return t;
+}
+
+/// tables shared by all calculators, computed at compile time
+inline constexpr Tables TABLES = makeTables();
+
+/// load four bytes as a little endian word, independent of the host
+inline uint32_t load(const unsigned char* p) {
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) |
+         (uint32_t(p[3]) << 24);
+}
+
+/// multiply the 32x32 GF(2) matrix by the vector
+inline uint32_t gf2Times(const std::array<uint32_t, 32>& mat, uint32_t vec) {
+  uint32_t sum{0};
+  for (std::size_t i{0}; vec; vec >>= 1, i++) {
+    if (vec & 1) sum ^= mat[i];
+  }
+  return sum;
+}
+
+/// square the 32x32 GF(2) matrix
+inline std::array<uint32_t, 32> gf2Square(const std::array<uint32_t, 32>& mat) {
+  std::array<uint32_t, 32> square;
+  for (std::size_t i{0}; i < 32; i++) square[i] = gf2Times(mat, mat[i]);
+  return square;
+}
+
+}  // namespace crc
+
 /**
  * @class CRC
  *
  * The HGC ROC and FPGA use a CRC checksum to double check that the
- * data transfer has been done correctly. Boost has a CRC checksum
- * library that we can use to do this checking here as well.
+ * data transfer has been done correctly. We calculate the same standard
+ * CRC-32 as boost::crc_32_type here, but with the slice-by-8 algorithm
+ * processing eight bytes per table lookup step, so that whole buffers
+ * can be checksummed at memory speed. Vectors of integral words are
+ * processed as one contiguous block.
+ *
+ * The checksums of consecutive blocks can be combined into the checksum
+ * of the whole, which allows checksumming large buffers in parallel.
+ * @see checksum
  *
  * Idea for this helper struct was found on StackOverflow
  * https://stackoverflow.com/a/63237679
@@ -63,8 +136,7 @@ class CRC {
   template <typename WordType,
             std::enable_if_t<std::is_integral<WordType>::value, bool> = true>
   CRC& operator<<(const WordType& w) {
-    crc.process_bytes(&w, sizeof(WordType));
-    return *this;
+    return process(&w, sizeof(WordType));
   }
 
   /**
@@ -92,14 +164,43 @@ class CRC {
    *
    * When the compiler deduces that the input to the stream is a vector,
    * we simply call the stream operator on all members of the vector in
-   * sequence.
+   * sequence. Vectors of integral words are contiguous in memory and
+   * are processed in one go instead.
    *
    * @param[in] vec vector of objects to insert into calculator
    * @return CRC modified calculator
    */
   template <typename ContentType>
   CRC& operator<<(const std::vector<ContentType>& vec) {
-    for (auto const& w : vec) *this << w;
+    if constexpr (std::is_integral<ContentType>::value and
+                  not std::is_same<ContentType, bool>::value) {
+      return process(vec.data(), vec.size() * sizeof(ContentType));
+    } else {
+      for (auto const& w : vec) *this << w;
+      return *this;
+    }
+  }
+
+  /**
+   * Insert a contiguous block of bytes into the calculator
+   *
+   * @param[in] data pointer to the first byte
+   * @param[in] len number of bytes
+   * @return CRC modified calculator
+   */
+  CRC& process(const void* data, std::size_t len) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    const auto& t = crc::TABLES;
+    uint32_t c = state_;
+    for (; len >= crc::SLICES; len -= crc::SLICES, p += crc::SLICES) {
+      uint32_t one = crc::load(p) ^ c;
+      uint32_t two = crc::load(p + 4);
+      c = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^
+          t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^ t[3][two & 0xff] ^
+          t[2][(two >> 8) & 0xff] ^ t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+    }
+    for (; len > 0; len--, p++) c = (c >> 8) ^ t[0][(c ^ *p) & 0xff];
+    state_ = c;
     return *this;
   }
 
@@ -107,11 +208,88 @@ class CRC {
    * Get the calculate checksum from the calculator
    * @return uint32_t checksum
    */
-  uint32_t get() { return crc.checksum(); }
+  uint32_t get() const { return state_ ^ 0xFFFFFFFF; }
+
+  /**
+   * Combine the checksums of two consecutive blocks
+   *
+   * This is the method used by zlib, which applies the effect of len2
+   * zero bytes onto crc1 with repeated squaring of the GF(2) matrix of
+   * the CRC shift, so it only takes log(len2) steps.
+   *
+   * @param[in] crc1 checksum of the first block
+   * @param[in] crc2 checksum of the second block
+   * @param[in] len2 length of the second block in bytes
+   * @return uint32_t checksum of the two blocks one after the other
+   */
+  static uint32_t combine(uint32_t crc1, uint32_t crc2, std::size_t len2) {
+    if (len2 == 0) return crc1;
+
+    // operator for a single zero bit
+    std::array<uint32_t, 32> odd;
+    odd[0] = crc::POLYNOMIAL;
+    for (std::size_t i{1}; i < 32; i++) odd[i] = 1u << (i - 1);
+    // operators for two and four zero bits
+    auto even = crc::gf2Square(odd);
+    odd = crc::gf2Square(even);
+
+    // apply len2 zero bytes to crc1, starting with one byte
+    do {
+      even = crc::gf2Square(odd);
+      if (len2 & 1) crc1 = crc::gf2Times(even, crc1);
+      len2 >>= 1;
+      if (len2 == 0) break;
+      odd = crc::gf2Square(even);
+      if (len2 & 1) crc1 = crc::gf2Times(odd, crc1);
+      len2 >>= 1;
+    } while (len2 != 0);
+
+    return crc1 ^ crc2;
+  }
+
+  /**
+   * Checksum a contiguous block of bytes using several threads
+   *
+   * The block is split into one segment per thread, the segments are
+   * checksummed at the same time and the results are combined.
+   *
+   * @param[in] data pointer to the first byte
+   * @param[in] len number of bytes
+   * @param[in] n_threads number of threads to use
+   * @return uint32_t checksum of the block
+   */
+  static uint32_t checksum(const void* data, std::size_t len,
+                           unsigned int n_threads = 1) {
+    // not worth starting threads for less than a few MB per thread
+    constexpr std::size_t min_segment{1 << 22};
+    std::size_t n_segments = std::min<std::size_t>(
+        std::max(n_threads, 1u), std::max<std::size_t>(len / min_segment, 1));
+    if (n_segments == 1) return CRC().process(data, len).get();
+
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::size_t segment = len / n_segments;
+    std::vector<uint32_t> sums(n_segments);
+    std::vector<std::thread> workers;
+    for (std::size_t i{1}; i < n_segments; i++) {
+      std::size_t n = i + 1 < n_segments ? segment : len - i * segment;
+      workers.emplace_back([&sums, i, n, begin = p + i * segment]() {
+        sums[i] = CRC().process(begin, n).get();
+      });
+    }
+    sums[0] = CRC().process(p, segment).get();
+    for (auto& w : workers) w.join();
+
+    uint32_t sum = sums[0];
+    for (std::size_t i{1}; i < n_segments; i++) {
+      std::size_t n = i + 1 < n_segments ? segment : len - i * segment;
+      sum = combine(sum, sums[i], n);
+    }
+    return sum;
+  }
 
  private:
-  /// the object from Boost doing the summing
-  boost::crc_32_type crc;
+  /// the running CRC register, kept inverted as in the standard algorithm
+  uint32_t state_{0xFFFFFFFF};
 };  // CRC
 
 }  // namespace utility
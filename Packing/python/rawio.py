@@ -4,7 +4,29 @@ from LDMX.Framework import ldmxcfg
 import os
 
 class RawDataFile() :
-    """RawDataFile configuration class"""
+    """RawDataFile configuration class
+
+    Parameters
+    ----------
+    verify_checksum : bool
+        Check the checksum of the entire input file when opening it
+    checksum_threads : int
+        Number of threads checksumming segments of the input file at
+        the same time, only with memory_map
+    memory_map : bool
+        Map the input file into memory and index its events, so entries
+        can be reached directly instead of decoding the file in order
+    use_index_file : bool
+        With memory_map, keep the index of the events in the user cache
+        directory (LDMX_CACHE_DIR, $XDG_CACHE_HOME/ldmx or ~/.cache/ldmx)
+        and load it from there when the input has not changed
+    first_entry : int
+        Index of the first entry of the input file to read
+    max_entries : int
+        Maximum number of entries of the input file to read, negative
+        to read all of them. With first_entry, this splits a file
+        between several jobs.
+    """
 
     def __init__(self, name, is_output) :
         self.filename = name
@@ -15,6 +37,12 @@ class RawDataFile() :
         self.triggerpad_object_name = "TriggerPadRaw"
         self.pass_name = ""
         self.skip_unavailable = True
+        self.verify_checksum = False
+        self.checksum_threads = 1
+        self.memory_map = False
+        self.use_index_file = True
+        self.first_entry = 0
+        self.max_entries = -1
 
 class RawIO(ldmxcfg.Producer) :
     """Producer which runs a single raw data file for input/output
@@ -1,6 +1,8 @@
 
 #include "Packing/RawDataFile/File.h"
 
+#include <algorithm>
+
 #include "DetDescr/DetectorID.h"
 #include "Packing/Utility/CRC.h"
 #include "Packing/Utility/Mask.h"
@@ -27,6 +29,27 @@ File::File(const framework::config::Parameters &ps) {
     // leave entry count undefined
     entries_ = 0;
     i_entry_ = 0;
+  } else if (ps.getParameter<bool>("memory_map", false)) {
+    // the index of the file is kept in the cache directory to save walking
+    // through the file the next time it is read
+    std::string index_file;
+    if (ps.getParameter<bool>("use_index_file", true))
+      index_file = MappedFile::indexPath(fn);
+    mapped_ = std::make_unique<MappedFile>(fn, index_file);
+    run_ = mapped_->run();
+    entries_ = mapped_->entries();
+    i_entry_ = 0;
+
+    if (ps.getParameter<bool>("verify_checksum")) {
+      // the checksum covers every word before it, like when writing
+      auto crc = utility::CRC::checksum(
+          mapped_->words(), (mapped_->size() - 1) * sizeof(uint32_t),
+          ps.getParameter<int>("checksum_threads", 1));
+      if (crc != mapped_->crc()) {
+        EXCEPTION_RAISE("CRCNotOk",
+                        "Failure to verify CRC checksum of entire input file.");
+      }
+    }  // verify checksum of input file
   } else {
     reader_.open(fn);
     // get entry count from file
@@ -52,13 +75,19 @@ File::File(const framework::config::Parameters &ps) {
     reader_.seek<uint32_t>(1, std::ios::beg);
 
     if (ps.getParameter<bool>("verify_checksum")) {
+      // the checksum covers every word before it, like when writing,
+      // read the file in large blocks rather than word by word
+      reader_.seek<uint32_t>(0, std::ios::beg);
       utility::CRC crc;
-      for (auto ifile{reader_.tell<uint32_t>()}; ifile < eof; ifile++) {
-        reader_ >> word;
-        crc << word;
+      std::vector<uint32_t> block(1 << 18);
+      for (std::size_t left = eof + 1; left > 0 and reader_;) {
+        std::size_t n = std::min(left, block.size());
+        reader_.read(block.data(), n);
+        crc.process(block.data(), n * sizeof(uint32_t));
+        left -= n;
       }
 
-      if (crc.get() != crc_read_in) {
+      if (!reader_ or crc.get() != crc_read_in) {
         EXCEPTION_RAISE("CRCNotOk",
                         "Failure to verify CRC checksum of entire input file.");
       }
@@ -66,6 +95,22 @@ File::File(const framework::config::Parameters &ps) {
       reader_.seek<uint32_t>(1, std::ios::beg);
     }  // verify checksum of input file
   }    // input or output file
+
+  if (not is_output_) {
+    // only read a range of the entries, e.g. to split a file across jobs
+    auto first_entry = ps.getParameter<int>("first_entry", 0);
+    auto max_entries = ps.getParameter<int>("max_entries", -1);
+    if (first_entry < 0 or not seek(first_entry)) {
+      EXCEPTION_RAISE("RawFileEntry",
+                      "Unable to go to entry " + std::to_string(first_entry) +
+                          " of raw file with " + std::to_string(entries_) +
+                          " entries.");
+    }
+    // first_entry is at most entries_ here, so this can't overflow
+    end_entry_ = entries_;
+    if (max_entries >= 0 and uint32_t(max_entries) < entries_ - first_entry)
+      end_entry_ = uint32_t(first_entry) + uint32_t(max_entries);
+  }
 }
 
 bool File::connect(framework::Event &event) {
@@ -98,34 +143,67 @@ bool File::nextEvent() {
     i_entry_++;
   } else {
     // check for EoF
-    if (i_entry_ + 1 > entries_) return false;
+    if (i_entry_ + 1 > end_entry_) return false;
+
+    auto object_name = [](uint16_t id) -> const std::string & {
+      // construct name if not provided by default EID mappings
+      if (eid_to_name.find(id) == eid_to_name.end()) {
+        std::cerr << id << " unrecognized electronics ID." << std::endl;
+        eid_to_name[id] = "EID" + std::to_string(id);
+      }
+      return eid_to_name.at(id);
+    };
+
+    if (mapped_) {
+      // take the packets straight out of the mapped file
+      event_->getEventHeader().setEventNumber(mapped_->eventID(i_entry_));
+      for (std::size_t i{0}; i < mapped_->nSubsystems(i_entry_); i++) {
+        auto payload = mapped_->subsystem(i_entry_, i);
+        std::vector<uint32_t> data(payload.begin(), payload.end());
+        event_->add(object_name(payload.id()), data);
+      }  // loop over subsystems
+
+      i_entry_++;
+      return true;
+    }
 
     i_entry_++;
 
     // read buffers from event packet and add to event bus
-    static EventPacket read_event;
-    reader_ >> read_event;
+    reader_ >> read_event_;
     if (!reader_) {
       // ERROR
       return false;
     }
 
-    event_->getEventHeader().setEventNumber(read_event.id());
-
-    for (auto &subsys : read_event.data()) {
-      // construct name if not provided by default EID mappings
-      if (eid_to_name.find(subsys.id()) == eid_to_name.end()) {
-        std::cerr << subsys.id() << " unrecognized electronics ID."
-                  << std::endl;
-        eid_to_name[subsys.id()] = "EID" + std::to_string(subsys.id());
-      }
+    event_->getEventHeader().setEventNumber(read_event_.id());
 
-      event_->add(eid_to_name.at(subsys.id()), subsys.data());
+    for (auto &subsys : read_event_.data()) {
+      event_->add(object_name(subsys.id()), subsys.data());
     }  // loop over subsystems
   }    // input or output
   return true;
 }
 
+bool File::seek(uint32_t entry) {
+  if (is_output_ or entry > entries_) return false;
+
+  if (mapped_) {
+    i_entry_ = entry;
+    return true;
+  }
+
+  // the stream can only move forward by decoding the events
+  if (entry < i_entry_) {
+    reader_.seek<uint32_t>(1, std::ios::beg);
+    i_entry_ = 0;
+  }
+  for (; i_entry_ < entry; i_entry_++) {
+    if (!(reader_ >> read_event_)) return false;
+  }
+  return true;
+}
+
 void File::writeRunHeader(ldmx::RunHeader &header) {
   if (is_output_) {
     // use passed run number
@@ -0,0 +1,253 @@
+#include "Packing/RawDataFile/MappedFile.h"
+
+#include <cstring>
+#include <fstream>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Framework/Exception/Exception.h"
+#include "Framework/FileCache.h"
+#include "Packing/Utility/Mask.h"
+
+namespace packing {
+namespace rawdatafile {
+
+namespace {
+
+/// Identifies a raw data file index
+constexpr char INDEX_MAGIC[8] = {'L', 'D', 'M', 'X', 'R', 'I', 'D', 'X'};
+
+/// Version of the index layout, indices of other versions are rebuilt
+constexpr uint32_t INDEX_VERSION = 1;
+
+/**
+ * Header at the start of an index file, followed by the event offsets,
+ * the first subsystem of each event and the subsystem offsets, all as
+ * 64-bit words.
+ */
+struct IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint64_t entries;
+  uint64_t subsystems;
+};
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& filename,
+                       const std::string& index_file) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    EXCEPTION_RAISE("FileDNE",
+                    "The raw data file '" + filename + "' does not exist!");
+  }
+  struct stat source;
+  if (fstat(fd, &source) != 0) {
+    ::close(fd);
+    EXCEPTION_RAISE("FileDNE", "Unable to stat raw data file '" + filename +
+                                   "'.");
+  }
+  mapping_size_ = source.st_size;
+  // header word, entry count and checksum at the very least
+  if (mapping_size_ % sizeof(uint32_t) != 0 or
+      mapping_size_ < 3 * sizeof(uint32_t)) {
+    ::close(fd);
+    EXCEPTION_RAISE("RawFileSize", "The raw data file '" + filename +
+                                       "' is not a whole number of words.");
+  }
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    EXCEPTION_RAISE("RawFileMap",
+                    "Unable to memory map raw data file '" + filename + "'.");
+  }
+  words_ = static_cast<const uint32_t*>(mapping_);
+  n_words_ = mapping_size_ / sizeof(uint32_t);
+
+  // the destructor is not called if we throw from here on
+  try {
+    uint8_t version = words_[0] & utility::mask<4>;
+    if (version != 0) {
+      EXCEPTION_RAISE("RawFileVers", "Unable to handle raw file version " +
+                                         std::to_string(version));
+    }
+    run_ = (words_[0] >> 4) & utility::mask<28>;
+
+    uint64_t source_size = source.st_size;
+    int64_t source_mtime =
+        source.st_mtim.tv_sec * 1000000000ll + source.st_mtim.tv_nsec;
+    if (not index_file.empty() and
+        readIndex(index_file, source_size, source_mtime)) {
+      index_from_file_ = true;
+      return;
+    }
+
+    buildIndex(filename);
+    // the sidecar is only an optimization and FileCache warns if it can't
+    // be written, so carry on either way
+    if (not index_file.empty())
+      writeIndex(index_file, source_size, source_mtime);
+  } catch (...) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    throw;
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (mapping_) munmap(mapping_, mapping_size_);
+}
+
+std::string MappedFile::indexPath(const std::string& filename) {
+  return framework::FileCache::path(filename, ".idx");
+}
+
+MappedFile::Payload MappedFile::subsystem(std::size_t entry,
+                                          std::size_t i) const {
+  uint64_t i_subsys = subsys_begin_[entry] + i;
+  uint64_t pos = subsys_offsets_[i_subsys];
+  // the next packet starts after the checksum, the event checksum follows
+  // the last subsystem packet of the event
+  uint64_t next = i_subsys + 1 < subsys_begin_[entry + 1]
+                      ? subsys_offsets_[i_subsys + 1]
+                      : event_offsets_[entry + 1] - 1;
+  uint16_t id = (words_[pos] >> 16) & utility::mask<16>;
+  // skip the header word and the event number
+  return Payload(id, words_ + pos + 2, next - pos - 3);
+}
+
+void MappedFile::buildIndex(const std::string& filename) {
+  const uint64_t trailer = n_words_ - 2;
+  const uint32_t entries = words_[trailer];
+
+  event_offsets_.clear();
+  subsys_begin_.clear();
+  subsys_offsets_.clear();
+  event_offsets_.reserve(entries + 1);
+  subsys_begin_.reserve(entries + 1);
+
+  auto corrupt = [&](uint32_t entry) {
+    EXCEPTION_RAISE("RawFileIndex",
+                    "Event packet " + std::to_string(entry) +
+                        " runs past the end of raw data file '" + filename +
+                        "', the file is truncated or corrupted.");
+  };
+
+  // the event length in the event header is too narrow for large events,
+  // so we walk the subsystem headers instead
+  uint64_t pos{1};
+  for (uint32_t entry{0}; entry < entries; entry++) {
+    // event number and event header word
+    if (pos + 2 > trailer) corrupt(entry);
+    event_offsets_.push_back(pos);
+    subsys_begin_.push_back(subsys_offsets_.size());
+    uint32_t num_subsys = (words_[pos + 1] >> 16) & utility::mask<16>;
+    pos += 2;
+    for (uint32_t i_subsys{0}; i_subsys < num_subsys; i_subsys++) {
+      // header word and event number
+      if (pos + 2 > trailer) corrupt(entry);
+      uint64_t len = (words_[pos] >> 1) & utility::mask<15>;
+      subsys_offsets_.push_back(pos);
+      // header, event number, data and checksum
+      pos += 3 + len;
+      if (pos > trailer) corrupt(entry);
+    }
+    // event checksum
+    pos += 1;
+    if (pos > trailer) corrupt(entry);
+  }
+
+  if (pos != trailer) {
+    EXCEPTION_RAISE("RawFileIndex",
+                    "Raw data file '" + filename + "' has " +
+                        std::to_string(trailer - pos) +
+                        " words after its last event packet.");
+  }
+
+  event_offsets_.push_back(trailer);
+  subsys_begin_.push_back(subsys_offsets_.size());
+}
+
+bool MappedFile::readIndex(const std::string& index_file,
+                           uint64_t source_size, int64_t source_mtime) {
+  std::ifstream in(index_file, std::ios::binary);
+  if (not in) return false;
+
+  IndexHeader header;
+  if (not in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    return false;
+  const uint64_t trailer = n_words_ - 2;
+  if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 or
+      header.version != INDEX_VERSION or
+      header.header_size != sizeof(IndexHeader) or
+      header.source_size != source_size or
+      header.source_mtime != source_mtime or
+      header.entries != words_[trailer] or header.subsystems > trailer)
+    return false;
+
+  std::vector<uint64_t> event_offsets(header.entries + 1),
+      subsys_begin(header.entries + 1), subsys_offsets(header.subsystems);
+  auto read = [&in](std::vector<uint64_t>& vec) {
+    return bool(in.read(reinterpret_cast<char*>(vec.data()),
+                        vec.size() * sizeof(uint64_t)));
+  };
+  if (not read(event_offsets) or not read(subsys_begin) or
+      not read(subsys_offsets) or in.peek() != EOF)
+    return false;
+
+  // make sure every packet stays inside of its event, so a damaged index
+  // can never make us read past the end of the file
+  if (event_offsets.front() != 1 or event_offsets.back() != trailer or
+      subsys_begin.front() != 0 or subsys_begin.back() != header.subsystems)
+    return false;
+  for (uint64_t entry{0}; entry < header.entries; entry++) {
+    if (event_offsets[entry] + 3 > event_offsets[entry + 1] or
+        subsys_begin[entry] > subsys_begin[entry + 1])
+      return false;
+    // each subsystem packet holds at least its header, event number and
+    // checksum and the event checksum comes after them
+    uint64_t end = event_offsets[entry] + 2;
+    for (auto i{subsys_begin[entry]}; i < subsys_begin[entry + 1]; i++) {
+      if (subsys_offsets[i] < end) return false;
+      end = subsys_offsets[i] + 3;
+    }
+    if (end + 1 > event_offsets[entry + 1]) return false;
+  }
+
+  event_offsets_ = std::move(event_offsets);
+  subsys_begin_ = std::move(subsys_begin);
+  subsys_offsets_ = std::move(subsys_offsets);
+  return true;
+}
+
+bool MappedFile::writeIndex(const std::string& index_file,
+                            uint64_t source_size,
+                            int64_t source_mtime) const {
+  IndexHeader header{};
+  std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  header.version = INDEX_VERSION;
+  header.header_size = sizeof(IndexHeader);
+  header.source_size = source_size;
+  header.source_mtime = source_mtime;
+  header.entries = entries();
+  header.subsystems = subsys_offsets_.size();
+
+  return framework::FileCache::write(index_file, [&](std::ostream& out) {
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto* vec : {&event_offsets_, &subsys_begin_, &subsys_offsets_})
+      out.write(reinterpret_cast<const char*>(vec->data()),
+                vec->size() * sizeof(uint64_t));
+    return bool(out);
+  });
+}
+
+}  // namespace rawdatafile
+}  // namespace packing
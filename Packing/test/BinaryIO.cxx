@@ -1,18 +1,51 @@
 #include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
 
 #include "Framework/Configure/Parameters.h"
 #include "Framework/Event.h"
 #include "Framework/EventHeader.h"
+#include "Framework/Exception/Exception.h"
 #include "Framework/RunHeader.h"
 #include "Packing/RawDataFile/EventPacket.h"
 #include "Packing/RawDataFile/File.h"
+#include "Packing/RawDataFile/MappedFile.h"
 #include "Packing/RawDataFile/SubsystemPacket.h"
 #include "Packing/Utility/Reader.h"
 #include "Packing/Utility/Writer.h"
 #include "TTree.h"
 
 namespace packing {
-namespace test {}  // namespace test
+namespace test {
+
+/**
+ * Set an environment variable for the lifetime of this object, restoring
+ * its previous value (or unsetting it) afterwards.
+ */
+class ScopedEnv {
+ public:
+  ScopedEnv(const std::string& name, const std::string& value) : name_{name} {
+    if (const char* previous = std::getenv(name.c_str())) previous_ = previous;
+    setenv(name.c_str(), value.c_str(), 1);
+  }
+
+  ~ScopedEnv() {
+    if (previous_)
+      setenv(name_.c_str(), previous_->c_str(), 1);
+    else
+      unsetenv(name_.c_str());
+  }
+
+ private:
+  std::string name_;
+  std::optional<std::string> previous_;
+};
+
+}  // namespace test
 }  // namespace packing
 
 /**
@@ -118,7 +151,6 @@ TEST_CASE("BinaryIO", "[Packing][functionality]") {
     ps.addParameter("triggerpad_object_name", triggerpad_object_name);
     ps.addParameter("pass_name", std::string());
     ps.addParameter("skip_unavailable", true);
-    ps.addParameter("verify_checksum", false);
 
     std::vector<uint32_t> data = {0xAAAAAAAA, 0xBBBBBBBB, 0xCCCCCCCC,
                                   0xDDDDDDDD, 0xDEDEDEDE, 0xFEDCBA98};
@@ -155,6 +187,7 @@ TEST_CASE("BinaryIO", "[Packing][functionality]") {
     SECTION("Read") {
       std::cout << "starting Read" << std::endl;
       ps.addParameter("is_output", false);
+      ps.addParameter("verify_checksum", true);
       packing::rawdatafile::File f(ps);
 
       ldmx::RunHeader rh(run);
@@ -183,5 +216,150 @@ TEST_CASE("BinaryIO", "[Packing][functionality]") {
 
       f.close();
     }
+
+    SECTION("Mapped Read") {
+      ps.addParameter("is_output", false);
+      ps.addParameter("verify_checksum", true);
+      ps.addParameter("memory_map", true);
+      ps.addParameter("use_index_file", false);
+      packing::rawdatafile::File f(ps);
+
+      ldmx::RunHeader rh(run);
+      f.writeRunHeader(rh);
+      CHECK(rh.getIntParameter("raw_run") == run);
+
+      framework::Event event("testmapped");
+      f.connect(event);
+
+      // jump straight to the last entry and then back to the first
+      for (int i : {n_events - 1, 0}) {
+        REQUIRE(f.seek(i));
+        REQUIRE(f.nextEvent());
+
+        CHECK(event.getEventNumber() == i_event + i);
+        CHECK(data == event.getCollection<uint32_t>(ecal_object_name));
+        CHECK(data == event.getCollection<uint32_t>(hcal_object_name));
+        CHECK(data == event.getCollection<uint32_t>(triggerpad_object_name));
+        CHECK_FALSE(event.exists(tracker_object_name));
+
+        event.Clear();
+        event.onEndOfEvent();
+      }
+
+      CHECK_FALSE(f.seek(n_events + 1));
+
+      f.close();
+    }
+
+    SECTION("Indexed Read") {
+      // keep the index of the test file out of the user cache directory
+      packing::test::ScopedEnv cache_dir("LDMX_CACHE_DIR", "raw_index_cache");
+      std::string raw_file{"file_test.raw"};
+      std::string index_file{
+          packing::rawdatafile::MappedFile::indexPath(raw_file)};
+      REQUIRE_FALSE(index_file.empty());
+      std::remove(index_file.c_str());
+
+      ps.addParameter("is_output", false);
+      ps.addParameter("verify_checksum", true);
+      ps.addParameter("memory_map", true);
+      ps.addParameter("use_index_file", true);
+
+      auto read_all = [&]() {
+        packing::rawdatafile::File f(ps);
+        framework::Event event("testindexed");
+        f.connect(event);
+        for (int i{0}; i < n_events; i++) {
+          REQUIRE(f.nextEvent());
+          CHECK(event.getEventNumber() == i_event + i);
+          CHECK(data == event.getCollection<uint32_t>(ecal_object_name));
+          event.Clear();
+          event.onEndOfEvent();
+        }
+        CHECK_FALSE(f.nextEvent());
+        f.close();
+      };
+
+      SECTION("Twice") {
+        // the first read builds the index and writes it
+        read_all();
+        REQUIRE(std::ifstream(index_file).good());
+
+        // which is used when the file is opened again
+        packing::rawdatafile::MappedFile mapped(raw_file, index_file);
+        CHECK(mapped.indexFromFile());
+        CHECK(mapped.entries() == std::size_t(n_events));
+        read_all();
+      }
+
+      SECTION("Truncated Index") {
+        read_all();
+        {
+          std::ifstream in(index_file, std::ios::binary);
+          std::string index((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+          REQUIRE(index.size() > 8);
+          std::ofstream out(index_file, std::ios::binary | std::ios::trunc);
+          out.write(index.data(), index.size() - 8);
+        }
+
+        // the damaged index is not used and replaced by a rebuilt one
+        {
+          packing::rawdatafile::MappedFile mapped(raw_file, index_file);
+          CHECK_FALSE(mapped.indexFromFile());
+          REQUIRE(mapped.entries() == std::size_t(n_events));
+          for (int i{0}; i < n_events; i++)
+            CHECK(mapped.eventID(i) == uint32_t(i_event + i));
+        }
+        packing::rawdatafile::MappedFile mapped(raw_file, index_file);
+        CHECK(mapped.indexFromFile());
+        read_all();
+      }
+    }
+
+    SECTION("Entry Range") {
+      ps.addParameter("is_output", false);
+      ps.addParameter("verify_checksum", false);
+
+      SECTION("Skip First") {
+        ps.addParameter("first_entry", 1);
+        // more entries than the file has, without overflowing the last entry
+        ps.addParameter("max_entries", std::numeric_limits<int>::max());
+        packing::rawdatafile::File f(ps);
+
+        framework::Event event("testrange");
+        f.connect(event);
+        REQUIRE(f.nextEvent());
+        CHECK(event.getEventNumber() == i_event + 1);
+        CHECK_FALSE(f.nextEvent());
+
+        f.close();
+      }
+
+      SECTION("Limit Entries") {
+        ps.addParameter("first_entry", 0);
+        ps.addParameter("max_entries", 1);
+        packing::rawdatafile::File f(ps);
+
+        framework::Event event("testrange");
+        f.connect(event);
+        REQUIRE(f.nextEvent());
+        CHECK(event.getEventNumber() == i_event);
+        CHECK_FALSE(f.nextEvent());
+
+        f.close();
+      }
+
+      SECTION("Past The End") {
+        ps.addParameter("first_entry", n_events + 1);
+        std::string error;
+        try {
+          packing::rawdatafile::File f(ps);
+        } catch (const framework::exception::Exception& e) {
+          error = e.name();
+        }
+        CHECK(error == "RawFileEntry");
+      }
+    }
   }
 }
@@ -0,0 +1,67 @@
+#include <boost/crc.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "Packing/Utility/CRC.h"
+
+/**
+ * Does our CRC calculator give the same checksums as boost
+ */
+TEST_CASE("CRC", "[Packing][functionality]") {
+  std::mt19937 rng(4242);
+  std::vector<uint32_t> words(100003);
+  for (auto& w : words) w = rng();
+  const auto* bytes = reinterpret_cast<const unsigned char*>(words.data());
+  std::size_t n_bytes = words.size() * sizeof(uint32_t);
+
+  auto boost_crc = [](const void* data, std::size_t len) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data, len);
+    return crc.checksum();
+  };
+
+  SECTION("Blocks") {
+    // odd lengths and offsets go through the byte-wise head and tail
+    for (std::size_t len : {0, 1, 3, 8, 9, 15, 16, 1001}) {
+      for (std::size_t offset : {0, 1, 5}) {
+        packing::utility::CRC crc;
+        crc.process(bytes + offset, len);
+        CHECK(crc.get() == boost_crc(bytes + offset, len));
+      }
+    }
+  }
+
+  SECTION("Streaming") {
+    packing::utility::CRC crc;
+    boost::crc_32_type expected;
+    uint16_t half{0xABCD};
+    crc << half << words;
+    expected.process_bytes(&half, sizeof(half));
+    for (const auto& w : words) expected.process_bytes(&w, sizeof(w));
+    CHECK(crc.get() == expected.checksum());
+  }
+
+  SECTION("Combine") {
+    uint32_t whole = boost_crc(bytes, n_bytes);
+    for (std::size_t cut : {std::size_t(0), std::size_t(1), std::size_t(4097),
+                            n_bytes - 1, n_bytes}) {
+      packing::utility::CRC first, second;
+      first.process(bytes, cut);
+      second.process(bytes + cut, n_bytes - cut);
+      CHECK(packing::utility::CRC::combine(first.get(), second.get(),
+                                           n_bytes - cut) == whole);
+    }
+  }
+
+  SECTION("Parallel") {
+    // large enough to be split between the threads
+    std::vector<uint32_t> large(1 << 22);
+    for (auto& w : large) w = rng();
+    std::size_t len = large.size() * sizeof(uint32_t) - 3;
+    uint32_t expected = boost_crc(large.data(), len);
+    for (unsigned int n_threads : {1, 2, 3}) {
+      CHECK(packing::utility::CRC::checksum(large.data(), len, n_threads) ==
+            expected);
+    }
+  }
+}
@@ -36,6 +36,7 @@ namespace ldmx {
  * so that a user can loop through this collection similar to any other
  * container in C++.
  *
+ *  const auto& digi_collection{event.getObject<HgcrocDigiCollection>(...)};
  *  for (auto digi : digi_collection) {
  *    // digi is of type HgcrocDigi
  *  }
@@ -324,6 +325,19 @@ class HgcrocDigiCollection {
    */
   virtual ~HgcrocDigiCollection() {}
 
+  /// Copyable
+  HgcrocDigiCollection(const HgcrocDigiCollection&) = default;
+  HgcrocDigiCollection& operator=(const HgcrocDigiCollection&) = default;
+
+  /**
+   * Movable
+   *
+   * Declaring the destructor above suppresses the implicit move operations,
+   * so moving would otherwise copy all of the samples.
+   */
+  HgcrocDigiCollection(HgcrocDigiCollection&&) = default;
+  HgcrocDigiCollection& operator=(HgcrocDigiCollection&&) = default;
+
   /**
    * Clear the data in the object.
    *
@@ -426,6 +440,41 @@ class HgcrocDigiCollection {
   void addDigi(unsigned int id, const std::vector<Sample>& digi);
   void addDigi(unsigned int id, const std::vector<uint32_t>& digi);
 
+  /**
+   * Add raw samples to collection
+   *
+   * The caller guarantees that there are as many samples as
+   * the number of samples per digi, so they are not checked.
+   *
+   * @param[in] id global integer ID for this channel
+   * @param[in] digi pointer to the first of the new raw samples
+   */
+  void addRawDigi(unsigned int id, const uint32_t* digi) {
+    channelIDs_.push_back(id);
+    samples_.insert(samples_.end(), digi, digi + getNumSamplesPerDigi());
+  }
+
+  /**
+   * Append all of the digis of another collection
+   *
+   * The other collection needs to have the same number of samples per digi.
+   *
+   * @param[in] other collection to copy the digis from
+   */
+  void append(const HgcrocDigiCollection& other);
+
+  /**
+   * Reserve space for the input number of digis
+   *
+   * The number of samples per digi should be set before reserving.
+   *
+   * @param[in] numDigis number of digis to reserve space for
+   */
+  void reserve(unsigned int numDigis) {
+    channelIDs_.reserve(numDigis);
+    samples_.reserve(numDigis * getNumSamplesPerDigi());
+  }
+
  public:
   /**
    * iterator class so we can do range-based loops over digi collections
@@ -441,7 +490,7 @@ class HgcrocDigiCollection {
       : public std::iterator<std::input_iterator_tag, HgcrocDigi, long> {
    public:
     /// Connect the parent collection with an index to this iterator
-    explicit iterator(HgcrocDigiCollection& c, long index = 0)
+    explicit iterator(const HgcrocDigiCollection& c, long index = 0)
         : digi_index_{index}, coll_{c} {}
     /// Increment the digi index and return the iterator afterwards
     iterator& operator++() {
@@ -470,7 +519,7 @@ class HgcrocDigiCollection {
     /// the index of the digi this iterator represents
     long digi_index_{0};
     /// the parent collection this iterator is looping over
-    HgcrocDigiCollection& coll_;
+    const HgcrocDigiCollection& coll_;
   };  // iterator
 
  public:
@@ -478,8 +527,10 @@ class HgcrocDigiCollection {
    * The beginning of this collection.
    *
    * We just point the user to the zero'th entry.
+   * The iterator only reads from the collection, so we can loop over
+   * the const reference returned by the event bus without copying.
    */
-  iterator begin() { return iterator(*this, 0); }
+  iterator begin() const { return iterator(*this, 0); }
 
   /**
    * The end of this collection
@@ -487,7 +538,7 @@ class HgcrocDigiCollection {
    * The end of the collection is the number
    * of digis stored in it.
    */
-  iterator end() { return iterator(*this, getNumDigis()); }
+  iterator end() const { return iterator(*this, getNumDigis()); }
 
  private:
   /** Mask for lowest order bit in an int */
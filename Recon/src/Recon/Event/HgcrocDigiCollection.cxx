@@ -98,6 +98,25 @@ ClassImp(ldmx::HgcrocDigiCollection)
 
     return;
   }
+
+  void HgcrocDigiCollection::append(const HgcrocDigiCollection &other) {
+    if (other.getNumSamplesPerDigi() != this->getNumSamplesPerDigi()) {
+      std::cerr << "[ WARN ] [ HgcrocDigiCollection ] Appended collection "
+                   "has '"
+                << other.getNumSamplesPerDigi()
+                << "' samples per digi that does not match the number of "
+                   "samples per digi '"
+                << this->getNumSamplesPerDigi() << "'!." << std::endl;
+      return;
+    }
+
+    channelIDs_.insert(channelIDs_.end(), other.channelIDs_.begin(),
+                       other.channelIDs_.end());
+    samples_.insert(samples_.end(), other.samples_.begin(),
+                    other.samples_.end());
+
+    return;
+  }
 }  // namespace ldmx
 
 std::ostream &operator<<(std::ostream &s,
@@ -0,0 +1,161 @@
+/**
+ * @file FieldMapGrid.h
+ * @brief Shared loader for 3D magnetic field maps
+ */
+
+#ifndef SIMCORE_FIELDMAP_FIELDMAPGRID_H_
+#define SIMCORE_FIELDMAP_FIELDMAPGRID_H_
+
+// STL
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// LDMX
+#include "Framework/Logger.h"
+
+namespace simcore::fieldmap {
+
+/**
+ * @class FieldMapGrid
+ * @brief A 3D field map on a regular grid stored as one flat array.
+ *
+ * The field values are stored as (Bx, By, Bz) triplets with z running
+ * fastest and x slowest, the same order as the points in the text map.
+ * No unit conversion is applied; positions and field values are in the
+ * units of the text map.
+ *
+ * The first time a text map is loaded it is converted into a binary cache
+ * file which later jobs map into memory directly instead of parsing the
+ * text again. The cache file lives in the user cache directory given by
+ * framework::FileCache, since the text maps are usually installed read-only.
+ * It records the size and modification time of the text map it was built
+ * from together with a checksum of the field values and is rebuilt whenever
+ * any of them does not match. If the cache cannot be written the job continues
+ * with the parsed map held in memory.
+ *
+ * The text map starts with a line holding the number of grid points along
+ * x, y and z followed by a description of the columns. The header ends with
+ * a line containing the word 'Header' or whose second character is '0',
+ * after which every line lists 'x y z Bx By Bz' for one grid point.
+ */
+class FieldMapGrid {
+ public:
+  /**
+   * Get the grid for the input text map, loading it if necessary.
+   *
+   * Loaded grids are shared, so all users of the same map in a process
+   * refer to a single copy of the field values.
+   *
+   * @throws Exception if the map does not exist or cannot be parsed
+   * @param[in] map_file path to the text field map
+   * @return the loaded field map grid
+   */
+  static std::shared_ptr<const FieldMapGrid> load(const std::string& map_file);
+
+  /**
+   * Path of the binary cache file used for the input text map.
+   * @param[in] map_file path to the text field map
+   * @return path to the binary cache file, empty if there is no writable
+   * cache directory
+   */
+  static std::string cachePath(const std::string& map_file);
+
+  /// Release the memory mapping if there is one
+  ~FieldMapGrid();
+
+  FieldMapGrid(const FieldMapGrid&) = delete;
+  FieldMapGrid& operator=(const FieldMapGrid&) = delete;
+
+  /// Number of grid points along x, y and z
+  const std::array<int, 3>& size() const { return size_; }
+
+  /// Total number of grid points
+  std::size_t numPoints() const {
+    return static_cast<std::size_t>(size_[0]) * size_[1] * size_[2];
+  }
+
+  /// Coordinates of the first grid point in the map
+  const std::array<double, 3>& first() const { return first_; }
+
+  /// Coordinates of the last grid point in the map
+  const std::array<double, 3>& last() const { return last_; }
+
+  /// Flat index of the grid point (ix, iy, iz)
+  std::size_t index(int ix, int iy, int iz) const {
+    return (static_cast<std::size_t>(ix) * size_[1] + iy) * size_[2] + iz;
+  }
+
+  /// The (Bx, By, Bz) field value at a flat grid index
+  const double* field(std::size_t index) const { return data_ + 3 * index; }
+
+  /// All field values, three per grid point
+  const double* data() const { return data_; }
+
+ private:
+  /// Grids are only created through load
+  FieldMapGrid() = default;
+
+  /**
+   * Fill the grid from the cache of the input map, building the cache
+   * first if it is missing or out of date.
+   * @param[in] map_file path to the text field map
+   */
+  void open(const std::string& map_file);
+
+  /**
+   * Map the cache file into memory if it matches the text map.
+   * @param[in] cache_file path to the binary cache file
+   * @param[in] source_size size of the text map in bytes
+   * @param[in] source_mtime modification time of the text map in ns
+   * @return true if the cache is valid and now mapped
+   */
+  bool mapCache(const std::string& cache_file, std::uint64_t source_size,
+                std::int64_t source_mtime);
+
+  /**
+   * Parse the text map into owned_.
+   * @param[in] map_file path to the text field map
+   */
+  void parseText(const std::string& map_file);
+
+  /**
+   * Write the field values held in owned_ to the cache file.
+   * @param[in] cache_file path to the binary cache file
+   * @param[in] source_size size of the text map in bytes
+   * @param[in] source_mtime modification time of the text map in ns
+   * @return true if the cache file was written
+   */
+  bool writeCache(const std::string& cache_file, std::uint64_t source_size,
+                  std::int64_t source_mtime) const;
+
+  /// Number of grid points along x, y and z
+  std::array<int, 3> size_{0, 0, 0};
+
+  /// Coordinates of the first grid point
+  std::array<double, 3> first_{0., 0., 0.};
+
+  /// Coordinates of the last grid point
+  std::array<double, 3> last_{0., 0., 0.};
+
+  /// Field values, either in the mapping or in owned_
+  const double* data_{nullptr};
+
+  /// Start of the memory mapped cache file, null if not mapped
+  void* mapping_{nullptr};
+
+  /// Length of the memory mapping in bytes
+  std::size_t mapping_size_{0};
+
+  /// Field values parsed from text when no cache could be mapped
+  std::vector<double> owned_;
+
+  enableLogging("FieldMapGrid")
+};
+
+}  // namespace simcore::fieldmap
+
+#endif
@@ -12,8 +12,10 @@
 #include "G4MagneticField.hh"
 
 // STL
-#include <vector>
-using std::vector;
+#include <memory>
+
+// LDMX
+#include "SimCore/FieldMap/FieldMapGrid.h"
 
 namespace simcore {
 
@@ -55,6 +57,10 @@ namespace simcore {
  *
  * x y z B_x B_y B_z
  *
+ * The map is loaded through fieldmap::FieldMapGrid, so it is read from the
+ * binary cache of the text map when one is available and shared with any
+ * other user of the same map in the process.
+ *
  * Original PurgMagTabulatedField3D code developed by: S.Larsson and J.
  * Generowicz.
  */
@@ -79,11 +85,9 @@ class MagneticFieldMap3D : public G4MagneticField {
 
  private:
   /*
-   * Storage space for the table.
+   * The field table, (Bx, By, Bz) per grid point with z running fastest.
    */
-  vector<vector<vector<double>>> xField_;
-  vector<vector<vector<double>>> yField_;
-  vector<vector<vector<double>>> zField_;
+  std::shared_ptr<const fieldmap::FieldMapGrid> grid_;
 
   /*
    * The dimensions of the table.
@@ -0,0 +1,260 @@
+#include "SimCore/FieldMap/FieldMapGrid.h"
+
+// LDMX
+#include "Framework/Exception/Exception.h"
+#include "Framework/FileCache.h"
+
+// STL
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simcore::fieldmap {
+
+namespace {
+
+/// Identifies a binary field map cache file
+constexpr char CACHE_MAGIC[8] = {'L', 'D', 'M', 'X', 'B', 'M', 'A', 'P'};
+
+/// Layout of the cache file, caches written with another layout are rebuilt
+constexpr std::uint32_t CACHE_VERSION = 2;
+
+/**
+ * Header at the start of a cache file, followed directly by the field
+ * values as three doubles per grid point.
+ */
+struct CacheHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t header_size;
+  std::int32_t size[3];
+  std::int32_t reserved;
+  double first[3];
+  double last[3];
+  std::uint64_t source_size;
+  std::int64_t source_mtime;
+  std::uint64_t checksum;
+};
+
+/// Checksum of the field values stored in the cache
+std::uint64_t checksum(const double* values, std::size_t n) {
+  return framework::FileCache::hash(values, n * sizeof(double));
+}
+
+/// True if the line only holds whitespace
+bool isBlank(const std::string& line) {
+  return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+}  // namespace
+
+std::shared_ptr<const FieldMapGrid> FieldMapGrid::load(
+    const std::string& map_file) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const FieldMapGrid>> loaded;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& entry = loaded[map_file];
+  if (auto grid = entry.lock()) return grid;
+  std::shared_ptr<FieldMapGrid> grid(new FieldMapGrid);
+  grid->open(map_file);
+  entry = grid;
+  return grid;
+}
+
+std::string FieldMapGrid::cachePath(const std::string& map_file) {
+  return framework::FileCache::path(map_file, ".grid");
+}
+
+FieldMapGrid::~FieldMapGrid() {
+  if (mapping_) munmap(mapping_, mapping_size_);
+}
+
+void FieldMapGrid::open(const std::string& map_file) {
+  framework::FileCache::Stamp source;
+  if (!framework::FileCache::stamp(map_file, source)) {
+    EXCEPTION_RAISE("FileDNE",
+                    "The field map file '" + map_file + "' does not exist!");
+  }
+  std::uint64_t source_size = source.size;
+  std::int64_t source_mtime = source.mtime;
+
+  std::string cache_file = cachePath(map_file);
+  if (!cache_file.empty() and
+      mapCache(cache_file, source_size, source_mtime)) {
+    ldmx_log(info) << "Mapped field map cache " << cache_file;
+    return;
+  }
+
+  ldmx_log(info) << "Reading the field grid from " << map_file;
+  parseText(map_file);
+  data_ = owned_.data();
+
+  if (cache_file.empty() or
+      !writeCache(cache_file, source_size, source_mtime)) {
+    // FileCache has already warned about the reason
+    ldmx_log(warn) << "No field map cache for " << map_file
+                   << ", keeping the parsed map in memory";
+    return;
+  }
+  ldmx_log(info) << "Wrote field map cache " << cache_file;
+  if (mapCache(cache_file, source_size, source_mtime)) {
+    owned_.clear();
+    owned_.shrink_to_fit();
+  } else {
+    data_ = owned_.data();
+  }
+}
+
+bool FieldMapGrid::mapCache(const std::string& cache_file,
+                            std::uint64_t source_size,
+                            std::int64_t source_mtime) {
+  int fd = ::open(cache_file.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat cache;
+  if (fstat(fd, &cache) != 0 ||
+      static_cast<std::size_t>(cache.st_size) < sizeof(CacheHeader)) {
+    ::close(fd);
+    return false;
+  }
+  std::size_t length = cache.st_size;
+  void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) return false;
+
+  const auto* header = static_cast<const CacheHeader*>(mapping);
+  std::size_t values = 3 * static_cast<std::size_t>(header->size[0]) *
+                       header->size[1] * header->size[2];
+  const double* data = reinterpret_cast<const double*>(
+      static_cast<const char*>(mapping) + header->header_size);
+  bool valid =
+      std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 and
+      header->version == CACHE_VERSION and
+      header->header_size == sizeof(CacheHeader) and
+      header->source_size == source_size and
+      header->source_mtime == source_mtime and header->size[0] > 0 and
+      header->size[1] > 0 and header->size[2] > 0 and
+      length == sizeof(CacheHeader) + values * sizeof(double) and
+      header->checksum == checksum(data, values);
+  if (!valid) {
+    ldmx_log(info) << "Field map cache " << cache_file
+                   << " is out of date, rebuilding it";
+    munmap(mapping, length);
+    return false;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    size_[i] = header->size[i];
+    first_[i] = header->first[i];
+    last_[i] = header->last[i];
+  }
+  if (mapping_) munmap(mapping_, mapping_size_);
+  mapping_ = mapping;
+  mapping_size_ = length;
+  data_ = data;
+  return true;
+}
+
+void FieldMapGrid::parseText(const std::string& map_file) {
+  std::ifstream file(map_file);
+  if (!file.good()) {
+    EXCEPTION_RAISE("FileDNE",
+                    "The field map file '" + map_file + "' does not exist!");
+  }
+
+  // The first line that is not blank holds the dimensions of the grid
+  std::string line;
+  while (std::getline(file, line) and isBlank(line)) {
+  }
+  std::istringstream dims(line);
+  if (!(dims >> size_[0] >> size_[1] >> size_[2]) or size_[0] <= 0 or
+      size_[1] <= 0 or size_[2] <= 0) {
+    EXCEPTION_RAISE("FieldMap", "The field map '" + map_file +
+                                    "' does not start with the grid size.");
+  }
+
+  // Skip the column description up to and including the header terminator
+  bool header_found = false;
+  while (std::getline(file, line)) {
+    if (line.find("Header") != std::string::npos or
+        (line.size() > 1 and line[1] == '0')) {
+      header_found = true;
+      break;
+    }
+  }
+  if (!header_found) {
+    EXCEPTION_RAISE("FieldMap", "The end of the header was not found in '" +
+                                    map_file + "'.");
+  }
+
+  owned_.resize(3 * numPoints());
+  std::size_t point = 0;
+  double position[3];
+  while (std::getline(file, line)) {
+    if (isBlank(line) or line[0] == '#' or line[0] == '%') continue;
+    if (point == numPoints()) {
+      EXCEPTION_RAISE("FieldMap",
+                      "The field map '" + map_file + "' has more than " +
+                          std::to_string(numPoints()) + " grid points.");
+    }
+    const char* cursor = line.c_str();
+    for (int i = 0; i < 6; ++i) {
+      char* end;
+      double value = std::strtod(cursor, &end);
+      if (end == cursor) {
+        EXCEPTION_RAISE("FieldMap", "Could not parse the line '" + line +
+                                        "' of the field map '" + map_file +
+                                        "'.");
+      }
+      cursor = end;
+      if (i < 3) {
+        position[i] = value;
+      } else {
+        owned_[3 * point + i - 3] = value;
+      }
+    }
+    if (point == 0) std::copy(position, position + 3, first_.begin());
+    ++point;
+  }
+  if (point != numPoints()) {
+    EXCEPTION_RAISE("FieldMap", "The field map '" + map_file + "' has " +
+                                    std::to_string(point) + " grid points, " +
+                                    std::to_string(numPoints()) +
+                                    " were expected.");
+  }
+  std::copy(position, position + 3, last_.begin());
+}
+
+bool FieldMapGrid::writeCache(const std::string& cache_file,
+                              std::uint64_t source_size,
+                              std::int64_t source_mtime) const {
+  CacheHeader header{};
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.header_size = sizeof(CacheHeader);
+  for (int i = 0; i < 3; ++i) {
+    header.size[i] = size_[i];
+    header.first[i] = first_[i];
+    header.last[i] = last_[i];
+  }
+  header.source_size = source_size;
+  header.source_mtime = source_mtime;
+  header.checksum = checksum(owned_.data(), owned_.size());
+
+  return framework::FileCache::write(cache_file, [&](std::ostream& out) {
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(owned_.data()),
+              owned_.size() * sizeof(double));
+    return bool(out);
+  });
+}
+
+}  // namespace simcore::fieldmap
@@ -86,6 +86,18 @@ class ElectronicsMap {
       return DetID(eid2did_[eid.index()]);
   }
 
+  /**
+   * Get the raw detector ID for the packed index of an electronics ID
+   *
+   * This avoids constructing ID objects when translating many channels.
+   *
+   * @param[in] index packed index of electronics ID
+   * @return raw detector ID, zero if the electronics ID is not in the map
+   */
+  DetectorID::RawValue getRaw(unsigned int index) const {
+    return index < eid2did_.size() ? eid2did_[index] : 0;
+  }
+
   /**
    * Get the electronics ID for this detector ID
    * This method is slow O(N) if the map is not configured for detector id to
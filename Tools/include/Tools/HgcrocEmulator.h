@@ -56,6 +56,10 @@ class HgcrocEmulator {
 
   /**
    * Seed the emulator for random number generation
+   *
+   * Re-seeding an emulator that already has a generator restarts
+   * the same generator from the new seed.
+   *
    * @param[in] seed integer to use as random seed
    */
   void seedGenerator(uint64_t seed);
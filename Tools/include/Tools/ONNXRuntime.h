@@ -49,6 +49,24 @@ class ONNXRuntime {
                   const std::vector<std::string>& output_names = {},
                   int64_t batch_size = 1) const;
 
+  /**
+   * Run model inference and write the outputs into an existing container.
+   *
+   * Same as the run above, but the output arrays are kept by the caller and
+   * re-filled in place, so a processor running the model on every event
+   * re-uses their memory instead of allocating new arrays each time.
+   * @param input_names List of the names of the input nodes.
+   * @param input_values List of input arrays for each input node.
+   * @param output_names Names of the output nodes to get outputs from. Empty
+   * list means all output nodes.
+   * @param[out] outputs Output arrays, resized to match `output_names`.
+   * @param batch_size Number of samples in the batch.
+   */
+  void run(const std::vector<std::string>& input_names,
+           FloatArrays& input_values,
+           const std::vector<std::string>& output_names, FloatArrays& outputs,
+           int64_t batch_size = 1) const;
+
   /**
    * Get the names of all the output nodes.
    * @return A list of names of all the output nodes.
@@ -67,6 +85,8 @@ class ONNXRuntime {
  private:
   static ::Ort::Env env_;
   std::unique_ptr<::Ort::Session> session_;
+  /// CPU memory description the input tensors are created with
+  ::Ort::MemoryInfo memory_info_{nullptr};
 
   std::vector<std::string> input_node_strings_;
   std::vector<const char*> input_node_names_;
@@ -39,7 +39,10 @@ HgcrocEmulator::HgcrocEmulator(const framework::config::Parameters &ps) {
 }
 
 void HgcrocEmulator::seedGenerator(uint64_t seed) {
-  noiseInjector_ = std::make_unique<TRandom3>(seed);
+  if (noiseInjector_)
+    noiseInjector_->SetSeed(seed);
+  else
+    noiseInjector_ = std::make_unique<TRandom3>(seed);
 }
 
 bool HgcrocEmulator::digitize(
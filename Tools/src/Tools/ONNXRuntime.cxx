@@ -53,6 +53,7 @@ ONNXRuntime::ONNXRuntime(const std::string& model_path,
     sess_opts.SetIntraOpNumThreads(1);
     session_.reset(new Session(env_, model_path.c_str(), sess_opts));
   }
+  memory_info_ = MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
   AllocatorWithDefaultOptions allocator;
 
   // get input names and shapes
@@ -107,13 +108,22 @@ FloatArrays ONNXRuntime::run(const std::vector<std::string>& input_names,
                              FloatArrays& input_values,
                              const std::vector<std::string>& output_names,
                              int64_t batch_size) const {
+  FloatArrays outputs;
+  run(input_names, input_values, output_names, outputs, batch_size);
+  return outputs;
+}
+
+void ONNXRuntime::run(const std::vector<std::string>& input_names,
+                      FloatArrays& input_values,
+                      const std::vector<std::string>& output_names,
+                      FloatArrays& outputs, int64_t batch_size) const {
   assert(input_names.size() == input_values.size());
   assert(batch_size > 0);
 
   // create input tensor objects from data values
+  //  the tensors only wrap the input arrays, no data is copied
   std::vector<Value> input_tensors;
-  auto memory_info =
-      MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  input_tensors.reserve(input_node_strings_.size());
   for (const auto& name : input_node_strings_) {
     auto iter = std::find(input_names.begin(), input_names.end(), name);
     if (iter == input_names.end()) {
@@ -130,7 +140,7 @@ FloatArrays ONNXRuntime::run(const std::vector<std::string>& input_names,
                                std::to_string(expected_len));
     }
     auto input_tensor =
-        Value::CreateTensor<float>(memory_info, value->data(), value->size(),
+        Value::CreateTensor<float>(memory_info_, value->data(), value->size(),
                                    input_dims.data(), input_dims.size());
     assert(input_tensor.IsTensor());
     input_tensors.emplace_back(std::move(input_tensor));
@@ -153,21 +163,19 @@ FloatArrays ONNXRuntime::run(const std::vector<std::string>& input_names,
                     input_tensors.data(), input_tensors.size(),
                     run_output_node_names.data(), run_output_node_names.size());
 
-  // convert output to floats
-  FloatArrays outputs;
-  for (auto& output_tensor : output_tensors) {
-    assert(output_tensor.IsTensor());
+  // convert output to floats, re-using the memory of the output arrays
+  outputs.resize(output_tensors.size());
+  for (std::size_t i = 0; i < output_tensors.size(); i++) {
+    assert(output_tensors[i].IsTensor());
 
     // get output shape
-    auto tensor_info = output_tensor.GetTensorTypeAndShapeInfo();
+    auto tensor_info = output_tensors[i].GetTensorTypeAndShapeInfo();
     auto length = tensor_info.GetElementCount();
 
-    auto floatarr = output_tensor.GetTensorMutableData<float>();
-    outputs.emplace_back(floatarr, floatarr + length);
+    auto floatarr = output_tensors[i].GetTensorMutableData<float>();
+    outputs[i].assign(floatarr, floatarr + length);
   }
   assert(outputs.size() == run_output_node_names.size());
-
-  return outputs;
 }
 
 const std::vector<std::string>& ONNXRuntime::getOutputNames() const {
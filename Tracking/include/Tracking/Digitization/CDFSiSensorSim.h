@@ -1,44 +1,122 @@
 #pragma once
 
-#include <map>
+#include <cstddef>
+#include <utility>
+#include <vector>
 
 #include "Acts/Definitions/Algebra.hpp"
-#include "Tracking/Digitization/ChargeCarrier.h"
+#include "SimCore/Event/SimTrackerHit.h"
 #include "Tracking/Digitization/SiElectrodeDataCollection.h"
 
 namespace tracking {
 namespace digitization {
 
+/**
+ * CDF style simulation of the charge collected on the strips of a silicon
+ * sensor.
+ *
+ * Each hit is cut into segments along its path through the sensor, the
+ * charge of every segment is drifted to the strip side and spread by
+ * diffusion, and the resulting Gaussian is integrated over the strips.
+ *
+ * All hits on a sensor are simulated in one pass: the segments of every
+ * hit are first laid out in flat arrays, the diffusion width, trapping and
+ * drift destination are then computed over the whole batch and finally the
+ * charge is accumulated into one dense array with an entry per strip.
+ *
+ * The sensor local frame has u across the strips, v along the strips and w
+ * along the sensor normal with the strips on the +w side. Only the carrier
+ * collected on the strips is simulated and the strips are read out
+ * directly, without capacitive sharing through intermediate strips.
+ */
 class CDFSiSensorSim {
-  // Static parameters - not intended to be user modifiable
+ public:
+  /// Geometry and bulk properties of a single sided strip sensor
+  struct Sensor {
+    /// Number of strips
+    int n_strips{640};
+    /// Strip pitch [mm]
+    double pitch{0.060};
+    /// Thickness [mm]
+    double thickness{0.320};
+    /// Bias voltage [V]
+    double bias_voltage{100.};
+    /// Depletion voltage [V]
+    double depletion_voltage{70.};
+    /// Temperature [K]
+    double temperature{293.};
+    /// Whether the bulk is n type
+    bool n_type{true};
+    /// Charge of the carrier collected on the strips, holes by default
+    int carrier_charge{1};
+    /// Tangent of the Lorentz angle of the collected carrier
+    double tan_lorentz{0.};
+  };
+
+  /// One readout strip with charge
+  struct StripData {
+    int strip;
+    double charge;
+    /// Indices of the hits that deposited charge on the strip
+    std::vector<std::size_t> hits;
+  };
+
+  CDFSiSensorSim(const Sensor& sensor);
+
+  void setTrapping(double trapping) { trapping_ = trapping; }
+
+  void setDebug(bool debug) { debug_ = debug; }
+
+  /**
+   * Simulate the charge left on the strips by all hits on the sensor,
+   * replacing the result of any previous call.
+   *
+   * @param hits The sim hits on this sensor.
+   * @param global_to_local Transform from global to sensor local frame.
+   */
+  void computeElectrodeData(const std::vector<ldmx::SimTrackerHit>& hits,
+                            const Acts::Transform3& global_to_local);
+
+  /// Charge in electrons on each strip from the last computeElectrodeData
+  const std::vector<double>& getStripCharge() const { return strip_charge_; }
+
+  /**
+   * Strips with at least min_charge electrons from the last
+   * computeElectrodeData, in ascending strip order.
+   */
+  std::vector<StripData> getReadoutStrips(double min_charge = 0.) const;
+
+  /**
+   * Readout of the last computeElectrodeData in the electrode data format
+   * shared with the other LCSIM digitization classes.
+   *
+   * @param hits The hits given to computeElectrodeData.
+   */
+  SiElectrodeDataCollection getReadoutData(
+      const std::vector<ldmx::SimTrackerHit>& hits) const;
 
-  // 10% of pitch or depleted thickness
-  // static double deposition_granularity_   = 0.10;
-  // static double distance_error_threshold_ = 0.001;
-
-  // Field
-  // SiSensor _sensor = null;
-
-  CDFSiSensorSim();
-
-  /*
+ private:
+  /// Lay out the segments of all hits in the segment arrays
+  void makeSegments(const std::vector<ldmx::SimTrackerHit>& hits,
+                    const Acts::Transform3& global_to_local);
 
-  void setTrapping(double trapping) {trapping_ = trapping;}
+  /// Drift and diffuse all segments
+  void driftSegments();
 
-  // Get charge map on electrodes
-  // TODO::Add check that the carrier exists in the internal map
-  SiElectrodeDataCollection getReadoutData(ChargeCarrier carrier) {
-    return readout_data.get(carrier);
-  }
+  /// Integrate the charge of all segments over the strips
+  void depositSegments();
 
-  // Simulate charge deposition
-  std::map<ChargeCarrier, SiElectrodeDataCollection> computeElectrodeData();
-  */
+  // 10% of pitch or depleted thickness
+  static constexpr double deposition_granularity_{0.10};
+  static constexpr double distance_error_threshold_{0.001};
+  /// Energy to create one electron-hole pair in silicon [eV]
+  static constexpr double energy_ehpair_{3.62};
+  /// Boltzmann constant [eV/K]
+  static constexpr double k_boltzmann_{8.617333262e-5};
+  /// Number of sigmas of the diffusion Gaussian integrated over
+  static constexpr double n_sigma_{5.};
 
- private:
-  std::map<ChargeCarrier, Acts::Vector3> _drift_direction;
-  std::map<ChargeCarrier, SiElectrodeDataCollection> _sense_data;
-  std::map<ChargeCarrier, SiElectrodeDataCollection> _readout_data;
+  Sensor sensor_;
 
   // Simple simulation of charge trapping, this is a temporary kludge.
   // Charge collection efficiency with linear drift distance dependence.
@@ -49,6 +127,19 @@ class CDFSiSensorSim {
   double trapping_{0.0};
 
   bool debug_{false};
+
+  // Segment arrays, one entry per segment of all hits on the sensor
+  std::vector<double> seg_u_;
+  std::vector<double> seg_w_;
+  std::vector<double> seg_charge_;
+  std::vector<double> seg_sigma_;
+  std::vector<std::size_t> seg_hit_;
+
+  /// Collected charge in electrons, one entry per strip
+  std::vector<double> strip_charge_;
+
+  /// (strip, hit index) pairs of the charge contributions
+  std::vector<std::pair<int, std::size_t>> strip_hits_;
 };
 
 }  // namespace digitization
@@ -52,7 +52,7 @@ static const ChargeCarrier electron(-1, 1268.0, -2.33, 92.0, -0.57, 1.3E+17,
 static const ChargeCarrier hole(1, 406.9, -2.23, 54.3, -0.57, 2.35E+17, 2.4,
                                 0.88, -0.146);
 
-static ChargeCarrier getCarrier(int charge) {
+inline ChargeCarrier getCarrier(int charge) {
   if (charge == -1)
     return electron;
   else if (charge == 1)
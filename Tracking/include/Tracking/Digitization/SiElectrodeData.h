@@ -2,6 +2,7 @@
 
 //---< SimCore >---//
 #include <set>
+#include <vector>
 
 #include "SimCore/Event/SimTrackerHit.h"
 
@@ -10,7 +11,7 @@ namespace digitization {
 
 class SiElectrodeData {
  public:
-  SiElectrodeData();
+  SiElectrodeData() = default;
 
   SiElectrodeData(int charge) { charge_ = charge; }
 
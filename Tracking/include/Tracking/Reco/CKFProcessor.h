@@ -6,6 +6,7 @@
 #include "Framework/RandomNumberSeedService.h"
 
 //--- C++ ---//
+#include <array>
 #include <memory>
 #include <random>
 
@@ -158,8 +159,12 @@ class CKFProcessor final : public TrackingGeometryUser {
   // Processing time counter
   double processing_time_{0.};
 
-  // time profiling
-  std::map<std::string, double> profiling_map_;
+  // time profiling, accumulated time of each step [ms]
+  enum ProfilingStep { SETUP, HITS, SEEDS, CKF_SETUP, CKF_RUN, RESULT_LOOP };
+  std::array<double, RESULT_LOOP + 1> profiling_{};
+
+  // Number of workers running the CKF on the seeds of an event
+  int n_threads_{1};
 
   bool debug_{false};
 
@@ -209,17 +214,17 @@ class CKFProcessor final : public TrackingGeometryUser {
   // The interpolated bfield
   std::string field_map_{""};
 
-  // The Propagator
-  std::unique_ptr<const CkfPropagator> propagator_;
-
   // The CKF
-  std::unique_ptr<const Acts::CombinatorialKalmanFilter<
-      CkfPropagator, Acts::VectorMultiTrajectory>>
-      ckf_;
+  using Ckf = Acts::CombinatorialKalmanFilter<CkfPropagator,
+                                              Acts::VectorMultiTrajectory>;
+
+  // The CKF of each worker, each with its own propagator
+  std::vector<std::unique_ptr<const Ckf>> ckfs_;
 
-  // Track Extrapolator Tool
-  std::shared_ptr<tracking::reco::TrackExtrapolatorTool<CkfPropagator>>
-      trk_extrap_;
+  // Track Extrapolator Tool of each worker
+  std::vector<
+      std::shared_ptr<tracking::reco::TrackExtrapolatorTool<CkfPropagator>>>
+      trk_extraps_;
 
   /// n seeds and n tracks
   int nseeds_{0};
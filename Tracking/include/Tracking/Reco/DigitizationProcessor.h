@@ -19,6 +19,7 @@
 
 //--- C++ ---//
 #include <random>
+#include <vector>
 
 namespace ldmx {
 class Measurement;
@@ -56,13 +57,45 @@ class DigitizationProcessor : public TrackingGeometryUser {
   std::vector<ldmx::Measurement> digitizeHits(
       const std::vector<ldmx::SimTrackerHit>& sim_hits);
 
-  // TODO avoid copies and use references
+  /**
+   * Merge the sim hits left by the same track on the same sensor.
+   *
+   * The hits are grouped by sorting light (sensor, track, index) keys in
+   * a buffer reused between events instead of copying the hits into
+   * nested maps. The merged hits come out ordered by sensor and then track.
+   *
+   * @param sim_hits The collection of SimTrackerHits to merge.
+   * @param merged_hits The merged hits are appended to this collection.
+   */
   bool mergeSimHits(const std::vector<ldmx::SimTrackerHit>& sim_hits,
                     std::vector<ldmx::SimTrackerHit>& merged_hits);
-  bool mergeHits(const std::vector<ldmx::SimTrackerHit>& sihits,
-                 std::vector<ldmx::SimTrackerHit>& mergedHits);
 
  private:
+  /// Sort key of a sim hit when merging: sensor, track and input index
+  struct HitKey {
+    int sensor;
+    int track;
+    unsigned int index;
+  };
+
+  /**
+   * Merge a group of hits with the same sensor and track into one hit.
+   *
+   * @param sim_hits The collection the keys index into.
+   * @param first,last The keys of the hits in the group.
+   * @param merged_hits The merged hit is appended to this collection.
+   */
+  bool mergeHits(const std::vector<ldmx::SimTrackerHit>& sim_hits,
+                 const HitKey* first, const HitKey* last,
+                 std::vector<ldmx::SimTrackerHit>& merged_hits);
+
+  /// The surface of a sensor ID, nullptr if there is no such sensor
+  const Acts::Surface* sensorSurface(int sensor_id) const {
+    return sensor_id >= 0 && sensor_id < int(sensor_surfaces_.size())
+               ? sensor_surfaces_[sensor_id]
+               : nullptr;
+  }
+
   /// The path to the GDML description of the detector
   /// Input hit collection to smear.
   std::string hit_collection_;
@@ -81,6 +114,13 @@ class DigitizationProcessor : public TrackingGeometryUser {
   /// v-direction sigma
   double sigma_v_{0};
 
+  /// Surfaces indexed by sensor ID, filled from the geometry each run
+  std::vector<const Acts::Surface*> sensor_surfaces_;
+  /// Buffer of sort keys reused by mergeSimHits
+  std::vector<HitKey> hit_keys_;
+  /// Buffer of merged hits reused between events
+  std::vector<ldmx::SimTrackerHit> merged_hits_;
+
   //--- Smearing ---//
 
   std::default_random_engine generator_;
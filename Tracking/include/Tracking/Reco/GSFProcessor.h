@@ -94,6 +94,9 @@ using MultiStepper = Acts::MultiEigenStepperLoop<>;
 using Propagator = Acts::Propagator<Acts::EigenStepper<>, Acts::Navigator>;
 using GsfPropagator = Acts::Propagator<MultiStepper, Acts::Navigator>;
 using BetheHeitlerApprox = Acts::Experimental::AtlasBetheHeitlerApprox<6, 5>;
+using Gsf = Acts::Experimental::GaussianSumFitter<GsfPropagator,
+                                                  BetheHeitlerApprox,
+                                                  Acts::VectorMultiTrajectory>;
 
 namespace tracking {
 namespace reco {
@@ -218,10 +221,8 @@ class GSFProcessor final : public TrackingGeometryUser {
   // The seed track collection
   std::string seed_coll_name_{"seedTracks"};
 
-  // The GSF Fitter
-  std::unique_ptr<const Acts::Experimental::GaussianSumFitter<
-      GsfPropagator, BetheHeitlerApprox, Acts::VectorMultiTrajectory>>
-      gsf_;
+  // The GSF Fitters, one per worker
+  std::vector<std::unique_ptr<const Gsf>> gsfs_;
 
   // Configuration
 
@@ -240,18 +241,14 @@ class GSFProcessor final : public TrackingGeometryUser {
   bool usePerigee_{false};
   bool usePlaneSurface_{false};
 
-  // The Propagators
-  std::unique_ptr<const Propagator> propagator_;
+  // Number of tracks refitted at the same time
+  int n_threads_{1};
 
-  // The GSF Fitter
-
-  // This could be a vector
   // The mapping between layers and Acts::Surface
   std::unordered_map<unsigned int, const Acts::Surface *> layer_surface_map_;
 
-  // Track Extrapolator Tool
-  std::shared_ptr<tracking::reco::TrackExtrapolatorTool<Propagator>>
-      trk_extrap_;
+  // Track Extrapolator Tools, one per worker
+  std::vector<std::shared_ptr<TrackExtrapolatorTool<Propagator>>> trk_extraps_;
 
 };  // GSFProcessor
 
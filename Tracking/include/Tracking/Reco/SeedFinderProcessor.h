@@ -82,11 +82,32 @@ class SeedFinderProcessor : public TrackingGeometryUser {
 
   void FindSeedsFromMap(ldmx::Tracks& seeds, const ldmx::Measurements& pmeas);
 
+  /**
+   * Find seeds by growing doublets and triplets inside compatibility windows
+   * on the seeding layers sorted along the bending direction, instead of
+   * fitting every combination of hits on the seeding layers.
+   */
+  void FindSeedsFromBins(ldmx::Tracks& seeds, const ldmx::Measurements& pmeas);
+
  private:
   ldmx::Track SeedTracker(const ldmx::Measurements& vmeas, double xOrigin,
                           const Acts::Vector3& perigee_location,
                           const ldmx::Measurements& pmeas_tgt);
 
+  /**
+   * Fit a five-measurement seed candidate and add it to the seeds if it
+   * passes the seed selection.
+   */
+  void FitSeed(std::vector<ldmx::Measurement>& meas_for_seeds,
+               ldmx::Tracks& seeds, const ldmx::Measurements& pmeas);
+
+  /**
+   * Count the seeds of the exhaustive search that the binned seeding found
+   * as well, matching them by their fitted parameters.
+   */
+  void CompareSeeds(const ldmx::Tracks& map_seeds,
+                    const ldmx::Tracks& bin_seeds);
+
   void LineParabolaToHelix(const Acts::ActsVector<5> parameters,
                            Acts::ActsVector<5>& helix_parameters,
                            Acts::Vector3 ref);
@@ -145,6 +166,21 @@ class SeedFinderProcessor : public TrackingGeometryUser {
   std::vector<std::string> strategies_{};
   double bfield_{1.5};
 
+  /// Use the layer-binned seeding instead of all hit combinations.
+  bool binned_seeding_{false};
+  /// Max |dy/dx| between the hits of a doublet on the outer layers.
+  double doublet_max_dydx_{1.};
+  /// Max |dz/dx| between the hits of a doublet on the outer layers.
+  double doublet_max_dzdx_{0.5};
+  /// Tolerance on y around the predicted seed position [mm].
+  double window_y_{2.};
+  /// Tolerance on z around the predicted seed position [mm].
+  double window_z_{5.};
+  /// Min distance in x between hits used to predict the seed position [mm].
+  double min_lever_arm_{1.};
+  /// Also run the exhaustive search and compare its seeds to the binned ones.
+  bool compare_seeding_{false};
+
   TFile* outputFile_;
   TTree* outputTree_;
 
@@ -168,16 +204,46 @@ class SeedFinderProcessor : public TrackingGeometryUser {
   long nfailz0max_{0};
   long nfailphi_{0};
   long nfailtheta_{0};
+  long ndoublets_{0};
+  long ntriplets_{0};
+  long ncompare_map_seeds_{0};
+  long ncompare_bin_seeds_{0};
+  long ncompare_matched_{0};
 
   // The measurements groups
 
   std::map<int, std::vector<const ldmx::Measurement*>> groups_map;
   std::array<const ldmx::Measurement*, 5> groups_array;
 
+  /// A hit for the binned seeding with the extent of its strip.
+  struct SeedHit {
+    const ldmx::Measurement* meas;
+    /// Global position of the strip center
+    double x, y, z;
+    /// Half extent of the strip along global y and z. A strip measurement
+    /// does not constrain the position along the strip, so the windows
+    /// are widened by it.
+    double ey, ez;
+  };
+
+  /// Hits of a seeding layer sorted in y, with the x range they span.
+  struct SeedLayer {
+    std::vector<SeedHit> hits;
+    double xmin{0.};
+    double xmax{0.};
+    /// Largest half extent in y of the strips of the layer
+    double max_ey{0.};
+  };
+  std::array<SeedLayer, 5> seed_layers_;
+
   // Truth Matching tool
   std::shared_ptr<tracking::sim::TruthMatchingTool> truthMatchingTool_ =
       nullptr;
 
+  // Truth index of the event, refilled every event
+  std::shared_ptr<tracking::sim::TruthIndex> truth_index_ =
+      std::make_shared<tracking::sim::TruthIndex>();
+
 };  // SeedFinderProcessor
 
 }  // namespace reco
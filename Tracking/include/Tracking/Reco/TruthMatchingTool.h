@@ -1,9 +1,11 @@
 #pragma once
+#include <memory>
+
 #include "Acts/EventData/VectorTrackContainer.hpp"
 #include "SimCore/Event/SimParticle.h"
 #include "Tracking/Event/Measurement.h"
 #include "Tracking/Event/Track.h"
-#include "Tracking/Reco/TruthMatchingTool.h"
+#include "Tracking/Sim/TruthIndex.h"
 
 namespace tracking {
 namespace sim {
@@ -21,7 +23,8 @@ class TruthMatchingTool {
   /**
    * Constructor.
    *
-   * @param particleMap The map of all the simulated particles in the event.
+   * @param particleMap The map of all the simulated particles in the event,
+   * which has to outlive the tool.
    * @param measurements All the measurements in the event.
    */
 
@@ -30,10 +33,26 @@ class TruthMatchingTool {
     setup(particleMap, measurements);
   };
 
+  /**
+   * Constructor from a truth index that already holds the particles and the
+   * measurements of the event.
+   *
+   * @param truth_index The truth index of the event.
+   */
+  TruthMatchingTool(std::shared_ptr<const TruthIndex> truth_index) {
+    setup(std::move(truth_index));
+  }
+
   void setup(const std::map<int, ldmx::SimParticle>& particleMap,
              const std::vector<ldmx::Measurement>& measurements) {
-    map_ = particleMap;
-    measurements_ = measurements;
+    auto truth_index = std::make_shared<TruthIndex>();
+    truth_index->setParticles(particleMap);
+    truth_index->setMeasurements(measurements);
+    setup(std::move(truth_index));
+  }
+
+  void setup(std::shared_ptr<const TruthIndex> truth_index) {
+    truth_index_ = std::move(truth_index);
     configured_ = true;
   }
 
@@ -43,19 +62,25 @@ class TruthMatchingTool {
 
   ~TruthMatchingTool() = default;
 
-  TruthInfo TruthMatch(const ldmx::Track& trk);
-  TruthInfo Evaluate(
-      const std::unordered_map<unsigned int, unsigned int>& trk_trackIDs,
-      int n_meas);
-  TruthInfo TruthMatch(const std::vector<ldmx::Measurement>& vmeas);
+  TruthInfo TruthMatch(const ldmx::Track& trk) const;
+
+  /**
+   * Find the track ID that left most of the measurements.
+   *
+   * Ties are resolved in favour of the lowest track ID.
+   *
+   * @param trk_trackIDs The track IDs of all measurements, sorted in place.
+   * @param n_meas The number of measurements.
+   */
+  TruthInfo Evaluate(std::vector<unsigned int>& trk_trackIDs,
+                     int n_meas) const;
+  TruthInfo TruthMatch(const std::vector<ldmx::Measurement>& vmeas) const;
 
   bool configured() { return configured_; }
 
  private:
-  std::map<int, ldmx::SimParticle> map_;
-  std::vector<ldmx::Measurement> measurements_;
+  std::shared_ptr<const TruthIndex> truth_index_;
   bool debug_{false};
-  std::shared_ptr<tracking::sim::TruthMatchingTool> truthMatchingTool = nullptr;
   bool configured_{false};
 };
 
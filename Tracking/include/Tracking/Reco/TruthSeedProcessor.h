@@ -13,6 +13,7 @@
 #include "Tracking/Reco/TrackExtrapolatorTool.h"
 #include "Tracking/Reco/TrackingGeometryUser.h"
 #include "Tracking/Sim/TrackingUtils.h"
+#include "Tracking/Sim/TruthIndex.h"
 
 // --- ACTS --- //
 #include <Acts/Propagator/StraightLineStepper.hpp>
@@ -90,15 +91,20 @@ class TruthSeedProcessor : public TrackingGeometryUser {
   void produce(framework::Event& event) final override;
 
  private:
+  /// Target scoring plane hit selected to seed from
+  struct ScoringHit {
+    int track_id;
+    double p;
+    unsigned int index;
+  };
+
   /**
-   * Create a mapping from the selected scoring plane hit objects to the number
-   * of hits they associated particle creates in the tracker.
-   * @param sim_hits vector
-   * @param hit_count_map filled with the hits lefts by each track
+   * Sort the selected scoring plane hits by track ID and, for the same track,
+   * by decreasing momentum. The first hit of each track is then the one with
+   * the highest momentum.
+   * @param sp_hits the selected scoring plane hits
    */
-
-  void makeHitCountMap(const std::vector<ldmx::SimTrackerHit>& sim_hits,
-                       std::map<int, std::vector<int>>& hit_count_map);
+  static void sortScoringHits(std::vector<ScoringHit>& sp_hits);
 
   /**
    * Use the vertex position of the SimParticle to extract
@@ -158,7 +164,7 @@ class TruthSeedProcessor : public TrackingGeometryUser {
   ldmx::Track RecoilFullSeed(
       const ldmx::SimParticle& particle, const int trackID,
       const ldmx::SimTrackerHit& hit, const ldmx::SimTrackerHit& ecal_hit,
-      const std::map<int, std::vector<int>>& hit_count_map,
+      const tracking::sim::TrackerHitIndex& hit_index,
       const std::shared_ptr<Acts::Surface>& origin_surface,
       const std::shared_ptr<Acts::Surface>& target_surface,
       const std::shared_ptr<Acts::Surface>& ecal_surface);
@@ -176,7 +182,7 @@ class TruthSeedProcessor : public TrackingGeometryUser {
    * @param beam_electron  : the beam electron particle
    * @param hit            : the scoring hit at the target from the beam
    * electron particle survived
-   * @param hit_count_map  : the sim hit on track map
+   * @param hit_index      : the sim hits left by each track
    * @param origin_surface : where to express the track origin parameters. Can
    * be perigee, plane...
    * @param target_surface : the target surface for the truth target state
@@ -185,7 +191,7 @@ class TruthSeedProcessor : public TrackingGeometryUser {
   ldmx::Track TaggerFullSeed(
       const ldmx::SimParticle& beam_electron, const int trackID,
       const ldmx::SimTrackerHit& hit,
-      const std::map<int, std::vector<int>>& hit_count_map,
+      const tracking::sim::TrackerHitIndex& hit_index,
       const std::shared_ptr<Acts::Surface>& origin_surface,
       const std::shared_ptr<Acts::Surface>& target_surface);
 
@@ -252,6 +258,17 @@ class TruthSeedProcessor : public TrackingGeometryUser {
   // Maximum track id for hit to be selected from target scoring plane
   int max_track_id_{5};
 
+  // Truth lookup of the event, kept to reuse its buffers
+  tracking::sim::TruthIndex truth_index_;
+
+  // Sim hits left by each track in the tagger and recoil trackers
+  tracking::sim::TrackerHitIndex tagger_hit_index_;
+  tracking::sim::TrackerHitIndex recoil_hit_index_;
+
+  // Selected target scoring plane hits of the event
+  std::vector<ScoringHit> tagger_sp_hits_;
+  std::vector<ScoringHit> recoil_sp_hits_;
+
   std::shared_ptr<LinPropagator> linpropagator_;
 
   // Track Extrapolator Tool :: TODO Use the real extrapolator!
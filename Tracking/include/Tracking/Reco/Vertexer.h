@@ -1,6 +1,11 @@
 #ifndef TRACKING_RECO_VERTEXER_H_
 #define TRACKING_RECO_VERTEXER_H_
 
+//--- C++ ---//
+#include <cmath>
+#include <utility>
+#include <vector>
+
 //--- Framework ---//
 #include "Framework/Configure/Parameters.h"
 #include "Framework/EventProcessor.h"
@@ -45,6 +50,17 @@ using VoidPropagator = Acts::Propagator<Acts::EigenStepper<>>;
 namespace tracking {
 namespace reco {
 
+/**
+ * Form vertices out of the pairs of tracks between two track collections.
+ *
+ * The pairs are first checked with cheap cuts on the distance of closest
+ * approach, the opening angle and the charge of the two tracks. Only the
+ * pairs passing them are fitted with the Billoir vertex fitter, which runs
+ * on up to n_threads pairs at the same time.
+ *
+ * There is no vertex event object yet, so the fitted vertices are only
+ * counted.
+ */
 class Vertexer : public framework::Producer {
  public:
   Vertexer(const std::string& name, framework::Process& process);
@@ -62,12 +78,34 @@ class Vertexer : public framework::Producer {
                               const std::vector<ldmx::Track>& recoil_tracks);
 
  private:
+  /// Track quantities used by the pair prefilter
+  struct PairTrack {
+    /// Point of closest approach to the perigee
+    Acts::Vector3 position;
+    /// Unit direction at that point
+    Acts::Vector3 direction;
+    double charge;
+  };
+
+  /**
+   * Cheap cuts on a track pair, ahead of the vertex fit.
+   *
+   * The tracks are approximated by straight lines through their perigee
+   * point, which is good enough for loose cuts close to the perigee.
+   *
+   * @param trk_1 The track from the first collection.
+   * @param trk_2 The track from the second collection.
+   * @return true if the pair should be fitted
+   */
+  bool passPairPrefilter(const PairTrack& trk_1, const PairTrack& trk_2) const;
+
   Acts::GeometryContext gctx_;
   Acts::MagneticFieldContext bctx_;
 
   int nevents_{0};
   int nvertices_{0};
   int nreconstructable_{0};
+  int npairs_{0};
   std::shared_ptr<InterpolatedMagneticField3> sp_interpolated_bField_;
   std::shared_ptr<Acts::ConstantBField> bField_;
 
@@ -79,6 +117,24 @@ class Vertexer : public framework::Producer {
   std::shared_ptr<VoidPropagator> propagator_;
   double processing_time_{0.};
 
+  /// Maximum distance of closest approach of a pair [mm]
+  double max_doca_{10.};
+
+  /// Minimum opening angle of a pair [rad]
+  double min_opening_angle_{0.};
+
+  /// Maximum opening angle of a pair [rad]
+  double max_opening_angle_{M_PI};
+
+  /// Only fit pairs of tracks with opposite charge
+  bool opposite_charge_{false};
+
+  /// Number of pairs fitted at the same time
+  int n_threads_{1};
+
+  /// Pairs passing the prefilter, as indices in the two track collections
+  std::vector<std::pair<unsigned int, unsigned int>> pairs_;
+
   // Monitoring histograms
 
   TH1F* h_delta_d0;
@@ -12,6 +12,7 @@
 #include "Acts/Utilities/Result.hpp"
 #include "Acts/Utilities/detail/AxisFwd.hpp"
 #include "Acts/Utilities/detail/Grid.hpp"
+#include "SimCore/FieldMap/FieldMapGrid.h"
 
 static const double DIPOLE_OFFSET = 400.;  // 400 mm
 
@@ -269,20 +270,72 @@ inline InterpolatedMagneticField3 makeMagneticFieldMapXyzFromText(
                              lengthUnit, BFieldUnit, firstOctant);
 }
 
+/**
+ * Build the interpolated field map from a grid loaded by
+ * simcore::fieldmap::FieldMapGrid.
+ *
+ * This is equivalent to reading the text map with
+ * makeMagneticFieldMapXyzFromText with the axes rotated and firstOctant
+ * false, but fills the Acts grid straight from the flat field array instead
+ * of parsing the text and collecting every point position first.
+ */
+inline InterpolatedMagneticField3 makeMagneticFieldMapXyzFromGrid(
+    const simcore::fieldmap::FieldMapGrid& map,
+    GenericTransformPos transformPosition,
+    GenericTransformBField transformMagneticField, Acts::ActsScalar lengthUnit,
+    Acts::ActsScalar BFieldUnit) {
+  // [1] Create the axes, the bin value corresponds to the left boundary so
+  // add one more bin at the upper end
+  auto makeAxis = [&](int i) {
+    size_t nBins = map.size()[i];
+    double min = std::min(map.first()[i], map.last()[i]);
+    double max = std::max(map.first()[i], map.last()[i]);
+    max += std::fabs(max - min) / (nBins - 1);
+    return Acts::detail::EquidistantAxis(min * lengthUnit, max * lengthUnit,
+                                         nBins);
+  };
+  using Grid_t =
+      Acts::detail::Grid<Acts::Vector3, Acts::detail::EquidistantAxis,
+                         Acts::detail::EquidistantAxis,
+                         Acts::detail::EquidistantAxis>;
+  Grid_t grid(std::make_tuple(makeAxis(0), makeAxis(1), makeAxis(2)));
+
+  // [2] Set the bField values, local bins start at 1 because of the
+  // underflow bins
+  for (int i = 0; i < map.size()[0]; ++i) {
+    for (int j = 0; j < map.size()[1]; ++j) {
+      for (int k = 0; k < map.size()[2]; ++k) {
+        const double* field = map.field(map.index(i, j, k));
+        Grid_t::index_t indices = {{size_t(i) + 1, size_t(j) + 1,
+                                    size_t(k) + 1}};
+        grid.atLocalBins(indices) =
+            Acts::Vector3(field[0], field[1], field[2]) * BFieldUnit;
+      }
+    }
+  }
+  grid.setExteriorBins(Acts::Vector3::Zero());
+
+  // [3] Create the mapper and BField Service
+  // with the transformations passed from main producer
+  return Acts::InterpolatedBFieldMap<Grid_t>(
+      {transformPosition, transformMagneticField, std::move(grid)});
+}
+
+/**
+ * Load the field map used by the tracking.
+ *
+ * The map is read through simcore::fieldmap::FieldMapGrid, so later jobs
+ * map the binary cache of the text map instead of parsing it again and the
+ * map is only loaded once per process however many processors use it.
+ */
 inline InterpolatedMagneticField3 loadDefaultBField(
     const std::string& fieldMapFile, GenericTransformPos transformPosition,
     GenericTransformBField transformMagneticField) {
-  // std::function<Acts::Vector3(const Acts::Vector3&, float)>
-  // transformPosition, std::function<Acts::Vector3(const Acts::Vector3&,const
-  // Acts::Vector3&)> transformMagneticField
-
-  return makeMagneticFieldMapXyzFromText(
-      std::move(localToGlobalBin_xyz), transformPosition,
-      transformMagneticField, fieldMapFile,
-      1. * Acts::UnitConstants::mm,    // default scale for axes length
-      1000. * Acts::UnitConstants::T,  // The map is in kT, so scale it to T
-      false,                           // not symmetrical
-      true                             // rotate the axes to tracking frame
+  auto map = simcore::fieldmap::FieldMapGrid::load(fieldMapFile);
+  return makeMagneticFieldMapXyzFromGrid(
+      *map, transformPosition, transformMagneticField,
+      1. * Acts::UnitConstants::mm,   // default scale for axes length
+      1000. * Acts::UnitConstants::T  // The map is in kT, so scale it to T
   );
 }
 
@@ -4,8 +4,16 @@
 /* This class is a strip down version of the ActsExample::PropagatorStepWriter
  * It's used to dump in a root file all the steps information of the
  * Acts::Propagator for a complete validation of a tracking geometry.
+ *
+ * The steps are buffered in flat columns, one entry per step, and written
+ * as one tree entry per batch once enough steps have been buffered. The
+ * propagations and hits of the batch are stored in their own columns, the
+ * steps of a propagation follow each other and n_steps tells how many there
+ * are. Events and propagations can be sampled and steps filtered by volume
+ * and layer to keep the output small on large samples.
  */
 
+#include <cstddef>
 #include <mutex>
 
 //--- Framework ---//
@@ -36,6 +44,12 @@ class PropagatorStepWriter {
     std::string fileMode = "RECREATE";           ///< file access mode
     std::string treeName = "propagation_steps";  ///< name of the output tree
     TFile* rootFile = nullptr;                   ///< common root file
+
+    std::size_t eventSampling = 1;     ///< record events with number % N == 0
+    std::size_t trackSampling = 1;     ///< record every Nth propagation
+    std::vector<int> volumes;          ///< record only these volumes, if any
+    std::vector<int> layers;           ///< record only these layers, if any
+    std::size_t flushSteps = 1 << 18;  ///< buffered steps to write a batch
   };
 
   /// Constructor with
@@ -43,21 +57,43 @@ class PropagatorStepWriter {
   /// @param output logging level
   PropagatorStepWriter(const Config& cfg);
 
+  /// Write the last batch and close the file if it is ours
   ~PropagatorStepWriter();
 
+  /**
+   * Buffer the steps of the propagations of an event.
+   *
+   * The measurements are only buffered along with at least one
+   * propagation, so they always end up in a tree entry.
+   *
+   * @return true if the event was recorded, false if it was sampled out or
+   * has no propagations
+   */
   bool WriteSteps(framework::Event& event,
                   const std::vector<PropagationSteps>& stepCollection,
                   const std::vector<ldmx::Measurement>& measurements,
                   const Acts::Vector3& start_pos,
                   const Acts::Vector3& start_mom);
 
+  /// Write the buffered steps as one tree entry
+  void Flush();
+
  protected:
+  /// Whether a step passes the volume and layer filters
+  bool acceptStep(int volumeID, int layerID) const;
+
+  /// Write the buffered steps, the write mutex must be held
+  void flushBuffer();
+
+  /// Clear all columns
+  void clearBuffer();
+
   Config m_cfg;             ///< the configuration object
   std::mutex m_writeMutex;  ///< protect multi-threaded writes
   TFile* m_outputFile;      ///< the output file name
   TTree* m_outputTree;      ///< the output tree
-  int m_eventNr;            ///< the event number of
 
+  // Step columns, one entry per step
   std::vector<int> m_volumeID;     ///< volume identifier
   std::vector<int> m_boundaryID;   ///< boundary identifier
   std::vector<int> m_layerID;      ///< layer identifier if
@@ -74,13 +110,23 @@ class PropagatorStepWriter {
   std::vector<float> m_step_act;   ///< actor check
   std::vector<float> m_step_abt;   ///< aborter
   std::vector<float> m_step_usr;   ///< user
+
+  // Propagation columns, one entry per propagation
+  std::vector<int> m_eventNr;     ///< the event number
+  std::vector<int> m_trackNr;     ///< the propagation in the event
+  std::vector<int> m_nSteps;      ///< recorded steps of the propagation
+  std::vector<float> m_start_x;   ///< start position x
+  std::vector<float> m_start_y;   ///< start position y
+  std::vector<float> m_start_z;   ///< start position z
+  std::vector<float> m_start_px;  ///< start momentum x
+  std::vector<float> m_start_py;  ///< start momentum y
+  std::vector<float> m_start_pz;  ///< start momentum z
+
+  // Hit columns, one entry per measurement of a recorded event
+  std::vector<int> m_hit_eventNr;  ///< the event number of the hit
   std::vector<float> m_hit_x;      ///< hit location X
   std::vector<float> m_hit_y;      ///< hit location Y
   std::vector<float> m_hit_z;      ///< hit location Z
-  std::vector<float>
-      m_start_pos;  ///< start position of the particle propagated
-  std::vector<float>
-      m_start_mom;  ///< start momentum of the particle propagated
 };
 }  // namespace sim
 }  // namespace tracking
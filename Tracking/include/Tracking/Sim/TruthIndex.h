@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "SimCore/Event/SimParticle.h"
+#include "SimCore/Event/SimTrackerHit.h"
+#include "Tracking/Event/Measurement.h"
+#include "Tracking/Event/Track.h"
+#include "Tracking/Sim/Range.h"
+
+namespace tracking {
+namespace sim {
+
+/**
+ * Per-event truth lookup shared by truth seeding, truth matching and the
+ * tracking DQM.
+ *
+ * The index is built once per event from the truth collections and keeps
+ * everything in flat arrays sorted by track ID, so every query is a binary
+ * search instead of a map lookup. Each part is filled independently and a
+ * user only fills the parts it needs. The index refers to the particles of
+ * the event without copying them, so it is only valid while they are. The
+ * buffers are kept between events, so an index that is refilled every event
+ * does not allocate once it has seen a large enough event. Queries are const
+ * and can be made from several threads at once.
+ */
+class TruthIndex {
+ public:
+  using IndexRange = ActsExamples::Range<std::vector<int>::const_iterator>;
+  using TrackIdRange =
+      ActsExamples::Range<std::vector<unsigned int>::const_iterator>;
+
+  /**
+   * Index the sim particles of the event, replacing the previous ones.
+   * The map has to outlive any query of the particles.
+   */
+  void setParticles(const std::map<int, ldmx::SimParticle>& particles);
+
+  /// The sim particle with the given track ID, nullptr if there is none
+  const ldmx::SimParticle* particle(int track_id) const;
+
+  /// PDG ID of the sim particle with the given track ID, 0 if there is none
+  int pdgID(int track_id) const;
+
+  /// Charge of the sim particle with the given track ID, 0 if there is none
+  double charge(int track_id) const;
+
+  /**
+   * Index the track IDs of the measurements of the event, replacing the
+   * previous ones.
+   */
+  void setMeasurements(const std::vector<ldmx::Measurement>& measurements);
+
+  /// Number of indexed measurements
+  std::size_t nMeasurements() const { return meas_offsets_.size() - 1; }
+
+  /// Track IDs of the sim particles that left the measurement
+  TrackIdRange measurementTrackIds(std::size_t meas_idx) const;
+
+  /**
+   * Index a truth track collection by track ID, replacing the previous one.
+   * Only positions are stored, the collection itself is not copied.
+   */
+  void setTruthTracks(const std::vector<ldmx::Track>& truth_tracks);
+
+  /**
+   * Position in the indexed truth track collection of the first truth track
+   * with the given track ID, -1 if there is none.
+   */
+  int truthTrack(int track_id) const;
+
+ private:
+  /// Track IDs of the particles, sorted
+  std::vector<int> particle_ids_;
+  /// Particles in the same order as particle_ids_
+  std::vector<const ldmx::SimParticle*> particles_;
+
+  /// Start of the track IDs of each measurement in meas_track_ids_
+  std::vector<std::size_t> meas_offsets_{0};
+  /// Track IDs of all measurements, one after the other
+  std::vector<unsigned int> meas_track_ids_;
+
+  /// (track ID, position) of the truth tracks, sorted
+  std::vector<std::pair<int, int>> truth_tracks_;
+};
+
+/**
+ * The hits of one tracker sim hit collection grouped by the track that left
+ * them, keeping only the first hit of a track on each sensor.
+ *
+ * This is the number of hits a track can leave on the tracker, used to
+ * decide whether a truth track is findable. The hit indices of a track are
+ * in the order of the collection.
+ */
+class TrackerHitIndex {
+ public:
+  using IndexRange = TruthIndex::IndexRange;
+
+  /// Index the hits of the collection, replacing the previous ones
+  void build(const std::vector<ldmx::SimTrackerHit>& sim_hits);
+
+  /// Indices of the hits left by the track, on different sensors
+  IndexRange hits(int track_id) const;
+
+  /// Number of sensors with a hit from the track
+  std::size_t nHits(int track_id) const { return hits(track_id).size(); }
+
+ private:
+  struct HitKey {
+    int track;
+    int sensor;
+    int index;
+  };
+
+  /// Scratch space for the sort
+  std::vector<HitKey> keys_;
+  /// Track IDs with at least one hit, sorted
+  std::vector<int> track_ids_;
+  /// Start of the hits of each track in hit_indices_, one more than tracks
+  std::vector<std::size_t> offsets_;
+  /// Hit indices grouped by track
+  std::vector<int> hit_indices_;
+};
+
+}  // namespace sim
+}  // namespace tracking
@@ -32,7 +32,10 @@
 
 // Tracking
 #include <boost/filesystem.hpp>
+#include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "Tracking/geo/TrackingGeometry.h"
 
@@ -46,16 +49,49 @@ class TrackersTrackingGeometryProvider;
 class TrackersTrackingGeometry : public TrackingGeometry {
  public:
   static const std::string NAME;
+
+  /**
+   * Placement of one active silicon sensor in the tracking frame.
+   *
+   * This is everything needed to rebuild the sensor surface without the
+   * GDML: its transform, the half lengths of its rectangular bounds and the
+   * thickness of its silicon material slab.
+   */
+  struct SensorPlacement {
+    Acts::Transform3 transform{Acts::Transform3::Identity()};
+    double half_x{0.};
+    double half_y{0.};
+    double thickness{0.};
+  };
+
+  /**
+   * Layout of one tracker: the position and length along the beam of its
+   * volume in the tracking frame and its sensors grouped by layer name.
+   */
+  struct TrackerLayout {
+    Acts::Vector3 position{Acts::Vector3::Zero()};
+    double x_length{0.};
+    std::map<std::string, std::vector<SensorPlacement>> layers;
+  };
+
   void BuildTaggerLayoutMap(G4VPhysicalVolume* pvol, std::string surfacename);
 
   void BuildRecoilLayoutMap(G4VPhysicalVolume* pvol, std::string surfacename);
 
-  // Provided a physical volume, extract a silicon rectangular plane surface
-  std::shared_ptr<Acts::PlaneSurface> GetSurface(G4VPhysicalVolume* pvol,
-                                                 Acts::Transform3 ref_trans);
+  // Provided a physical volume, extract the placement of a silicon sensor
+  SensorPlacement GetSensorPlacement(G4VPhysicalVolume* pvol,
+                                     Acts::Transform3 ref_trans) const;
+
+  // Provided a tracker volume, extract its position and length along x
+  void GetVolumePlacement(const G4VPhysicalVolume& pvol,
+                          TrackerLayout& layout) const;
+
+  // Create the rectangular plane surface and detector element of a sensor
+  std::shared_ptr<Acts::PlaneSurface> makeSurface(
+      const SensorPlacement& placement);
 
-  Acts::CuboidVolumeBuilder::VolumeConfig buildTrackerVolume();
-  Acts::CuboidVolumeBuilder::VolumeConfig buildRecoilVolume();
+  Acts::CuboidVolumeBuilder::VolumeConfig buildVolume(
+      const std::string& name, const TrackerLayout& layout);
 
   // TODO Implement these
   Acts::CuboidVolumeBuilder::VolumeConfig buildTSVolume() { return {}; }
@@ -63,24 +99,61 @@ class TrackersTrackingGeometry : public TrackingGeometry {
 
  private:
   friend TrackersTrackingGeometryProvider;
-  TrackersTrackingGeometry(const Acts::GeometryContext& gctx,
-                           const std::string& gdml, bool debug);
 
-  G4VPhysicalVolume* Tagger_;
-  G4VPhysicalVolume* Recoil_;
+  /**
+   * Build the tagger and recoil trackers.
+   *
+   * The layouts are read from the geometry cache if there is a cache for
+   * this detector and GDML, otherwise they are extracted from the GDML and
+   * the cache is written for the next job.
+   *
+   * @param[in] gctx the geometry context for this geometry
+   * @param[in] gdml the path to the detector GDML to load
+   * @param[in] debug whether to print extra information or nah
+   * @param[in] cache_dir directory of the geometry cache, the user cache
+   * directory given by framework::FileCache if empty
+   * @param[in] use_cache whether to read and write the geometry cache
+   */
+  TrackersTrackingGeometry(const Acts::GeometryContext& gctx,
+                           const std::string& gdml, bool debug,
+                           const std::string& cache_dir = "",
+                           bool use_cache = true);
+
+  /**
+   * Path to the geometry cache for the GDML, keyed by the detector name
+   * and a hash of all the GDML files of the detector.
+   * @return the path, empty if there is no writable cache directory
+   */
+  std::string cachePath(const std::string& cache_dir) const;
+
+  /**
+   * Read the tagger and recoil layouts from the geometry cache.
+   * @return true if the cache exists and matches the GDML
+   */
+  bool readLayoutCache(const std::string& path);
+
+  /**
+   * Write the tagger and recoil layouts to the geometry cache.
+   * @return true if the cache was written
+   */
+  bool writeLayoutCache(const std::string& path) const;
+
+  G4VPhysicalVolume* Tagger_{nullptr};
+  G4VPhysicalVolume* Recoil_{nullptr};
 
   // I store the layout as a map to distinguish layers/sides
   // They are not too many modules, so it should be ok to use this data
   // structure
 
   // Tracker mapping.
-  // Each key represent the layer index and each entry is the vector of surfaces
+  // Each key represent the layer index and each entry is the vector of sensors
   // that one wants to add to the same layer In this way we can pass multiple
   // surfaces to the same layer to the builder.
-  std::map<std::string, std::vector<std::shared_ptr<const Acts::Surface>>>
-      tagger_layout;
-  std::map<std::string, std::vector<std::shared_ptr<const Acts::Surface>>>
-      recoil_layout;
+  TrackerLayout tagger_layout;
+  TrackerLayout recoil_layout;
+
+  // Hash of the GDML files of the detector, identifies the geometry cache
+  std::uint64_t gdml_hash_{0};
 
   float TrackerYLength_{480.};
   float TrackerZLength_{240.};
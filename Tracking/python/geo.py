@@ -14,6 +14,19 @@ class TrackersTrackingGeometryProvider(ldmxcfg.ConditionsObjectProvider):
         trackgeo.get_instance().setDetector('ldmx-det-v12')
 
     The default detector is 'ldmx-det-v14'.
+
+    Parameters
+    ----------
+    debug : bool
+        Print extra information while building the geometry
+    use_geometry_cache : bool
+        Read the tagger and recoil layouts from a binary geometry cache
+        instead of parsing the GDML with Geant4. The cache is keyed by the
+        detector name and a hash of its GDML files and is written by the
+        first job that does not find it.
+    geometry_cache_dir : str
+        Directory holding the geometry cache, the user cache directory
+        (LDMX_CACHE_DIR, $XDG_CACHE_HOME/ldmx or ~/.cache/ldmx) if empty
     """
 
     __instance = None
@@ -46,6 +59,8 @@ class TrackersTrackingGeometryProvider(ldmxcfg.ConditionsObjectProvider):
         else: 
             super().__init__('TrackersTrackingGeometry', 'tracking::geo::TrackersTrackingGeometryProvider', 'Tracking')
             self.debug = False
+            self.use_geometry_cache = True
+            self.geometry_cache_dir = ''
             self.setDetector('ldmx-det-v14')
             TrackersTrackingGeometryProvider.__instance = self
 
@@ -72,6 +72,25 @@ class SeedFinderProcessor(Producer):
         The name of the input collection of hits to be used for seed finding.
     out_seed_collection : string
         The name of the ouput collection of seeds to be stored.
+    binned_seeding : bool
+        Grow seeds from doublets on the outer seeding layers and triplets with
+        the middle one inside the windows below, instead of fitting every
+        combination of hits on the seeding layers.
+    doublet_max_dydx : float
+        Max |dy/dx| between the hits of a doublet (binned seeding only).
+    doublet_max_dzdx : float
+        Max |dz/dx| between the hits of a doublet (binned seeding only).
+    window_y : float
+        Tolerance in y [mm] around the predicted seed position (binned seeding only).
+    window_z : float
+        Tolerance in z [mm] around the predicted seed position (binned seeding only).
+        The y and z windows are widened by the extent of the strips along y and z,
+        which the strip measurements do not constrain.
+    min_lever_arm : float
+        Min distance in x [mm] between hits used for a prediction (binned seeding only).
+    compare_seeding : bool
+        With binned seeding, also run the search over all hit combinations and
+        report how many of its seeds the binned seeding found at the end of the run.
     """
 
     def __init__(self, instance_name="SeedFinderProcessor"):
@@ -86,7 +105,14 @@ class SeedFinderProcessor(Producer):
         self.strategies = []
         self.input_hits_collection = 'TaggerSimHits'
         self.out_seed_collection = 'SeedTracks'
-        
+        self.binned_seeding = False
+        self.doublet_max_dydx = 1.
+        self.doublet_max_dzdx = 0.5
+        self.window_y = 2.
+        self.window_z = 5.
+        self.min_lever_arm = 1.
+        self.compare_seeding = False
+
 
 class CKFProcessor(Producer):
     """ Producer that runs the Combinatorial Kalman Filter for track finding and fitting.
@@ -159,6 +185,10 @@ class CKFProcessor(Producer):
     gsf_refit : bool
        <experimental>
        Refit tracks with Gaussian Sum Filter 
+    n_threads : int
+       Number of threads running the track finding on the seeds of an event.
+       The tracks are collected in seed order, so the output does not depend
+       on it.
         
     """
 
@@ -188,6 +218,7 @@ class CKFProcessor(Producer):
         self.kf_refit = False
         self.gsf_refit = False
         self.min_hits = 6
+        self.n_threads = 1
 
 
 
@@ -219,6 +250,10 @@ class GSFProcessor(Producer):
         Maximum number of steps for the propagator
     field_map_ : string
         Path to the location of the magnetic field map.
+    n_threads : int
+        Number of threads refitting the tracks of an event. The refitted
+        tracks are kept in the order of the input tracks, so the output does
+        not depend on it.
     """
 
     def __init__(self, instance_name='GSFProcessor'):
@@ -235,6 +270,7 @@ class GSFProcessor(Producer):
         self.propagator_step_size = 200.
         self.propagator_maxSteps  = 1000
         self.field_map = makeFieldMapPath()
+        self.n_threads = 1
 
         
 
@@ -42,6 +42,18 @@ class Vertexer(Producer) :
     trk_c_name_2 : str
         Name of a track collection to vertex. This is unique from
         trk_c_name_1.
+    max_doca : float
+        Maximum distance of closest approach in mm of a track pair, computed
+        from straight lines through the perigee. Pairs further apart are not
+        fitted.
+    min_opening_angle : float
+        Minimum opening angle in rad of a track pair.
+    max_opening_angle : float
+        Maximum opening angle in rad of a track pair.
+    opposite_charge : bool
+        Only fit pairs of tracks with opposite charge.
+    n_threads : int
+        Number of track pairs fitted at the same time.
 
     Parameters
     ----------
@@ -53,5 +65,10 @@ class Vertexer(Producer) :
 
         self.debug = False
         self.field_map = makeFieldMapPath()
-        trk_c_name_1 = 'TaggerTracks'
-        trk_c_name_2 = 'RecoilTracks'
+        self.trk_c_name_1 = 'TaggerTracks'
+        self.trk_c_name_2 = 'RecoilTracks'
+        self.max_doca = 10.
+        self.min_opening_angle = 0.
+        self.max_opening_angle = 3.141592653589793
+        self.opposite_charge = False
+        self.n_threads = 1
@@ -1,260 +1,215 @@
 #include "Tracking/Digitization/CDFSiSensorSim.h"
 
-/*
-
-//TODO:: use ldmx logger instead
-std::map<ChargeCarrier,SiElectrodeDataCollection> computeElectrodeData() {
-
-  if (debug_) {
-
-    //std::cout<<__PRETTY_FUNCTION__<<" sensor " <<std::endl;
-    //std::cout<<" Sense Strips: "
-  }
-
-  depositChargeOneSense();
-  transferChargeToReadout();
-
-  return readout_data_;
-
-
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace tracking {
+namespace digitization {
+
+CDFSiSensorSim::CDFSiSensorSim(const Sensor& sensor) : sensor_{sensor} {
+  if (sensor_.n_strips <= 0 || sensor_.pitch <= 0. ||
+      sensor_.thickness <= 0.)
+    throw std::invalid_argument("CDFSiSensorSim:: invalid sensor geometry");
+  if (sensor_.depletion_voltage <= 0. ||
+      sensor_.bias_voltage <= sensor_.depletion_voltage)
+    throw std::invalid_argument(
+        "CDFSiSensorSim:: the sensor must be over-depleted");
+  if (sensor_.carrier_charge != -1 && sensor_.carrier_charge != 1)
+    throw std::invalid_argument("No ChargeCarrier for charge specified");
 }
 
+void CDFSiSensorSim::computeElectrodeData(
+    const std::vector<ldmx::SimTrackerHit>& hits,
+    const Acts::Transform3& global_to_local) {
+  makeSegments(hits, global_to_local);
+  driftSegments();
+  depositSegments();
 
-//Clear readout data
-
-void clearReadout() {
-
-  for (auto pair : readout_data_) {
-
-    readout_data_[pair.first].clear();
+  if (debug_) {
+    std::cout << __PRETTY_FUNCTION__ << " hits " << hits.size()
+              << " segments " << seg_u_.size() << std::endl;
   }
 }
 
-//Clear sense data
-void clearSense() {
-
-  for (auto pair : sense_dat_) {
-    sense_data[pair.first].clear();
+void CDFSiSensorSim::makeSegments(const std::vector<ldmx::SimTrackerHit>& hits,
+                                  const Acts::Transform3& global_to_local) {
+  seg_u_.clear();
+  seg_w_.clear();
+  seg_charge_.clear();
+  seg_hit_.clear();
+
+  double granularity =
+      deposition_granularity_ * std::min(sensor_.pitch, sensor_.thickness);
+
+  for (std::size_t ihit = 0; ihit < hits.size(); ++ihit) {
+    const auto& hit = hits[ihit];
+    auto position = hit.getPosition();
+    auto momentum = hit.getMomentum();
+
+    Acts::Vector3 center =
+        global_to_local * Acts::Vector3(position[0], position[1], position[2]);
+    Acts::Vector3 direction =
+        global_to_local.linear() *
+        Acts::Vector3(momentum[0], momentum[1], momentum[2]);
+    double p = direction.norm();
+    direction = p > 0. ? Acts::Vector3(direction / p) : Acts::Vector3::UnitZ();
+
+    // The hit position is the middle of its path through the sensor
+    double length = std::max<double>(hit.getPathLength(), 0.);
+    int nsegments = std::max(1, int(std::ceil(length / granularity)));
+    double segment_length = length / nsegments;
+    // Edep is in MeV
+    double segment_charge = hit.getEdep() * 1e6 / energy_ehpair_ / nsegments;
+
+    Acts::Vector3 segment_step = segment_length * direction;
+    Acts::Vector3 segment_center =
+        center - 0.5 * length * direction + 0.5 * segment_step;
+
+    for (int iseg = 0; iseg < nsegments; ++iseg) {
+      seg_u_.push_back(segment_center(0));
+      seg_w_.push_back(segment_center(2));
+      seg_charge_.push_back(segment_charge);
+      seg_hit_.push_back(ihit);
+      segment_center += segment_step;
+    }
   }
-
-}
-
-//TODO Implement
-void lorentzCorrect(const Acts::Vector3& position, const ChargeCarrier& carrier)
-{
-
 }
 
-//TODO:: Implement
-void depositChargeOnSense() {
-  //if (debug_)
-  //  std::cout<<__PRETTY_FUNCTION__<<" depositChargeOnSense for sensor " <<
-std:endl;
-
-  //for (auto& carrier : tracking::digitization::ChargeCarriers) {
-
-
-  //if (sensor_.hasElectrodesOnSide(carrier)) {
-
-  //Use local origin to compute the drift direction
-  //drift_direction_[carrier] = driftDirection(carrier,
-Acts::Vector3(0.,0.,0.));
-  // }
-  //}
-
-  //Acts::Transform3 global_to_sensor     =
-sensor_.getGeometry().getGlobalToLocal();
-  //std::vector<ldmx::SimTrackerHit> hits = sensor_.getReadout().getHits();
+void CDFSiSensorSim::driftSegments() {
+  const double thickness = sensor_.thickness;
+  const double depletion_voltage = sensor_.depletion_voltage;
 
-  for (auto& hit : hits) {
+  // Common factors
+  const double deltaV = sensor_.bias_voltage - depletion_voltage;
+  const double sumV = sensor_.bias_voltage + depletion_voltage;
 
-    Acts::Vector3
-hitPosition(hit.getPosition()[0],hit.getPosition()[1],hit.getPosition()[2]);
-
-
-    if (debug_) {
-      std::cout<<__PRETTY_FUNCTION__<<"Hit Point:
-["<<hitPosition(0)<<","<<hitPosition(1)<<","<<hitPosition(2)<<std::endl;
+  // Charge spreading without magnetic field, up to the log factor
+  const double sigmasq_scale = k_boltzmann_ * sensor_.temperature * thickness *
+                               thickness / depletion_voltage;
 
+  // If the bulk is n-type and the carrier are holes, then evaluate to true
+  // if the bulk is p-type and the carrier are electrons, then evaluate to true
+  // false otherwise
+  const bool majority = sensor_.n_type == (sensor_.carrier_charge == 1);
+
+  // Corrections for the Lorentz drift -- this is an approximation, may have
+  // to be done better for high fields. The drift time correction widens the
+  // Gaussian along u, the drift direction projected on the strip plane,
+  // by 1/cos^2 of the Lorentz angle
+  const double inv_cos2_lorentz =
+      1. + sensor_.tan_lorentz * sensor_.tan_lorentz;
+  const double drift_scale = std::sqrt(inv_cos2_lorentz);
+
+  const std::size_t nsegments = seg_u_.size();
+  seg_sigma_.resize(nsegments);
+  for (std::size_t i = 0; i < nsegments; ++i) {
+    // Distance to the strip side, which is at +w
+    double distance = 0.5 * thickness - seg_w_[i];
+    if (debug_ && (distance < -distance_error_threshold_ ||
+                   distance > thickness + distance_error_threshold_)) {
+      std::cout << "ERROR::" << __PRETTY_FUNCTION__
+                << " Distance is outside of sensor by more than "
+                << distance_error_threshold_ << std::endl;
     }
+    distance = std::clamp(distance, 0., thickness);
+
+    double common_factor = 2.0 * distance * depletion_voltage / thickness;
+    double log_factor = majority
+                            ? std::log(sumV / (sumV - common_factor))
+                            : std::log((deltaV + common_factor) / deltaV);
+    double sigmasq = sigmasq_scale * log_factor;
+    seg_sigma_[i] = std::sqrt(sigmasq) * inv_cos2_lorentz;
+
+    // Apply collection inefficiency for charge trapping: require between 0
+    // and 1
+    double collection_efficiency =
+        1.0 - 10 * trapping_ * distance * drift_scale;
+    seg_charge_[i] *= std::clamp(collection_efficiency, 0., 1.);
+
+    // Drift destination on the strip side
+    seg_u_[i] += sensor_.tan_lorentz * distance;
+  }
+}
 
-    TrackSegment track_segment = new TrackSegment(hit);
-    track_segment.transform(global_to_sensor);
-
-    int nsegments = 0;
-
-    for (auto& carrier : tracking::digitization::carriers) {
-
-      if (sensor_.hasElectrodeOnSide(carrier))
-        nsegments = std::max(nsegments, nSegments(track_segment, carrier,
-deposition_granularity));
-
+void CDFSiSensorSim::depositSegments() {
+  const int n_strips = sensor_.n_strips;
+  const double pitch = sensor_.pitch;
+  // Strips are centered on the sensor, strip 0 at the lowest u
+  const double u_offset = 0.5 * n_strips * pitch;
+
+  strip_charge_.assign(n_strips, 0.);
+  strip_hits_.clear();
+
+  for (std::size_t i = 0; i < seg_u_.size(); ++i) {
+    double charge = seg_charge_[i];
+    if (charge <= 0.) continue;
+    double u = seg_u_[i] + u_offset;
+    double sigma = seg_sigma_[i];
+
+    if (sigma <= 0.) {
+      int strip = int(std::floor(u / pitch));
+      if (strip >= 0 && strip < n_strips) {
+        strip_charge_[strip] += charge;
+        strip_hits_.emplace_back(strip, seg_hit_[i]);
+      }
+      continue;
     }
 
-    double segment_length = track_segment.getLength() /  nsegments;
-    double segment_charge = (track_segment.getEloss() / nsegment ) /
-sensor_.getBulk().ENERGY_EHPAIR;
-
-    Acts::Vector3 segment_step   = segment_length *
-track_segment.getDirection(); Acts::Vector3 segment_center =
-track_segment.getP1() + (0.5 * segment_step);
-
-    if (debug_) {
-      std::cout<<"segment length " << segment_length << std::endl;
-      std::cout<<"segment charge " << segment_charge << std::endl;
-      std::cout<<"segment step   " << segment_step << std::endl;
+    // Integrate the Gaussian over the strips within n_sigma_
+    int first = std::max(0, int(std::floor((u - n_sigma_ * sigma) / pitch)));
+    int last = std::min(n_strips - 1,
+                        int(std::floor((u + n_sigma_ * sigma) / pitch)));
+    if (last < first) continue;
+
+    double scale = 1. / (std::sqrt(2.) * sigma);
+    double lower = std::erf((first * pitch - u) * scale);
+    for (int strip = first; strip <= last; ++strip) {
+      double upper = std::erf(((strip + 1) * pitch - u) * scale);
+      double strip_charge = 0.5 * charge * (upper - lower);
+      lower = upper;
+      if (strip_charge <= 0.) continue;
+      strip_charge_[strip] += strip_charge;
+      strip_hits_.emplace_back(strip, seg_hit_[i]);
     }
-
-    for ( int iseg = 0 ; iseg < nsegments; iseg++) {
-      if (debug_)
-        std::cout<<"segment "<< iseg<<" segment center"<<std::endl;
-
-      for (auto& carrier : tracking::digitization::carriers) {
-
-        if (sensor_.hasElectrodesOnSide(carrier)) {
-
-          SiSensorElectrodes electrodes = sensor_.getSenseElectrodes(carrier);
-
-          //Apply collection inefficiency for charge trapping: require between 0
-and 1
-
-          double collection_efficiency = 1.0 - 10 * trapping_*
-                                         driftVector(segment_center,carrier).norm();
-
-          collection_efficiency = std::max(0.0,
-std::min(1.0,collection_efficiency));
-
-          segment_charge *= collection_efficiency;
-
-          ChargeDistribution charge_distribution =
-diffusionDistribution(segment_charge, segment_center, carrier);
-          charge_distribution.trasnform(electrodes.getParentToLocal());
-
-          std::map<int,int> sense_charge =
-electrodes.computeElectrodeData(charge_distribution);
-
-          sense_data[carrier].add(SiElectrodeDataCollection(sense_charge,hit));
-
-        } // has electrodes
-      }//loop on carriers
-    }// loop on segments
-  }//loop on hits
-}//deposit charge on sense
-
-
-//Calculate charge distribution for carrier
-ChargeDistribution diffusionDistribution(double segment_charge,
-                                         const Acts::Vector3& origin,
-                                         const ChargeCarrier& carrier) {
-
-  if (debug_)
-    std::cout<<__PRETTY_FUNCTION__<<" calculating charge distribution for
-carrier"<<std::endl;
-
-  double distance  = sensor_.distanceFromSide(origin, carrier);
-  double thickness = sensor_.getThickness();
-
-  if (distance < -distance_error_threshold || distance >
-distance_error_threshold) { std::cout<<"ERROR::"<<__PRETTY_FUNCTION__<<"
-Distance is outside of sensor by more than
-"<<distance_error_threshold<<std::endl;
   }
+}
 
-  else if (distance < 0.)
-    distance = 0.;
-  else if (distance > thickness)
-    distance = thickness;
-
-
-  double bias_voltage      = sensor_.getBiasVoltage();
-  double depletion_voltage = sensor_.getDepletionVoltage();
-
-  //Common factors
-
-  double deltaV = bias_voltage - depletionVoltage;
-  double sumV   = bias_voltage + deplettionVoltage;
-  double common_factor = 2.0 * distance * depletion_voltage / thickness;
-
-
-  // Calculate charge spreading without magnetic field
-
-  double sigmaq = sensor_.getBulk().K_BOLTZMANN *
-sensor_.getBulk().getTemperature() * thickness*thickness / depletion_voltage;
-
-  // If the bulk is n-type and the carrier are holes, then evaluate to true
-  // if the bulk is p-type and the carrier are electrons, then evaluate to true
-  // false otherwise
-
-  if (sensor_.getBulk().isNtype() == (carrier.getCharge() == 1 ))
-    sigmasq *= std::log(sumV / (sumV - common_factor));
-  else
-    sigmasq *= std::log((deltaV + common_factor) / deltaV);
-
-  double sigma = std::sqrt(sigmasq);
-
-  if (debug_)
-    std::cout<<__PRETTY_FUNCTION__<<" sigma = " << sigma<<std::endl;
-
-  // Corrections for magnetic field -- this is an approximation, may have to be
-done better for high fields
-
-  // Special case if field is parallel to drift direction
-
-  Acts::Vector3 drift_direction = drift_direction[carrier];
-  Acts::Vector3 bias_surface_normal =
-sensor_.getBiasSurface(carrier).getNormal();
-
-  Acts::Vector3 major_axis, minor_axis;
-  double major_axis_length, minor_axis_length;
-
-  double angular_tolerance = 1.e-9;
-
-  if ( (drift_direction.cross(bias_surface_normal)).norm() < angular_tolerance)
-{
-
-
-    major_axis =
-bias_surface_normal.cross(sensor_.getBiasSurface(carrier).getEdges().get(0).getDirection());
-    minor_axis = bias_surface_normal.cross(major_axis);
-
-    major_axis_length = sigma;
-    minor_axis_length = major_axis_length;
+std::vector<CDFSiSensorSim::StripData> CDFSiSensorSim::getReadoutStrips(
+    double min_charge) const {
+  auto contributions = strip_hits_;
+  std::sort(contributions.begin(), contributions.end());
+  contributions.erase(std::unique(contributions.begin(), contributions.end()),
+                      contributions.end());
+
+  std::vector<StripData> strips;
+  for (auto it = contributions.begin(); it != contributions.end();) {
+    int strip = it->first;
+    auto end =
+        std::find_if(it, contributions.end(),
+                     [strip](const auto& c) { return c.first != strip; });
+    double charge = strip_charge_[strip];
+    if (charge > 0. && charge >= min_charge) {
+      StripData data{strip, charge, {}};
+      for (; it != end; ++it) data.hits.push_back(it->second);
+      strips.push_back(std::move(data));
+    }
+    it = end;
   }
-  else {
-
-    Acts::Vector3 tmp = drift_direction_[carrier].cross(bias_surface_normal);
-    major_axis = bias_surface_normal.cross(tmp);
-    major_axis = major_axis / major_axis.norm();
-
-    minor_axis = bias_surface_normal.cross(major_axis);
-
-    // Project-to-plane would definitely be convenient here!!!
-
-    double cos_theta_lorentz =
-drift_direction_[carrier].dot(bias_surface_normal);
-
-    //drift time correction
-    minor_axis_length  = sigma * (1. / cos_theta_lorentz);
-
-    // + drift time correction
-    major_axis_length  = minor_axis_length * (1. / cos_theta_lorentz);
+  return strips;
+}
 
+SiElectrodeDataCollection CDFSiSensorSim::getReadoutData(
+    const std::vector<ldmx::SimTrackerHit>& hits) const {
+  SiElectrodeDataCollection readout;
+  for (const auto& strip : getReadoutStrips()) {
+    SiElectrodeData data(int(std::lround(strip.charge)));
+    for (auto ihit : strip.hits) data.addSimulatedHit(hits.at(ihit));
+    readout.add(strip.strip, data);
   }
-
-  major_axis = major_axis_length * major_axis;
-  minor_axis = minor_axis_length * minor_axis;
-
-  // FIXME: this has a Z component!!! (is that OK??  I think the whole thing
-transforms into the electrode coordinates before integrating charge.)
-
-  Acts::Vector3 drift_destination = driftDestination(origin,carrier);
-
-
-  GaussianDistribution2D distribution(segment_charge,
-drift_destination,major_axis,minor_axis);
-
-  return distribution;
-
+  return readout;
 }
 
-*/
+}  // namespace digitization
+}  // namespace tracking
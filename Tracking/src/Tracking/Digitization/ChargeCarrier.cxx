@@ -1,6 +1,6 @@
 #include "Tracking/Digitization/ChargeCarrier.h"
 
-#include <math.h>
+#include <cmath>
 
 namespace tracking {
 namespace digitization {
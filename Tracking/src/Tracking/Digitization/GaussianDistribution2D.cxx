@@ -1,5 +1,6 @@
 #include "Tracking/Digitization/GaussianDistribution2D.h"
 
+#include <cmath>
 #include <iostream>
 
 GaussianDistribution2D::GaussianDistribution2D(
@@ -42,7 +43,7 @@ double GaussianDistribution2D::sigma1D(const Acts::Vector3& axis) {
 double GaussianDistribution2D::covxy(const Acts::Vector3& xaxis,
                                      const Acts::Vector3 yaxis) {
   // Check that the axes are orthogonal
-  if (std::abs(xaxis.dot(yaxis) > 1e-9))
+  if (std::abs(xaxis.dot(yaxis)) > 1e-9)
     std::cout << "ERROR:: Pixel axes are not orthogonal" << std::endl;
 
   // Find the sin and cos of the angle between the x axis and the major axis
@@ -39,11 +39,12 @@ void SiElectrodeDataCollection::add(
 
 void SiElectrodeDataCollection::add(int cellid,
                                     SiElectrodeData electrode_data) {
-  if (electrode_data.isValid())
+  if (electrode_data.isValid()) {
     if (collection_.count(cellid))
       collection_[cellid].add(electrode_data);
     else
       collection_[cellid] = electrode_data;
+  }
 }
 
 }  // namespace digitization
@@ -1,6 +1,7 @@
 #include "Tracking/Reco/CKFProcessor.h"
 
 #include "Acts/EventData/TrackHelpers.hpp"
+#include "Framework/ParallelFor.h"
 #include "SimCore/Event/SimParticle.h"
 #include "Tracking/Reco/TruthMatchingTool.h"
 #include "Tracking/Sim/GeometryContainers.h"
@@ -8,6 +9,7 @@
 //--- C++ StdLib ---//
 #include <algorithm>  //std::vector reverse
 #include <iostream>
+#include <optional>
 
 // eN files
 #include <fstream>
@@ -21,12 +23,7 @@ CKFProcessor::CKFProcessor(const std::string& name, framework::Process& process)
 CKFProcessor::~CKFProcessor() {}
 
 void CKFProcessor::onNewRun(const ldmx::RunHeader& rh) {
-  profiling_map_["setup"] = 0.;
-  profiling_map_["hits"] = 0.;
-  profiling_map_["seeds"] = 0.;
-  profiling_map_["ckf_setup"] = 0.;
-  profiling_map_["ckf_run"] = 0.;
-  profiling_map_["result_loop"] = 0.;
+  profiling_.fill(0.);
 
   // Generate a constant magnetic field
   Acts::Vector3 b_field(0., 0., bfield_ * Acts::UnitConstants::T);
@@ -114,27 +111,32 @@ void CKFProcessor::onNewRun(const ldmx::RunHeader& rh) {
   navCfg.boundaryCheckLayerResolving = false;
   const Acts::Navigator navigator(navCfg);
 
-  // Setup the propagators
-  propagator_ =
-      const_b_field_
-          ? std::make_unique<CkfPropagator>(const_stepper, navigator)
-          : std::make_unique<CkfPropagator>(
-                stepper, navigator,
-                Acts::getDefaultLogger("ACTS_PROP", acts_loggingLevel));
-
-  // auto gsf_propagator = GsfPropagator(multi_stepper, navigator);
-
-  // Setup the finder / fitters
-  ckf_ = std::make_unique<std::decay_t<decltype(*ckf_)>>(
-      *propagator_, Acts::getDefaultLogger("CKF", acts_loggingLevel));
-  trk_extrap_ = std::make_shared<std::decay_t<decltype(*trk_extrap_)>>(
-      *propagator_, geometry_context(), magnetic_field_context());
+  // Setup the finder / fitters. Each worker gets its own propagator (with its
+  // own stepper and navigator) so that no state is shared between them.
+  ckfs_.clear();
+  trk_extraps_.clear();
+  for (int worker = 0; worker < std::max(n_threads_, 1); worker++) {
+    const CkfPropagator propagator =
+        const_b_field_
+            ? CkfPropagator(const_stepper, navigator)
+            : CkfPropagator(
+                  stepper, navigator,
+                  Acts::getDefaultLogger("ACTS_PROP", acts_loggingLevel));
+
+    // auto gsf_propagator = GsfPropagator(multi_stepper, navigator);
+
+    ckfs_.push_back(std::make_unique<Ckf>(
+        propagator, Acts::getDefaultLogger("CKF", acts_loggingLevel)));
+    trk_extraps_.push_back(
+        std::make_shared<TrackExtrapolatorTool<CkfPropagator>>(
+            propagator, geometry_context(), magnetic_field_context()));
+  }
 }
 
 void CKFProcessor::produce(framework::Event& event) {
   eventnr_++;
   // get the tracking geometry from conditions
-  auto tg{geometry()};
+  const auto& tg{geometry()};
 
   // TODO use global variable instead and call clear;
 
@@ -187,19 +189,19 @@ void CKFProcessor::produce(framework::Event& event) {
   // a) Loop over the sim Hits
 
   auto setup = std::chrono::high_resolution_clock::now();
-  profiling_map_["setup"] +=
+  profiling_[SETUP] +=
       std::chrono::duration<double, std::milli>(setup - start).count();
 
-  const std::vector<ldmx::Measurement> measurements =
-      event.getCollection<ldmx::Measurement>(measurement_collection_);
+  const auto& measurements{
+      event.getCollection<ldmx::Measurement>(measurement_collection_)};
 
   // check if SimParticleMap is available for truth matching
   std::shared_ptr<tracking::sim::TruthMatchingTool> truthMatchingTool = nullptr;
-  std::map<int, ldmx::SimParticle> particleMap;
 
   if (event.exists("SimParticles")) {
     ldmx_log(debug) << "Setting up track truth matching tool";
-    particleMap = event.getMap<int, ldmx::SimParticle>("SimParticles");
+    const auto& particleMap{
+        event.getMap<int, ldmx::SimParticle>("SimParticles")};
     truthMatchingTool = std::make_shared<tracking::sim::TruthMatchingTool>(
         particleMap, measurements);
   }
@@ -209,7 +211,7 @@ void CKFProcessor::produce(framework::Event& event) {
   const auto geoId_sl_map = makeGeoIdSourceLinkMap(tg, measurements);
 
   auto hits = std::chrono::high_resolution_clock::now();
-  profiling_map_["hits"] +=
+  profiling_[HITS] +=
       std::chrono::duration<double, std::milli>(hits - setup).count();
 
   // ============   Setup the CKF  ============
@@ -218,8 +220,7 @@ void CKFProcessor::produce(framework::Event& event) {
 
   ldmx_log(debug) << "Retrieve the seeds::" << seed_coll_name_;
 
-  const std::vector<ldmx::Track> seed_tracks =
-      event.getCollection<ldmx::Track>(seed_coll_name_);
+  const auto& seed_tracks{event.getCollection<ldmx::Track>(seed_coll_name_)};
 
   // Run the CKF on each seed and produce a track candidate
   std::vector<Acts::BoundTrackParameters> startParameters;
@@ -271,7 +272,7 @@ void CKFProcessor::produce(framework::Event& event) {
   }
 
   auto seeds = std::chrono::high_resolution_clock::now();
-  profiling_map_["seeds"] +=
+  profiling_[SEEDS] +=
       std::chrono::duration<double, std::milli>(seeds - hits).count();
 
   Acts::GainMatrixUpdater kfUpdater;
@@ -381,61 +382,96 @@ void CKFProcessor::produce(framework::Event& event) {
   //						    Acts::Vector3(0., 0., 0.));
   // auto extr_surface = &(*origin_surface);
 
+  // Extrapolation surfaces - be careful:
+  //  x - downstream
+  //  y - left (when looking along x)
+  //  z - up
+  //  Passing identity here means that your target surface is oriented in the
+  //  same way
+  Acts::RotationMatrix3 surf_rotation = Acts::RotationMatrix3::Zero();
+  // u direction along +Y
+  surf_rotation(1, 0) = 1;
+  // v direction along +Z
+  surf_rotation(2, 1) = 1;
+  // w direction along +X
+  surf_rotation(0, 2) = 1;
+
+  const double ECAL_SCORING_PLANE = 240.5;
+  Acts::Vector3 pos(ECAL_SCORING_PLANE, 0., 0.);
+  Acts::Translation3 surf_translation(pos);
+  Acts::Transform3 surf_transform(surf_translation * surf_rotation);
+
+  // Unbounded surface
+  const std::shared_ptr<Acts::PlaneSurface> ecal_surface =
+      Acts::Surface::makeShared<Acts::PlaneSurface>(surf_transform);
+
+  Acts::Vector3 target_pos(0., 0., 0.);
+  Acts::Translation3 target_translation(target_pos);
+  Acts::Transform3 target_transform(target_translation * surf_rotation);
+
+  // Unbounded surface
+  const std::shared_ptr<Acts::PlaneSurface> target_surface =
+      Acts::Surface::makeShared<Acts::PlaneSurface>(target_transform);
+
+  // Beam Origin unbounded surface
+  const std::shared_ptr<Acts::Surface> beamOrigin_surface =
+      tracking::sim::utils::unboundSurface(-700);
+
   ldmx_log(debug) << "About to run CKF..." << std::endl;
 
-  // run the CKF for all initial track states
+  // Each worker has its own propagator options, since the mass hypothesis
+  // changes from seed to seed
+  std::vector<Acts::PropagatorOptions<ActionList, AbortList>> worker_options(
+      ckfs_.size(), propagator_options);
+  std::vector<std::optional<ldmx::Track>> seed_results(startParameters.size());
+
   auto ckf_setup = std::chrono::high_resolution_clock::now();
-  profiling_map_["ckf_setup"] +=
+  profiling_[CKF_SETUP] +=
       std::chrono::duration<double, std::milli>(ckf_setup - seeds).count();
 
-  auto ckf_run = std::chrono::high_resolution_clock::now();
-  profiling_map_["ckf_run"] +=
-      std::chrono::duration<double, std::milli>(ckf_run - ckf_setup).count();
-
-  Acts::VectorTrackContainer vtc;
-  Acts::VectorMultiTrajectory mtj;
-  Acts::TrackContainer tc{vtc, mtj};
+  // Run the CKF on each seed. The seeds are independent, so they are spread
+  // over the workers, each with its own CKF (and so its own propagator and
+  // navigator) and its own track container. The source links, calibrator,
+  // updater, smoother and measurement selector are only read.
+  auto findTrack = [&](std::size_t trackId, int worker) {
+    auto& options{worker_options[worker]};
 
-  for (size_t trackId = 0u; trackId < startParameters.size(); ++trackId) {
     // The seed has a track PdgID associated
-    if (seedPDGID.at(trackId) != 0) {
-      int pdgID = seedPDGID.at(trackId);
-
-      if (pdgID == 2212 || pdgID == -2212)
-        propagator_options.mass = 938 * Acts::UnitConstants::MeV;
-    }
+    int pdgID = seedPDGID.at(trackId);
+    if (pdgID == 2212 || pdgID == -2212)
+      options.mass = 938 * Acts::UnitConstants::MeV;
+    else
+      options.mass = 0.511 * Acts::UnitConstants::MeV;
 
     // Define the CKF options here:
     const Acts::CombinatorialKalmanFilterOptions<SourceLinkAccIt,
                                                  Acts::VectorMultiTrajectory>
         ckfOptions(geometry_context(), magnetic_field_context(),
                    calibration_context(), sourceLinkAccessorDelegate,
-                   ckf_extensions, propagator_options, &(*extr_surface));
+                   ckf_extensions, options, &(*extr_surface));
 
     ldmx_log(debug) << "Running CKF on seed params "
                     << startParameters.at(trackId).parameters().transpose()
                     << std::endl;
 
+    Acts::VectorTrackContainer vtc;
+    Acts::VectorMultiTrajectory mtj;
+    Acts::TrackContainer tc{vtc, mtj};
+
     auto results =
-        ckf_->findTracks(startParameters.at(trackId), ckfOptions, tc);
+        ckfs_[worker]->findTracks(startParameters.at(trackId), ckfOptions, tc);
 
     if (not results.ok()) {
       ldmx_log(debug) << "CKF Fit failed" << std::endl;
-      continue;
+      return;
     }
 
     // No track found
-    if (tc.size() < trackId + 1) continue;
+    if (tc.size() < 1) return;
 
     ldmx_log(debug) << "Filling track info" << std::endl;
 
-    // The track tips are the last measurement index
-    // Acts::MultiTrajectory<Acts::VectorMultiTrajectory> mj =
-    // tc.getTrack(trackId);
-    //                                                        //.container()
-    //                                                        //.trackStateContainer();
-
-    auto track = tc.getTrack(trackId);
+    auto track = tc.getTrack(0);
     calculateTrackQuantities(track);
     // MG ... if I converted above to target surface, these should be parameters
     // at target (should change names)
@@ -503,54 +539,20 @@ void CKFProcessor::produce(framework::Event& event) {
       if (typeFlags.test(Acts::TrackStateFlag::MeasurementFlag)) {
         ActsExamples::IndexSourceLink sl =
             ts.getUncalibratedSourceLink().get<ActsExamples::IndexSourceLink>();
-        ldmx::Measurement ldmx_meas = measurements.at(sl.index());
         ldmx_log(debug) << "SourceLink Index::" << sl.index();
-        ldmx_log(debug) << "Measurement:\n" << ldmx_meas << "\n";
+        ldmx_log(debug) << "Measurement:\n"
+                        << measurements.at(sl.index()) << "\n";
         trk.addMeasurementIndex(sl.index());
       }
     }
 
     // Extrapolations
-
-    // Define the target surface - be careful:
-    //  x - downstream
-    //  y - left (when looking along x)
-    //  z - up
-    //  Passing identity here means that your target surface is oriented in the
-    //  same way
-    Acts::RotationMatrix3 surf_rotation = Acts::RotationMatrix3::Zero();
-    // u direction along +Y
-    surf_rotation(1, 0) = 1;
-    // v direction along +Z
-    surf_rotation(2, 1) = 1;
-    // w direction along +X
-    surf_rotation(0, 2) = 1;
-
-    const double ECAL_SCORING_PLANE = 240.5;
-    Acts::Vector3 pos(ECAL_SCORING_PLANE, 0., 0.);
-    Acts::Translation3 surf_translation(pos);
-    Acts::Transform3 surf_transform(surf_translation * surf_rotation);
-
-    // Unbounded surface
-    const std::shared_ptr<Acts::PlaneSurface> ecal_surface =
-        Acts::Surface::makeShared<Acts::PlaneSurface>(surf_transform);
-
-    Acts::Vector3 target_pos(0., 0., 0.);
-    Acts::Translation3 target_translation(target_pos);
-    Acts::Transform3 target_transform(target_translation * surf_rotation);
-
-    // Unbounded surface
-    const std::shared_ptr<Acts::PlaneSurface> target_surface =
-        Acts::Surface::makeShared<Acts::PlaneSurface>(target_transform);
-
-    // Beam Origin unbounded surface
-    const std::shared_ptr<Acts::Surface> beamOrigin_surface =
-        tracking::sim::utils::unboundSurface(-700);
+    auto& trk_extrap{*trk_extraps_[worker]};
 
     ldmx_log(debug) << "Target extrapolation  ...  this should not change "
                        "anything since track is stored at target plane";
     ldmx::Track::TrackState tsAtTarget;
-    bool success = trk_extrap_->TrackStateAtSurface(
+    bool success = trk_extrap.TrackStateAtSurface(
         track, target_surface, tsAtTarget, ldmx::TrackStateType::AtTarget);
     ldmx_log(debug) << "target extrapolation success??? " << success;
     if (success) {
@@ -565,7 +567,7 @@ void CKFProcessor::produce(framework::Event& event) {
     if (taggerTracking_) {
       ldmx_log(debug) << "Beam Origin Extrapolation";
       ldmx::Track::TrackState tsAtBeamOrigin;
-      bool success = trk_extrap_->TrackStateAtSurface(
+      bool success = trk_extrap.TrackStateAtSurface(
           track, beamOrigin_surface, tsAtBeamOrigin,
           ldmx::TrackStateType::AtBeamOrigin);
 
@@ -579,8 +581,8 @@ void CKFProcessor::produce(framework::Event& event) {
     if (!taggerTracking_) {
       ldmx_log(debug) << "Ecal Extrapolation";
       ldmx::Track::TrackState tsAtEcal;
-      success = trk_extrap_->TrackStateAtSurface(track, ecal_surface, tsAtEcal,
-                                                 ldmx::TrackStateType::AtECAL);
+      success = trk_extrap.TrackStateAtSurface(track, ecal_surface, tsAtEcal,
+                                               ldmx::TrackStateType::AtECAL);
 
       if (success) {
         trk.addTrackState(tsAtEcal);
@@ -592,6 +594,21 @@ void CKFProcessor::produce(framework::Event& event) {
       }
     }
 
+    seed_results[trackId] = std::move(trk);
+  };  // find track from seed
+
+  framework::parallelFor(startParameters.size(), n_threads_, findTrack);
+
+  auto ckf_run = std::chrono::high_resolution_clock::now();
+  profiling_[CKF_RUN] +=
+      std::chrono::duration<double, std::milli>(ckf_run - ckf_setup).count();
+
+  // Collect the tracks in seed order, so that the output does not depend on
+  // the number of workers
+  for (auto& result : seed_results) {
+    if (not result) continue;
+    ldmx::Track& trk{*result};
+
     // Truth matching
     if (truthMatchingTool) {
       auto truthInfo = truthMatchingTool->TruthMatch(trk);
@@ -602,14 +619,13 @@ void CKFProcessor::produce(framework::Event& event) {
 
     // At least 8 hits and p > 50 MeV
     if (trk.getNhits() > min_hits_ && abs(1. / trk.getQoP()) > 0.05) {
-      tracks.push_back(trk);
+      tracks.push_back(std::move(trk));
       ntracks_++;
     }
-
-  }  // loop seed track parameters
+  }
 
   auto result_loop = std::chrono::high_resolution_clock::now();
-  profiling_map_["result_loop"] +=
+  profiling_[RESULT_LOOP] +=
       std::chrono::duration<double, std::milli>(result_loop - ckf_run).count();
 
   // Add the tracks to the event
@@ -636,17 +652,17 @@ void CKFProcessor::onProcessEnd() {
   ldmx_log(info) << "AVG Time/Event: " << processing_time_ / nevents_ << " ms";
   ldmx_log(info) << "Breakdown::";
   ldmx_log(info) << "setup       Avg Time/Event = "
-                 << profiling_map_["setup"] / nevents_ << " ms";
+                 << profiling_[SETUP] / nevents_ << " ms";
   ldmx_log(info) << "hits        Avg Time/Event = "
-                 << profiling_map_["hits"] / nevents_ << " ms";
+                 << profiling_[HITS] / nevents_ << " ms";
   ldmx_log(info) << "seeds       Avg Time/Event = "
-                 << profiling_map_["seeds"] / nevents_ << " ms";
+                 << profiling_[SEEDS] / nevents_ << " ms";
   ldmx_log(info) << "cf_setup    Avg Time/Event = "
-                 << profiling_map_["ckf_setup"] / nevents_ << " ms";
+                 << profiling_[CKF_SETUP] / nevents_ << " ms";
   ldmx_log(info) << "ckf_run     Avg Time/Event = "
-                 << profiling_map_["ckf_run"] / nevents_ << " ms";
+                 << profiling_[CKF_RUN] / nevents_ << " ms";
   ldmx_log(info) << "result_loop Avg Time/Event = "
-                 << profiling_map_["result_loop"] / nevents_ << " ms";
+                 << profiling_[RESULT_LOOP] / nevents_ << " ms";
 }
 
 void CKFProcessor::configure(framework::config::Parameters& parameters) {
@@ -687,6 +703,9 @@ void CKFProcessor::configure(framework::config::Parameters& parameters) {
   out_trk_collection_ =
       parameters.getParameter<std::string>("out_trk_collection", "Tracks");
 
+  // number of workers running the CKF on the seeds of an event
+  n_threads_ = parameters.getParameter<int>("n_threads", 1);
+
   // keep track on which system tracking is running
   taggerTracking_ = parameters.getParameter<bool>("taggerTracking", true);
 
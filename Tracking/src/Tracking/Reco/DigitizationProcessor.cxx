@@ -1,5 +1,6 @@
 #include "Tracking/Reco/DigitizationProcessor.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "Tracking/Event/Measurement.h"
@@ -72,6 +73,14 @@ void DigitizationProcessor::onNewRun(const ldmx::RunHeader& runHeader) {
   const auto& rseed = getCondition<framework::RandomNumberSeedService>(
       framework::RandomNumberSeedService::CONDITIONS_OBJECT_NAME);
   generator_.seed(rseed.getSeed("Tracking::DigitizationProcessor"));
+
+  // Resolve the surfaces once per run instead of a hash lookup per hit
+  sensor_surfaces_.clear();
+  for (const auto& [sensor_id, surface] : geometry().layer_surface_map_) {
+    if (sensor_id >= sensor_surfaces_.size())
+      sensor_surfaces_.resize(sensor_id + 1, nullptr);
+    sensor_surfaces_[sensor_id] = surface;
+  }
 }
 
 void DigitizationProcessor::produce(framework::Event& event) {
@@ -80,15 +89,14 @@ void DigitizationProcessor::produce(framework::Event& event) {
   // Mode 0: Load simulated hits and produce smeared 1d measurements
   // Mode 1: Load simulated hits and produce digitized 1d measurements
 
-  const std::vector<ldmx::SimTrackerHit> sim_hits =
+  const std::vector<ldmx::SimTrackerHit>& sim_hits =
       event.getCollection<ldmx::SimTrackerHit>(hit_collection_);
 
-  std::vector<ldmx::SimTrackerHit> merged_hits;
-
   std::vector<ldmx::Measurement> measurements;
   if (merge_hits_) {
-    mergeSimHits(sim_hits, merged_hits);
-    measurements = digitizeHits(merged_hits);
+    merged_hits_.clear();
+    mergeSimHits(sim_hits, merged_hits_);
+    measurements = digitizeHits(merged_hits_);
   }
 
   else {
@@ -101,33 +109,35 @@ void DigitizationProcessor::produce(framework::Event& event) {
 // This method merges hits that have the same track_id on the same layer.
 // The energy of the merged hit is the sum of the energy of the single sub-hits
 // The position/momentum of the merged hit is the energy-weighted average
-// sihits = vector of hits to merge
-// mergedHits = total merged collection
+// [first, last) = keys of the hits to merge, in input order
+// merged_hits = total merged collection
 
 bool DigitizationProcessor::mergeHits(
-    const std::vector<ldmx::SimTrackerHit>& sihits,
-    std::vector<ldmx::SimTrackerHit>& mergedHits) {
-  if (sihits.size() < 1) return false;
+    const std::vector<ldmx::SimTrackerHit>& sim_hits, const HitKey* first,
+    const HitKey* last, std::vector<ldmx::SimTrackerHit>& merged_hits) {
+  if (first == last) return false;
 
-  if (sihits.size() == 1) {
-    mergedHits.push_back(sihits[0]);
+  const ldmx::SimTrackerHit& first_hit = sim_hits[first->index];
+  if (last - first == 1) {
+    merged_hits.push_back(first_hit);
     return true;
   }
 
   ldmx::SimTrackerHit mergedHit;
   // Since all the hits will be on the same sensor, just use the ID of the first
-  mergedHit.setLayerID(sihits[0].getLayerID());
-  mergedHit.setModuleID(sihits[0].getModuleID());
-  mergedHit.setID(sihits[0].getID());
-  mergedHit.setTrackID(sihits[0].getTrackID());
+  mergedHit.setLayerID(first_hit.getLayerID());
+  mergedHit.setModuleID(first_hit.getModuleID());
+  mergedHit.setID(first_hit.getID());
+  mergedHit.setTrackID(first_hit.getTrackID());
 
   double X{0}, Y{0}, Z{0}, PX{0}, PY{0}, PZ{0};
   double T{0}, E{0}, EDEP{0}, path{0};
   int pdgID{0};
 
-  pdgID = sihits[0].getPdgID();
+  pdgID = first_hit.getPdgID();
 
-  for (auto hit : sihits) {
+  for (const HitKey* key = first; key != last; ++key) {
+    const ldmx::SimTrackerHit& hit = sim_hits[key->index];
     double edep_hit = hit.getEdep();
     EDEP += edep_hit;
     E += hit.getEnergy();
@@ -145,7 +155,7 @@ bool DigitizationProcessor::mergeHits(
           << "ERROR:: Found hits with compatible sensorID and track_id "
              "but different PDGID";
       ldmx_log(error) << "TRACKID ==" << hit.getTrackID() << " vs "
-                      << sihits[0].getTrackID();
+                      << first_hit.getTrackID();
       ldmx_log(error) << "PDGID== " << hit.getPdgID() << " vs " << pdgID;
       return false;
     }
@@ -159,44 +169,47 @@ bool DigitizationProcessor::mergeHits(
   mergedHit.setEdep(EDEP);
   mergedHit.setPdgID(pdgID);
 
-  mergedHits.push_back(mergedHit);
+  merged_hits.push_back(mergedHit);
 
   return true;
 }
 
-// TODO avoid copies and use references
 bool DigitizationProcessor::mergeSimHits(
     const std::vector<ldmx::SimTrackerHit>& sim_hits,
     std::vector<ldmx::SimTrackerHit>& merged_hits) {
-  // The first key is the index of the sensitive element ID, second key is the
-  // track_id
-  std::map<int, std::map<int, std::vector<ldmx::SimTrackerHit>>> hitmap;
-
-  for (auto hit : sim_hits) {
-    unsigned int index = tracking::sim::utils::getSensorID(hit);
-    unsigned int trackid = hit.getTrackID();
-    hitmap[index][trackid].push_back(hit);
-
-    ldmx_log(debug) << "hitmap being filled, size::[" << index << "]["
-                    << trackid << "] size " << hitmap[index][trackid].size();
+  // Sort the keys by sensor, then track, then input index so that the hits
+  // of a group are contiguous and keep their input order
+  hit_keys_.clear();
+  hit_keys_.reserve(sim_hits.size());
+  for (unsigned int index = 0; index < sim_hits.size(); ++index) {
+    const auto& hit = sim_hits[index];
+    hit_keys_.push_back(
+        {tracking::sim::utils::getSensorID(hit), hit.getTrackID(), index});
   }
-
-  typedef std::map<int,
-                   std::map<int, std::vector<ldmx::SimTrackerHit>>>::iterator
-      hitmap_it1;
-  typedef std::map<int, std::vector<ldmx::SimTrackerHit>>::iterator hitmap_it2;
-  for (hitmap_it1 it = hitmap.begin(); it != hitmap.end(); it++) {
-    for (hitmap_it2 it2 = it->second.begin(); it2 != it->second.end(); it2++) {
-      mergeHits(it2->second, merged_hits);
-    }
+  std::sort(hit_keys_.begin(), hit_keys_.end(),
+            [](const HitKey& lhs, const HitKey& rhs) {
+              if (lhs.sensor != rhs.sensor) return lhs.sensor < rhs.sensor;
+              if (lhs.track != rhs.track) return lhs.track < rhs.track;
+              return lhs.index < rhs.index;
+            });
+
+  const HitKey* keys_end = hit_keys_.data() + hit_keys_.size();
+  for (const HitKey* first = hit_keys_.data(); first != keys_end;) {
+    const HitKey* last = first + 1;
+    while (last != keys_end && last->sensor == first->sensor &&
+           last->track == first->track)
+      ++last;
+
+    ldmx_log(debug) << "merging [" << first->sensor << "][" << first->track
+                    << "] size " << last - first;
+
+    mergeHits(sim_hits, first, last, merged_hits);
+    first = last;
   }
 
   ldmx_log(debug) << "Sim_hits Size=" << sim_hits.size()
                   << "Merged_hits Size=" << merged_hits.size();
 
-  // for (auto hit : sim_hits) hit.Print();
-  // for (auto mhit : merged_hits) mhit.Print();
-
   return true;
 }
 
@@ -225,7 +238,7 @@ std::vector<ldmx::Measurement> DigitizationProcessor::digitizeHits(
       measurement.setLayerID(layer_id);
 
       // Get the surface
-      auto hit_surface{geometry().getSurface(layer_id)};
+      const Acts::Surface* hit_surface{sensorSurface(layer_id)};
 
       if (hit_surface) {
         // Transform from global to local coordinates.
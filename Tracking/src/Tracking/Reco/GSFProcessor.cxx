@@ -1,8 +1,10 @@
 #include "Tracking/Reco/GSFProcessor.h"
 
 #include <algorithm>
+#include <optional>
 
 #include "Acts/EventData/SourceLink.hpp"
+#include "Framework/ParallelFor.h"
 
 namespace tracking {
 namespace reco {
@@ -85,13 +87,6 @@ void GSFProcessor::onNewRun(const ldmx::RunHeader& rh) {
 
   Acts::MixtureReductionMethod reductionMethod =
       Acts::MixtureReductionMethod::eMaxWeight;
-  Acts::MultiEigenStepperLoop multi_stepper(
-      map, reductionMethod,
-      Acts::getDefaultLogger("GSF_STEP", acts_loggingLevel));
-
-  // Detailed Stepper
-
-  // Acts::MultiEigenStepperLoop multi_stepper(map, finalReductionMethod);
 
   // Navigator
   Acts::Navigator::Config navCfg{geometry().getTG()};
@@ -101,25 +96,35 @@ void GSFProcessor::onNewRun(const ldmx::RunHeader& rh) {
   navCfg.boundaryCheckLayerResolving = false;
   const Acts::Navigator navigator(navCfg);
 
-  auto gsf_propagator =
-      GsfPropagator(std::move(multi_stepper), std::move(navigator),
-                    Acts::getDefaultLogger("GSF_PROP", acts_loggingLevel));
-
-  BetheHeitlerApprox betheHeitler =
-      Acts::Experimental::makeDefaultBetheHeitlerApprox();
-
-  const auto gsfLogger = Acts::getDefaultLogger("GSF", acts_loggingLevel);
-
-  gsf_ = std::make_unique<std::decay_t<decltype(*gsf_)>>(
-      std::move(gsf_propagator), std::move(betheHeitler),
-      Acts::getDefaultLogger("GSF", acts_loggingLevel));
-
-  const auto stepper = Acts::EigenStepper<>{map};
-  propagator_ = std::make_unique<Propagator>(
-      stepper, navigator, Acts::getDefaultLogger("PROP", acts_loggingLevel));
-
-  trk_extrap_ = std::make_shared<std::decay_t<decltype(*trk_extrap_)>>(
-      *propagator_, geometry_context(), magnetic_field_context());
+  // Each worker gets its own fitter and extrapolator, with their own
+  // steppers, so that no state or scratch space is shared between them.
+  gsfs_.clear();
+  trk_extraps_.clear();
+  for (int worker = 0; worker < std::max(n_threads_, 1); worker++) {
+    // Stepper
+    Acts::MultiEigenStepperLoop multi_stepper(
+        map, reductionMethod,
+        Acts::getDefaultLogger("GSF_STEP", acts_loggingLevel));
+
+    auto gsf_propagator =
+        GsfPropagator(std::move(multi_stepper), navigator,
+                      Acts::getDefaultLogger("GSF_PROP", acts_loggingLevel));
+
+    BetheHeitlerApprox betheHeitler =
+        Acts::Experimental::makeDefaultBetheHeitlerApprox();
+
+    gsfs_.push_back(std::make_unique<Gsf>(
+        std::move(gsf_propagator), std::move(betheHeitler),
+        Acts::getDefaultLogger("GSF", acts_loggingLevel)));
+
+    const auto stepper = Acts::EigenStepper<>{map};
+    const Propagator propagator(
+        stepper, navigator, Acts::getDefaultLogger("PROP", acts_loggingLevel));
+
+    trk_extraps_.push_back(
+        std::make_shared<TrackExtrapolatorTool<Propagator>>(
+            propagator, geometry_context(), magnetic_field_context()));
+  }
 }
 
 void GSFProcessor::configure(framework::config::Parameters& parameters) {
@@ -140,6 +145,7 @@ void GSFProcessor::configure(framework::config::Parameters& parameters) {
   usePerigee_ = parameters.getParameter<bool>("usePerigee", false);
 
   debug_ = parameters.getParameter<bool>("debug", false);
+  n_threads_ = parameters.getParameter<int>("n_threads", 1);
 
   // finalReductionMethod_ =
   // parameters.getParameter<double>("finalReductionMethod",);
@@ -148,15 +154,16 @@ void GSFProcessor::configure(framework::config::Parameters& parameters) {
 void GSFProcessor::produce(framework::Event& event) {
   // General Setup
 
-  auto tg{geometry()};
+  const auto& tg{geometry()};
 
   // Retrieve the tracks
   if (!event.exists(trackCollection_)) return;
-  auto tracks{event.getCollection<ldmx::Track>(trackCollection_)};
+  const auto& tracks{event.getCollection<ldmx::Track>(trackCollection_)};
 
   // Retrieve the measurements
   if (!event.exists(measCollection_)) return;
-  auto measurements{event.getCollection<ldmx::Measurement>(measCollection_)};
+  const auto& measurements{
+      event.getCollection<ldmx::Measurement>(measCollection_)};
 
   tracking::sim::LdmxMeasurementCalibrator calibrator{measurements};
 
@@ -215,18 +222,20 @@ void GSFProcessor::produce(framework::Event& event) {
       maxComponents_,        weightCutoff_,
       abortOnError_,         disableAllMaterialHandling_};
 
-  // Output track container
-  std::vector<ldmx::Track> out_tracks;
+  // Acts containers, one per worker
+  struct WorkerContainers {
+    Acts::VectorTrackContainer vtc;
+    Acts::VectorMultiTrajectory mtj;
+  };
+  std::vector<WorkerContainers> containers(std::max(n_threads_, 1));
 
-  // Acts containers
-  Acts::VectorTrackContainer vtc;
-  Acts::VectorMultiTrajectory mtj;
-  Acts::TrackContainer tc{vtc, mtj};
+  // Refitted tracks, in the order of the input tracks
+  std::vector<std::optional<ldmx::Track>> refit_tracks(tracks.size());
 
-  // Loop on tracks
-  unsigned int itrk = 0;
+  auto refitTrack = [&](std::size_t i_track, int worker) {
+    const ldmx::Track& track = tracks[i_track];
+    Acts::TrackContainer tc{containers[worker].vtc, containers[worker].mtj};
 
-  for (auto& track : tracks) {
     // Retrieve measurements on track
     std::vector<ldmx::Measurement> measOnTrack;
 
@@ -271,7 +280,7 @@ void GSFProcessor::produce(framework::Event& event) {
     if (!track.getTrackState(ldmx::TrackStateType::AtBeamOrigin).has_value()) {
       ldmx_log(warn)
           << "Failed retreiving AtBeamOrigin TrackState for track. Skipping..";
-      continue;
+      return;
     }
 
     auto ts = track.getTrackState(ldmx::TrackStateType::AtBeamOrigin).value();
@@ -302,18 +311,16 @@ void GSFProcessor::produce(framework::Event& event) {
     ldmx_log(debug) << trk_pos_bO(0) << " " << trk_pos_bO(1) << " "
                     << trk_pos_bO(2) << std::endl;
 
-    auto gsf_refit_result =
-        gsf_->fit(fit_trackSourceLinks.begin(), fit_trackSourceLinks.end(),
-                  trk_btp_bO, gsfOptions, tc);
+    auto gsf_refit_result = gsfs_[worker]->fit(fit_trackSourceLinks.begin(),
+                                               fit_trackSourceLinks.end(),
+                                               trk_btp_bO, gsfOptions, tc);
 
     if (!gsf_refit_result.ok()) {
       ldmx_log(warn) << "GSF re-fit failed" << std::endl;
-      continue;
+      return;
     }
 
-    if (tc.size() < 1) continue;
-
-    auto gsftrk = tc.getTrack(itrk);
+    auto gsftrk = gsf_refit_result.value();
     calculateTrackQuantities(gsftrk);
 
     const Acts::BoundVector& perigee_pars = gsftrk.parameters();
@@ -343,7 +350,7 @@ void GSFProcessor::produce(framework::Event& event) {
     ldmx_log(debug) << "Target extrapolation";
     ldmx::Track::TrackState tsAtTarget;
 
-    bool success = trk_extrap_->TrackStateAtSurface(
+    bool success = trk_extraps_[worker]->TrackStateAtSurface(
         gsftrk, target_surface, tsAtTarget, ldmx::TrackStateType::AtTarget);
 
     if (success) trk.addTrackState(tsAtTarget);
@@ -367,11 +374,17 @@ void GSFProcessor::produce(framework::Event& event) {
     trk.setPdgID(track.getPdgID());
     trk.setTruthProb(track.getTruthProb());
 
-    itrk++;
+    refit_tracks[i_track] = std::move(trk);
+  };  // refit track
 
-    out_tracks.push_back(trk);
+  framework::parallelFor(tracks.size(), n_threads_, refitTrack);
+
+  // Output track container
+  std::vector<ldmx::Track> out_tracks;
+  for (auto& trk : refit_tracks) {
+    if (trk) out_tracks.push_back(std::move(*trk));
+  }
 
-  }  // loop on tracks
 
   event.add(out_trk_collection_, out_tracks);
 }
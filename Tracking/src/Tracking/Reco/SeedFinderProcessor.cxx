@@ -1,7 +1,13 @@
 #include "Tracking/Reco/SeedFinderProcessor.h"
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <tuple>
+
 #include "Acts/Definitions/TrackParametrization.hpp"
 #include "Acts/Seeding/EstimateTrackParamsFromSeed.hpp"
+#include "Acts/Surfaces/RectangleBounds.hpp"
 #include "Eigen/Dense"
 #include "Tracking/Sim/TrackingUtils.h"
 
@@ -82,6 +88,17 @@ void SeedFinderProcessor::configure(framework::config::Parameters& parameters) {
       "inflate_factors", {10., 10., 10., 10., 10., 10.});
 
   bfield_ = parameters.getParameter<double>("bfield", 1.5);
+
+  binned_seeding_ = parameters.getParameter<bool>("binned_seeding", false);
+  doublet_max_dydx_ = parameters.getParameter<double>("doublet_max_dydx", 1.);
+  doublet_max_dzdx_ = parameters.getParameter<double>("doublet_max_dzdx", 0.5);
+  window_y_ =
+      parameters.getParameter<double>("window_y", 2. * Acts::UnitConstants::mm);
+  window_z_ =
+      parameters.getParameter<double>("window_z", 5. * Acts::UnitConstants::mm);
+  min_lever_arm_ = parameters.getParameter<double>(
+      "min_lever_arm", 1. * Acts::UnitConstants::mm);
+  compare_seeding_ = parameters.getParameter<bool>("compare_seeding", false);
 }
 
 void SeedFinderProcessor::produce(framework::Event& event) {
@@ -91,9 +108,6 @@ void SeedFinderProcessor::produce(framework::Event& event) {
 
   nevents_++;
 
-  // check if SimParticleMap is available for truth matching
-  std::map<int, ldmx::SimParticle> particleMap;
-
   const std::vector<ldmx::Measurement> measurements =
       event.getCollection<ldmx::Measurement>(input_hits_collection_);
 
@@ -145,9 +159,15 @@ void SeedFinderProcessor::produce(framework::Event& event) {
     }
   }
 
+  // check if SimParticleMap is available for truth matching
   if (event.exists("SimParticles")) {
-    particleMap = event.getMap<int, ldmx::SimParticle>("SimParticles");
-    truthMatchingTool_->setup(particleMap, measurements);
+    truth_index_->setParticles(
+        event.getMap<int, ldmx::SimParticle>("SimParticles"));
+    truth_index_->setMeasurements(measurements);
+    truthMatchingTool_->setup(truth_index_);
+  } else if (truthMatchingTool_->configured()) {
+    // the index still points to the particles of an earlier event
+    truthMatchingTool_ = std::make_shared<tracking::sim::TruthMatchingTool>();
   }
 
   ldmx_log(debug) << "Preparing the strategies";
@@ -155,7 +175,33 @@ void SeedFinderProcessor::produce(framework::Event& event) {
   groups_map.clear();
   std::vector<int> strategy = {0, 1, 2, 3, 4};
   bool success = GroupStrips(measurements, strategy);
-  if (success) FindSeedsFromMap(seed_tracks, target_pseudo_meas);
+  if (success) {
+    if (binned_seeding_) {
+      FindSeedsFromBins(seed_tracks, target_pseudo_meas);
+      if (compare_seeding_) {
+        // The exhaustive search only runs for the comparison, so its fits
+        // are dropped from the output buffers and the failure counters
+        auto counters = std::tie(nmissing_, nfailpmin_, nfailpmax_,
+                                 nfaild0min_, nfaild0max_, nfailz0max_,
+                                 nfailphi_, nfailtheta_);
+        const auto saved_counters = std::make_tuple(
+            nmissing_, nfailpmin_, nfailpmax_, nfaild0min_, nfaild0max_,
+            nfailz0max_, nfailphi_, nfailtheta_);
+        const auto n_hits = xhit_.size();
+        const auto n_fits = b0_.size();
+
+        ldmx::Tracks map_seeds;
+        FindSeedsFromMap(map_seeds, target_pseudo_meas);
+        CompareSeeds(map_seeds, seed_tracks);
+
+        counters = saved_counters;
+        for (auto* hits : {&xhit_, &yhit_, &zhit_}) hits->resize(n_hits);
+        for (auto* fits : {&b0_, &b1_, &b2_, &b3_, &b4_}) fits->resize(n_fits);
+      }
+    } else {
+      FindSeedsFromMap(seed_tracks, target_pseudo_meas);
+    }
+  }
 
   /*
   groups_map.clear();
@@ -426,6 +472,16 @@ void SeedFinderProcessor::onProcessEnd() {
   ldmx_log(info) << "Seeds discarded due to multiple hits on layers "
                  << ndoubles_;
   ldmx_log(info) << "not enough seed points " << nmissing_;
+  if (binned_seeding_) {
+    ldmx_log(info) << "Binned seeding doublets/triplets: " << ndoublets_
+                   << "/" << ntriplets_;
+    if (compare_seeding_) {
+      ldmx_log(info) << "Binned seeding found " << ncompare_matched_ << "/"
+                     << ncompare_map_seeds_
+                     << " seeds of the exhaustive search, "
+                     << ncompare_bin_seeds_ << " seeds in total";
+    }
+  }
   ldmx_log(info) << " nfailpmin=" << nfailpmin_;
   ldmx_log(info) << "   nfailpmax=" << nfailpmax_;
   ldmx_log(info) << "   nfaild0max=" << nfaild0max_;
@@ -513,114 +569,315 @@ void SeedFinderProcessor::FindSeedsFromMap(ldmx::Tracks& seeds,
       meas_for_seeds.push_back(*meas);
     }
 
-    std::sort(meas_for_seeds.begin(), meas_for_seeds.end(),
-              [](const ldmx::Measurement& m1, const ldmx::Measurement& m2) {
-                return m1.getGlobalPosition()[0] < m2.getGlobalPosition()[0];
-              });
-
     if (meas_for_seeds.size() < 5) {
       nmissing_++;
       return;
     }
 
-    ldmx_log(debug) << "seedTrack";
+    FitSeed(meas_for_seeds, seeds, pmeas);
 
-    Acts::Vector3 perigee{perigee_location_[0], perigee_location_[1],
-                          perigee_location_[2]};
-
-    ldmx::Track seedTrack =
-        SeedTracker(meas_for_seeds, meas_for_seeds.at(2).getGlobalPosition()[0],
-                    perigee, pmeas);
-
-    bool fail = false;
+    // Go to next combination
+    ldmx_log(debug) << "Go to the next combination";
 
-    // Remove failed fits
-    if (1. / abs(seedTrack.getQoP()) < pmin_) {
-      nfailpmin_++;
-      fail = true;
-    } else if (1. / abs(seedTrack.getQoP()) > pmax_) {
-      nfailpmax_++;
-      fail = true;
+    ++it[K - 1];
+    for (int i = K - 1;
+         (i > 0) && (it[i] == (std::next(groups_iter, i))->second.end()); --i) {
+      it[i] = std::next(groups_iter, i)->second.begin();
+      ++it[i - 1];
     }
+  }
+}  // find seeds
 
-    // Remove large part of fake tracks and duplicates with the following cuts
-    // for various compatibility checks.
-
-    else if (abs(seedTrack.getZ0()) > z0max_) {
-      nfailz0max_++;
-      fail = true;
-    } else if (seedTrack.getD0() < d0min_) {
-      nfaild0min_++;
-      fail = true;
-    } else if (seedTrack.getD0() > d0max_) {
-      nfaild0max_++;
-      fail = true;
-    } else if (abs(seedTrack.getPhi()) > phicut_) {
-      fail = true;
-      nfailphi_++;
-    } else if (abs(seedTrack.getTheta() - piover2_) > thetacut_) {
-      fail = true;
-      nfailtheta_++;
+// Layer-binned seeding. The hits of each seeding layer are sorted along the
+// bending direction (y), so each compatibility window is a binary search in
+// that layer instead of a scan over all of its hits. Seeds are grown from
+// doublets on the two outer layers, extended to triplets with the middle
+// layer inside the sagitta allowed by pmin and completed with the remaining
+// two layers around the parabola through the triplet. Only the surviving
+// five-hit candidates go through the full seed fit.
+// The strategy layers are assumed to be ordered along the beam (x).
+
+void SeedFinderProcessor::FindSeedsFromBins(ldmx::Tracks& seeds,
+                                            const ldmx::Measurements& pmeas) {
+  std::size_t ilayer = 0;
+  for (auto& [layer, hits] : groups_map) {
+    auto& seed_layer = seed_layers_[ilayer++];
+    seed_layer.hits.clear();
+    seed_layer.max_ey = 0.;
+    for (const ldmx::Measurement* meas : hits) {
+      // The strips run along the local v axis of their surface
+      const Acts::Surface* surface = geometry().getSurface(meas->getLayerID());
+      Acts::Vector3 strip =
+          surface->transform(geometry_context()).rotation().col(1);
+      double half_length = 0.;
+      if (const auto* bounds =
+              dynamic_cast<const Acts::RectangleBounds*>(&surface->bounds()))
+        half_length = bounds->halfLengthY();
+      const auto p = meas->getGlobalPosition();
+      seed_layer.hits.push_back({meas, p[0], p[1], p[2],
+                                 std::abs(strip(1)) * half_length,
+                                 std::abs(strip(2)) * half_length});
+      seed_layer.max_ey =
+          std::max(seed_layer.max_ey, seed_layer.hits.back().ey);
     }
+    std::sort(seed_layer.hits.begin(), seed_layer.hits.end(),
+              [](const SeedHit& h1, const SeedHit& h2) { return h1.y < h2.y; });
+    auto [xmin, xmax] = std::minmax_element(
+        seed_layer.hits.begin(), seed_layer.hits.end(),
+        [](const SeedHit& h1, const SeedHit& h2) { return h1.x < h2.x; });
+    seed_layer.xmin = xmin->x;
+    seed_layer.xmax = xmax->x;
+  }
 
-    // If I didn't use the target pseudo measurements in the track finding
-    // I can use them for compatibility with the tagger track
-
-    // TODO this should protect against running this check on tagger seeder.
-    // This is true only if this seeder is not run twice on the tagger after
-    // already having tagger tracks available.
-    if (pmeas.size() > 0) {
-      // I can have multiple target pseudo measurements
-      // A seed is rejected if it is found incompatible with all the target
-      // extrapolations
-
-      bool tgt_compatible = false;
-      for (auto tgt_pseudomeas : pmeas) {
-        // The d0/z0 are in a frame with the same orientation of the target
-        // surface
-        double delta_loc0 =
-            seedTrack.getD0() - tgt_pseudomeas.getLocalPosition()[0];
-        double delta_loc1 =
-            seedTrack.getZ0() - tgt_pseudomeas.getLocalPosition()[1];
-
-        if (abs(delta_loc0) < loc0cut_ && abs(delta_loc1) < loc1cut_) {
-          // found at least 1 compatible target location
-          tgt_compatible = true;
-          break;
-        }
-      }
-    }  // pmeas > 0
-
-    if (!fail) {
-      if (truthMatchingTool_->configured()) {
-        auto truthInfo = truthMatchingTool_->TruthMatch(meas_for_seeds);
-        seedTrack.setTrackID(truthInfo.trackID);
-        seedTrack.setPdgID(truthInfo.pdgID);
-        seedTrack.setTruthProb(truthInfo.truthProb);
+  // Hits of a seeding layer whose y is within half_width of the predicted y.
+  // The prediction is evaluated at both ends of the layer in x and the
+  // window is then checked for each hit at its own x. The window is widened
+  // by the extent of the strips of the layer, the exact check of each hit
+  // uses the extent of its own strip.
+  auto window = [](const SeedLayer& seed_layer, auto&& predict_y,
+                   auto&& half_width) {
+    const double y0 = predict_y(seed_layer.xmin);
+    const double y1 = predict_y(seed_layer.xmax);
+    const double w =
+        std::max(half_width(seed_layer.xmin), half_width(seed_layer.xmax)) +
+        seed_layer.max_ey;
+    auto first = std::lower_bound(
+        seed_layer.hits.begin(), seed_layer.hits.end(), std::min(y0, y1) - w,
+        [](const SeedHit& h, double y) { return h.y < y; });
+    auto last = std::upper_bound(
+        first, seed_layer.hits.end(), std::max(y0, y1) + w,
+        [](double y, const SeedHit& h) { return y < h.y; });
+    return std::make_pair(first, last);
+  };
+
+  // Largest curvature of the y(x) parabola allowed by pmin, see SeedTracker
+  const double max_curvature = 0.3 * bfield_ * 0.001 / (2. * pmin_);
+
+  const auto& [layer0, layer1, layer2, layer3, layer4] = seed_layers_;
+  std::vector<ldmx::Measurement> meas_for_seeds;
+  meas_for_seeds.reserve(5);
+  std::vector<const SeedHit*> hits1, hits3;
+
+  for (const SeedHit& h0 : layer0.hits) {
+    // Doublets with the last layer, inside the allowed slopes
+    auto doublet_y = [&](double) { return h0.y; };
+    auto doublet_w = [&](double x) {
+      return doublet_max_dydx_ * std::abs(x - h0.x) + window_y_ + h0.ey;
+    };
+    auto [first4, last4] = window(layer4, doublet_y, doublet_w);
+    for (auto it4 = first4; it4 != last4; ++it4) {
+      const SeedHit& h4 = *it4;
+      const double dx = h4.x - h0.x;
+      if (std::abs(dx) < min_lever_arm_) continue;
+      if (std::abs(h4.y - h0.y) > doublet_w(h4.x) + h4.ey or
+          std::abs(h4.z - h0.z) > doublet_max_dzdx_ * std::abs(dx) +
+                                      window_z_ + h0.ez + h4.ez) {
+        continue;
       }
+      ndoublets_++;
+
+      // Triplets with the middle layer, around the straight line between
+      // the outer hits within the sagitta allowed by pmin. The line is
+      // uncertain by the extent of the strips it goes through.
+      auto line_y = [&](double x) {
+        return h0.y + (h4.y - h0.y) * (x - h0.x) / dx;
+      };
+      auto line_z = [&](double x) {
+        return h0.z + (h4.z - h0.z) * (x - h0.x) / dx;
+      };
+      auto line_e = [&](double x, double e0, double e4) {
+        return (e0 * std::abs(h4.x - x) + e4 * std::abs(x - h0.x)) /
+               std::abs(dx);
+      };
+      auto sagitta_w = [&](double x) {
+        return max_curvature * std::abs((x - h0.x) * (h4.x - x)) + window_y_ +
+               line_e(x, h0.ey, h4.ey);
+      };
+      auto [first2, last2] = window(layer2, line_y, sagitta_w);
+      for (auto it2 = first2; it2 != last2; ++it2) {
+        const SeedHit& h2 = *it2;
+        if (std::abs(h2.x - h0.x) < min_lever_arm_ or
+            std::abs(h4.x - h2.x) < min_lever_arm_) {
+          continue;
+        }
+        if (std::abs(h2.y - line_y(h2.x)) > sagitta_w(h2.x) + h2.ey or
+            std::abs(h2.z - line_z(h2.x)) >
+                window_z_ + line_e(h2.x, h0.ez, h4.ez) + h2.ez) {
+          continue;
+        }
+        ntriplets_++;
+
+        // Complete the seed with the remaining layers around the parabola
+        // through the triplet, using the Lagrange basis of the three hits
+        auto basis = [&](double x) {
+          return std::array<double, 3>{
+              (x - h2.x) * (x - h4.x) / ((h0.x - h2.x) * (h0.x - h4.x)),
+              (x - h0.x) * (x - h4.x) / ((h2.x - h0.x) * (h2.x - h4.x)),
+              (x - h0.x) * (x - h2.x) / ((h4.x - h0.x) * (h4.x - h2.x))};
+        };
+        auto parabola_y = [&](double x) {
+          auto l = basis(x);
+          return l[0] * h0.y + l[1] * h2.y + l[2] * h4.y;
+        };
+        auto parabola_w = [&](double x) {
+          auto l = basis(x);
+          return window_y_ + std::abs(l[0]) * h0.ey + std::abs(l[1]) * h2.ey +
+                 std::abs(l[2]) * h4.ey;
+        };
+        auto compatible = [&](const SeedHit& h) {
+          return std::abs(h.y - parabola_y(h.x)) <= parabola_w(h.x) + h.ey and
+                 std::abs(h.z - line_z(h.x)) <=
+                     window_z_ + line_e(h.x, h0.ez, h4.ez) + h.ez;
+        };
+        auto collect = [&](const SeedLayer& seed_layer,
+                           std::vector<const SeedHit*>& hits) {
+          hits.clear();
+          auto [first, last] = window(seed_layer, parabola_y, parabola_w);
+          for (auto it = first; it != last; ++it) {
+            if (compatible(*it)) hits.push_back(&*it);
+          }
+        };
+        collect(layer1, hits1);
+        if (hits1.empty()) continue;
+        collect(layer3, hits3);
+
+        for (const SeedHit* h1 : hits1) {
+          for (const SeedHit* h3 : hits3) {
+            meas_for_seeds.clear();
+            meas_for_seeds.push_back(*h0.meas);
+            meas_for_seeds.push_back(*h1->meas);
+            meas_for_seeds.push_back(*h2.meas);
+            meas_for_seeds.push_back(*h3->meas);
+            meas_for_seeds.push_back(*h4.meas);
+            FitSeed(meas_for_seeds, seeds, pmeas);
+          }
+        }
+      }  // middle layer
+    }    // last layer
+  }      // first layer
+}  // find seeds from bins
+
+// Compare the seeds of both engines on the same event. The same five
+// measurements give the same fit, so a seed is found by both if its
+// parameters are identical.
+
+void SeedFinderProcessor::CompareSeeds(const ldmx::Tracks& map_seeds,
+                                       const ldmx::Tracks& bin_seeds) {
+  auto params = [](const ldmx::Track& t) {
+    return std::array<double, 5>{t.getD0(), t.getZ0(), t.getPhi(),
+                                 t.getTheta(), t.getQoP()};
+  };
+  std::vector<std::array<double, 5>> found;
+  found.reserve(bin_seeds.size());
+  for (const auto& seed : bin_seeds) found.push_back(params(seed));
+  std::sort(found.begin(), found.end());
+
+  ncompare_map_seeds_ += map_seeds.size();
+  ncompare_bin_seeds_ += bin_seeds.size();
+  for (const auto& seed : map_seeds) {
+    if (std::binary_search(found.begin(), found.end(), params(seed)))
+      ncompare_matched_++;
+  }
+}
 
-      seeds.push_back(seedTrack);
-    }
+// Fit a seed candidate made of one measurement per seeding layer and keep it
+// if it passes the seed selection.
 
-    else {
-      b0_.pop_back();
-      b1_.pop_back();
-      b2_.pop_back();
-      b3_.pop_back();
-      b4_.pop_back();
-    }
+void SeedFinderProcessor::FitSeed(
+    std::vector<ldmx::Measurement>& meas_for_seeds, ldmx::Tracks& seeds,
+    const ldmx::Measurements& pmeas) {
+  std::sort(meas_for_seeds.begin(), meas_for_seeds.end(),
+            [](const ldmx::Measurement& m1, const ldmx::Measurement& m2) {
+              return m1.getGlobalPosition()[0] < m2.getGlobalPosition()[0];
+            });
 
-    // Go to next combination
-    ldmx_log(debug) << "Go to the next combination";
+  ldmx_log(debug) << "seedTrack";
 
-    ++it[K - 1];
-    for (int i = K - 1;
-         (i > 0) && (it[i] == (std::next(groups_iter, i))->second.end()); --i) {
-      it[i] = std::next(groups_iter, i)->second.begin();
-      ++it[i - 1];
+  Acts::Vector3 perigee{perigee_location_[0], perigee_location_[1],
+                        perigee_location_[2]};
+
+  ldmx::Track seedTrack =
+      SeedTracker(meas_for_seeds, meas_for_seeds.at(2).getGlobalPosition()[0],
+                  perigee, pmeas);
+
+  bool fail = false;
+
+  // Remove failed fits
+  if (1. / abs(seedTrack.getQoP()) < pmin_) {
+    nfailpmin_++;
+    fail = true;
+  } else if (1. / abs(seedTrack.getQoP()) > pmax_) {
+    nfailpmax_++;
+    fail = true;
+  }
+
+  // Remove large part of fake tracks and duplicates with the following cuts
+  // for various compatibility checks.
+
+  else if (abs(seedTrack.getZ0()) > z0max_) {
+    nfailz0max_++;
+    fail = true;
+  } else if (seedTrack.getD0() < d0min_) {
+    nfaild0min_++;
+    fail = true;
+  } else if (seedTrack.getD0() > d0max_) {
+    nfaild0max_++;
+    fail = true;
+  } else if (abs(seedTrack.getPhi()) > phicut_) {
+    fail = true;
+    nfailphi_++;
+  } else if (abs(seedTrack.getTheta() - piover2_) > thetacut_) {
+    fail = true;
+    nfailtheta_++;
+  }
+
+  // If I didn't use the target pseudo measurements in the track finding
+  // I can use them for compatibility with the tagger track
+
+  // TODO this should protect against running this check on tagger seeder.
+  // This is true only if this seeder is not run twice on the tagger after
+  // already having tagger tracks available.
+  if (pmeas.size() > 0) {
+    // I can have multiple target pseudo measurements
+    // A seed is rejected if it is found incompatible with all the target
+    // extrapolations
+
+    bool tgt_compatible = false;
+    for (auto tgt_pseudomeas : pmeas) {
+      // The d0/z0 are in a frame with the same orientation of the target
+      // surface
+      double delta_loc0 =
+          seedTrack.getD0() - tgt_pseudomeas.getLocalPosition()[0];
+      double delta_loc1 =
+          seedTrack.getZ0() - tgt_pseudomeas.getLocalPosition()[1];
+
+      if (abs(delta_loc0) < loc0cut_ && abs(delta_loc1) < loc1cut_) {
+        // found at least 1 compatible target location
+        tgt_compatible = true;
+        break;
+      }
     }
+  }  // pmeas > 0
+
+  if (!fail) {
+    if (truthMatchingTool_->configured()) {
+      auto truthInfo = truthMatchingTool_->TruthMatch(meas_for_seeds);
+      seedTrack.setTrackID(truthInfo.trackID);
+      seedTrack.setPdgID(truthInfo.pdgID);
+      seedTrack.setTruthProb(truthInfo.truthProb);
+    }
+
+    seeds.push_back(seedTrack);
   }
-}  // find seeds
+
+  else {
+    b0_.pop_back();
+    b1_.pop_back();
+    b2_.pop_back();
+    b3_.pop_back();
+    b4_.pop_back();
+  }
+}
 
 }  // namespace reco
 }  // namespace tracking
@@ -181,7 +181,7 @@ void TruthSeedProcessor::createTruthTrack(
 ldmx::Track TruthSeedProcessor::RecoilFullSeed(
     const ldmx::SimParticle& particle, const int trackID,
     const ldmx::SimTrackerHit& hit, const ldmx::SimTrackerHit& ecal_hit,
-    const std::map<int, std::vector<int>>& hit_count_map,
+    const tracking::sim::TrackerHitIndex& hit_index,
     const std::shared_ptr<Acts::Surface>& origin_surface,
     const std::shared_ptr<Acts::Surface>& target_surface,
     const std::shared_ptr<Acts::Surface>& ecal_surface) {
@@ -224,7 +224,7 @@ ldmx::Track TruthSeedProcessor::RecoilFullSeed(
   // Add the hits
   int nhits = 0;
 
-  for (auto sim_hit_idx : hit_count_map.at(smearedTruthTrack.getTrackID())) {
+  for (auto sim_hit_idx : hit_index.hits(smearedTruthTrack.getTrackID())) {
     smearedTruthTrack.addMeasurementIndex(sim_hit_idx);
     nhits += 1;
   }
@@ -237,7 +237,7 @@ ldmx::Track TruthSeedProcessor::RecoilFullSeed(
 ldmx::Track TruthSeedProcessor::TaggerFullSeed(
     const ldmx::SimParticle& beam_electron, const int trackID,
     const ldmx::SimTrackerHit& hit,
-    const std::map<int, std::vector<int>>& hit_count_map,
+    const tracking::sim::TrackerHitIndex& hit_index,
     const std::shared_ptr<Acts::Surface>& origin_surface,
     const std::shared_ptr<Acts::Surface>& target_surface) {
   ldmx::Track truth_track;
@@ -301,7 +301,7 @@ ldmx::Track TruthSeedProcessor::TaggerFullSeed(
 
   int nhits = 0;
 
-  for (auto sim_hit_idx : hit_count_map.at(smearedTruthTrack.getTrackID())) {
+  for (auto sim_hit_idx : hit_index.hits(smearedTruthTrack.getTrackID())) {
     smearedTruthTrack.addMeasurementIndex(sim_hit_idx);
     nhits += 1;
   }
@@ -425,38 +425,14 @@ ldmx::Track TruthSeedProcessor::seedFromTruth(const ldmx::Track& tt,
   return seed;
 }
 
-void TruthSeedProcessor::makeHitCountMap(
-    const std::vector<ldmx::SimTrackerHit>& sim_hits,
-    std::map<int, std::vector<int>>& hit_count_map) {
-  for (int i_sim_hit = 0; i_sim_hit < sim_hits.size(); i_sim_hit++) {
-    auto& sim_hit = sim_hits.at(i_sim_hit);
-    // This track never left a hit before
-    if (!hit_count_map.count(sim_hit.getTrackID())) {
-      hit_count_map[sim_hit.getTrackID()].push_back(i_sim_hit);
-    }
-
-    // This track left a hit before.
-    // Check if it's on a different sensor than the others
-
-    else {
-      int sensorID = tracking::sim::utils::getSensorID(sim_hit);
-      bool foundHit = false;
-
-      for (auto& i_rhit : hit_count_map[sim_hit.getTrackID()]) {
-        int tmp_sensorID =
-            tracking::sim::utils::getSensorID(sim_hits.at(i_rhit));
-
-        if (sensorID == tmp_sensorID) {
-          foundHit = true;
-          break;
-        }
-      }  // loop on the already recorded hits
-
-      if (!foundHit) {
-        hit_count_map[sim_hit.getTrackID()].push_back(i_sim_hit);
-      }
-    }
-  }  // loop on sim hits
+void TruthSeedProcessor::sortScoringHits(std::vector<ScoringHit>& sp_hits) {
+  std::sort(sp_hits.begin(), sp_hits.end(),
+            [](const ScoringHit& hit1, const ScoringHit& hit2) {
+              if (hit1.track_id != hit2.track_id)
+                return hit1.track_id < hit2.track_id;
+              if (hit1.p != hit2.p) return hit1.p > hit2.p;
+              return hit1.index < hit2.index;
+            });
 }
 
 bool TruthSeedProcessor::scoringPlaneHitFilter(
@@ -515,25 +491,27 @@ bool TruthSeedProcessor::scoringPlaneHitFilter(
 
 void TruthSeedProcessor::produce(framework::Event& event) {
   // Retrieve the particleMap
-  auto particleMap{event.getMap<int, ldmx::SimParticle>("SimParticles")};
+  const auto& particleMap{
+      event.getMap<int, ldmx::SimParticle>("SimParticles")};
+  truth_index_.setParticles(particleMap);
 
   // Retrieve the target scoring hits
   // Information is extracted using the
   // scoring plane hit left by the particle at the target.
 
-  const std::vector<ldmx::SimTrackerHit> scoring_hits{
+  const std::vector<ldmx::SimTrackerHit>& scoring_hits{
       event.getCollection<ldmx::SimTrackerHit>(scoring_hits_coll_name_)};
 
   // Retrieve the scoring plane hits at the ECAL
-  const std::vector<ldmx::SimTrackerHit> scoring_hits_ecal{
+  const std::vector<ldmx::SimTrackerHit>& scoring_hits_ecal{
       event.getCollection<ldmx::SimTrackerHit>("EcalScoringPlaneHits")};
 
   // Retrieve the sim hits in the tagger tracker
-  const std::vector<ldmx::SimTrackerHit> tagger_sim_hits =
+  const std::vector<ldmx::SimTrackerHit>& tagger_sim_hits =
       event.getCollection<ldmx::SimTrackerHit>(tagger_sim_hits_coll_name_);
 
   // Retrieve the sim hits in the recoil tracker
-  const std::vector<ldmx::SimTrackerHit> recoil_sim_hits =
+  const std::vector<ldmx::SimTrackerHit>& recoil_sim_hits =
       event.getCollection<ldmx::SimTrackerHit>(recoil_sim_hits_coll_name_);
 
   // If sim hit collections are empty throw a warning
@@ -546,19 +524,13 @@ void TruthSeedProcessor::produce(framework::Event& event) {
                     << event.getEventNumber() << " in run "
                     << event.getEventHeader().getRun() << std::endl;
 
-  // The map stores which track leaves which sim hits
-  std::map<int, std::vector<int>> hit_count_map_recoil;
-  makeHitCountMap(recoil_sim_hits, hit_count_map_recoil);
-
-  std::map<int, std::vector<int>> hit_count_map_tagger;
-  makeHitCountMap(tagger_sim_hits, hit_count_map_tagger);
-
-  // to keep track of how many sim particles leave hits on the scoring plane
-  std::vector<int> recoil_sh_idxs;
-  std::unordered_map<int, std::vector<int>> recoil_sh_count_map;
+  // The index stores which track leaves which sim hits
+  recoil_hit_index_.build(recoil_sim_hits);
+  tagger_hit_index_.build(tagger_sim_hits);
 
-  std::vector<int> tagger_sh_idxs;
-  std::unordered_map<int, std::vector<int>> tagger_sh_count_map;
+  // Scoring plane hits left by the sim particles that could be seeded
+  tagger_sp_hits_.clear();
+  recoil_sp_hits_.clear();
 
   // Target scoring hits for Tagger will have Z<0, Recoil scoring hits will have
   // Z>0
@@ -568,68 +540,23 @@ void TruthSeedProcessor::produce(framework::Event& event) {
 
     Acts::Vector3 p_vec{hit.getMomentum()[0], hit.getMomentum()[1],
                         hit.getMomentum()[2]};
-    double tagger_p_max = 0.;
 
-    // Check if it is a tagger track going fwd that passes basic cuts
-    if (zhit < 0.) {
-      // Tagger selection cuts
-      // Negative scoring plane hit, with momentum > p_cut
-      if (p_vec(2) < 0. || p_vec.norm() < p_cut_) continue;
+    // Tagger and recoil selection cuts
+    // Forward direction with momentum > p_cut
+    if (p_vec(2) < 0. || p_vec.norm() < p_cut_) continue;
 
-      // Check that the hit was left by a charged particle
-      if (abs(particleMap[hit.getTrackID()].getCharge()) < 1e-8) continue;
+    // Check that the hit was left by a charged particle, which also makes
+    // sure the particle is in the truth index for the lookups below
+    if (abs(truth_index_.charge(hit.getTrackID())) < 1e-8) continue;
 
-      if (p_vec.norm() > tagger_p_max) {
-        tagger_sh_count_map[hit.getTrackID()].push_back(i_sh);
-      }
-    }  // Tagger loop
-
-    // Check the recoil hits
-    else {
-      // Recoil selection cuts
-      // Positive scoring plane hit, forward direction with momentum > p_cut
-      if (p_vec(2) < 0. || p_vec.norm() < p_cut_) continue;
-
-      // Check that the hit was left by a charged particle
-      if (abs(particleMap[hit.getTrackID()].getCharge()) < 1e-8) continue;
-
-      recoil_sh_count_map[hit.getTrackID()].push_back(i_sh);
-
-    }  // Recoil
-  }    // loop on Target scoring plane hits
-
-  for (std::pair<int, std::vector<int>> element : recoil_sh_count_map) {
-    std::sort(
-        element.second.begin(), element.second.end(),
-        [&](const int idx1, int idx2) -> bool {
-          const ldmx::SimTrackerHit& hit1 = scoring_hits.at(idx1);
-          const ldmx::SimTrackerHit& hit2 = scoring_hits.at(idx2);
+    // Negative scoring plane hits are tagger hits, positive are recoil hits
+    auto& sp_hits = zhit < 0. ? tagger_sp_hits_ : recoil_sp_hits_;
+    sp_hits.push_back({hit.getTrackID(), p_vec.norm(), i_sh});
+  }  // loop on Target scoring plane hits
 
-          Acts::Vector3 phit1{hit1.getMomentum()[0], hit1.getMomentum()[1],
-                              hit1.getMomentum()[2]};
-          Acts::Vector3 phit2{hit2.getMomentum()[0], hit2.getMomentum()[1],
-                              hit2.getMomentum()[2]};
-
-          return phit1.norm() > phit2.norm();
-        });
-  }
-
-  // Sort tagger hits.
-  for (auto& [_track_id, hit_indices] : tagger_sh_count_map) {
-    std::sort(
-        hit_indices.begin(), hit_indices.end(),
-        [&](const int idx1, int idx2) -> bool {
-          const ldmx::SimTrackerHit& hit1 = scoring_hits.at(idx1);
-          const ldmx::SimTrackerHit& hit2 = scoring_hits.at(idx2);
-
-          Acts::Vector3 phit1{hit1.getMomentum()[0], hit1.getMomentum()[1],
-                              hit1.getMomentum()[2]};
-          Acts::Vector3 phit2{hit2.getMomentum()[0], hit2.getMomentum()[1],
-                              hit2.getMomentum()[2]};
-
-          return phit1.norm() > phit2.norm();
-        });
-  }
+  // The first hit of each track is then the one with the highest momentum
+  sortScoringHits(tagger_sp_hits_);
+  sortScoringHits(recoil_sp_hits_);
 
   // Building of the event truth information and the truth seeds
   // TODO remove the truthtracks in the future as the truth seeds are enough
@@ -655,34 +582,36 @@ void TruthSeedProcessor::produce(framework::Event& event) {
       Acts::Vector3(beamOrigin_[0], beamOrigin_[1], beamOrigin_[2]))};
 
   if (!skip_tagger_) {
-    for (const auto& [track_id, hit_indices] : tagger_sh_count_map) {
-      const ldmx::SimTrackerHit& hit = scoring_hits.at(hit_indices.at(0));
-      const ldmx::SimParticle& phit = particleMap[hit.getTrackID()];
-
-      if (hit_count_map_tagger[hit.getTrackID()].size() > n_min_hits_tagger_) {
+    for (unsigned int i = 0; i < tagger_sp_hits_.size(); i++) {
+      // Only take the first hit of each track: it is the scoring plane hit
+      // with the highest momentum.
+      if (i > 0 &&
+          tagger_sp_hits_[i].track_id == tagger_sp_hits_[i - 1].track_id)
+        continue;
+      const ldmx::SimTrackerHit& hit =
+          scoring_hits.at(tagger_sp_hits_[i].index);
+      const ldmx::SimParticle& phit = *truth_index_.particle(hit.getTrackID());
+
+      if (tagger_hit_index_.nHits(hit.getTrackID()) > n_min_hits_tagger_) {
         ldmx::Track truth_tagger_track;
         createTruthTrack(phit, hit, truth_tagger_track, targetSurface);
-        truth_tagger_track.setNhits(
-            hit_count_map_tagger[hit.getTrackID()].size());
+        truth_tagger_track.setNhits(tagger_hit_index_.nHits(hit.getTrackID()));
         tagger_truth_tracks.push_back(truth_tagger_track);
 
         if (hit.getPdgID() == 11 && hit.getTrackID() < max_track_id_) {
-          ldmx::Track beamETruthSeed = TaggerFullSeed(
-              particleMap[hit.getTrackID()], hit.getTrackID(), hit,
-              hit_count_map_tagger, beamOriginSurface, targetUnboundSurface);
+          ldmx::Track beamETruthSeed =
+              TaggerFullSeed(phit, hit.getTrackID(), hit, tagger_hit_index_,
+                             beamOriginSurface, targetUnboundSurface);
           beam_electrons.push_back(beamETruthSeed);
         }
       }
     }
   }
 
-  // Recover the EcalScoring hits
-  std::vector<ldmx::SimTrackerHit> ecal_spHits =
-      event.getCollection<ldmx::SimTrackerHit>("EcalScoringPlaneHits");
   // Select ECAL hits
   std::vector<ldmx::SimTrackerHit> sel_ecal_spHits;
 
-  for (auto sp_hit : ecal_spHits) {
+  for (const auto& sp_hit : scoring_hits_ecal) {
     if (sp_hit.getMomentum()[2] > 0 && ((sp_hit.getID() & 0xfff) == 31)) {
       sel_ecal_spHits.push_back(sp_hit);
     }
@@ -690,11 +619,13 @@ void TruthSeedProcessor::produce(framework::Event& event) {
 
   // Recoil target surface for truth and seed tracks is the target
 
-  for (std::pair<int, std::vector<int>> element : recoil_sh_count_map) {
-    // Only take the first entry of the vector: it should be the scoring plane
-    // hit with the highest momentum.
-    const ldmx::SimTrackerHit& hit = scoring_hits.at(element.second.at(0));
-    const ldmx::SimParticle& phit = particleMap[hit.getTrackID()];
+  for (unsigned int i = 0; i < recoil_sp_hits_.size(); i++) {
+    // Only take the first hit of each track: it is the scoring plane hit with
+    // the highest momentum.
+    if (i > 0 && recoil_sp_hits_[i].track_id == recoil_sp_hits_[i - 1].track_id)
+      continue;
+    const ldmx::SimTrackerHit& hit = scoring_hits.at(recoil_sp_hits_[i].index);
+    const ldmx::SimParticle& phit = *truth_index_.particle(hit.getTrackID());
     ldmx::SimTrackerHit ecal_hit;
 
     bool foundEcalHit = false;
@@ -707,12 +638,11 @@ void TruthSeedProcessor::produce(framework::Event& event) {
     }
 
     // Findable particle selection
-    if (hit_count_map_recoil[hit.getTrackID()].size() > n_min_hits_recoil_ &&
+    if (recoil_hit_index_.nHits(hit.getTrackID()) > n_min_hits_recoil_ &&
         foundEcalHit && !skip_recoil_) {
-      ldmx::Track truth_recoil_track =
-          RecoilFullSeed(particleMap[hit.getTrackID()], hit.getTrackID(), hit,
-                         ecal_hit, hit_count_map_recoil, targetSurface,
-                         targetUnboundSurface, ecalSurface);
+      ldmx::Track truth_recoil_track = RecoilFullSeed(
+          phit, hit.getTrackID(), hit, ecal_hit, recoil_hit_index_,
+          targetSurface, targetUnboundSurface, ecalSurface);
       recoil_truth_tracks.push_back(truth_recoil_track);
     }
   }
@@ -721,7 +651,7 @@ void TruthSeedProcessor::produce(framework::Event& event) {
     for (std::pair<int,std::vector<int>> element : recoil_sh_count_map) {
 
     const ldmx::SimTrackerHit& hit  = scoring_hits.at(element.second.at(0));
-    const ldmx::SimParticle&   phit = particleMap[hit.getTrackID()];
+    const ldmx::SimParticle&   phit = particleMap.at(hit.getTrackID());
 
     if (hit_count_map_recoil[hit.getTrackID()].size() > n_min_hits_recoil_) {
     ldmx::Track truth_recoil_track;
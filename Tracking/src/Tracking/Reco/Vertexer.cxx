@@ -1,7 +1,10 @@
 #include "Tracking/Reco/Vertexer.h"
 
+#include <algorithm>
 #include <chrono>
+#include <optional>
 
+#include "Framework/ParallelFor.h"
 #include "TFile.h"
 using namespace framework;
 
@@ -86,6 +89,40 @@ void Vertexer::configure(framework::config::Parameters& parameters) {
       parameters.getParameter<std::string>("trk_c_name_1", "TaggerTracks");
   trk_c_name_2 =
       parameters.getParameter<std::string>("trk_c_name_2", "RecoilTracks");
+
+  max_doca_ = parameters.getParameter<double>("max_doca", 10.);
+  min_opening_angle_ = parameters.getParameter<double>("min_opening_angle", 0.);
+  max_opening_angle_ =
+      parameters.getParameter<double>("max_opening_angle", M_PI);
+  opposite_charge_ = parameters.getParameter<bool>("opposite_charge", false);
+  n_threads_ = parameters.getParameter<int>("n_threads", 1);
+}
+
+bool Vertexer::passPairPrefilter(const PairTrack& trk_1,
+                                 const PairTrack& trk_2) const {
+  if (opposite_charge_ && trk_1.charge * trk_2.charge >= 0) return false;
+
+  double cos_angle =
+      std::clamp(trk_1.direction.dot(trk_2.direction), -1., 1.);
+  double opening_angle = std::acos(cos_angle);
+  if (opening_angle < min_opening_angle_ || opening_angle > max_opening_angle_)
+    return false;
+
+  // Closest approach of the two lines
+  Acts::Vector3 w = trk_1.position - trk_2.position;
+  double d1 = trk_1.direction.dot(w);
+  double d2 = trk_2.direction.dot(w);
+  double den = 1. - cos_angle * cos_angle;
+  double doca = 0.;
+  if (den < 1e-12) {
+    // Parallel tracks
+    doca = (w - d1 * trk_1.direction).norm();
+  } else {
+    double s1 = (cos_angle * d2 - d1) / den;
+    double s2 = (d2 - cos_angle * d1) / den;
+    doca = (w + s1 * trk_1.direction - s2 * trk_2.direction).norm();
+  }
+  return doca <= max_doca_;
 }
 
 void Vertexer::produce(framework::Event& event) {
@@ -109,8 +146,6 @@ void Vertexer::produce(framework::Event& event) {
   VertexFitter::Config vertexFitterCfg;
   VertexFitter billoirFitter(vertexFitterCfg);
 
-  VertexFitter::State state(sp_interpolated_bField_->makeCache(bctx_));
-
   // Unconstrained fit
   // See
   // https://github.com/acts-project/acts/blob/main/Tests/UnitTests/Core/Vertexing/FullBilloirVertexFitterTests.cpp#L149
@@ -120,9 +155,9 @@ void Vertexer::produce(framework::Event& event) {
 
   // Retrive the two track collections
 
-  const std::vector<ldmx::Track> tracks_1 =
+  const std::vector<ldmx::Track>& tracks_1 =
       event.getCollection<ldmx::Track>(trk_c_name_1);
-  const std::vector<ldmx::Track> tracks_2 =
+  const std::vector<ldmx::Track>& tracks_2 =
       event.getCollection<ldmx::Track>(trk_c_name_2);
 
   ldmx_log(debug) << "Retrieved track collections" << std::endl
@@ -157,46 +192,68 @@ void Vertexer::produce(framework::Event& event) {
         tracking::sim::utils::boundTrackParameters(trk, perigeeSurface));
   }
 
-  std::vector<Acts::Vertex<Acts::BoundTrackParameters> > fit_vertices;
-
-  for (auto& b_trk_1 : billoir_tracks_1) {
-    std::vector<const Acts::BoundTrackParameters*> fit_tracks_ptr;
-
-    for (auto& b_trk_2 : billoir_tracks_2) {
-      fit_tracks_ptr.push_back(&b_trk_1);
-      fit_tracks_ptr.push_back(&b_trk_2);
+  // Cheap kinematic quantities of every track, for the pair prefilter
+  auto pairTrack = [&](const Acts::BoundTrackParameters& params) {
+    return PairTrack{params.position(gctx_), params.unitDirection(),
+                     params.charge()};
+  };
+  std::vector<PairTrack> pair_tracks_1, pair_tracks_2;
+  for (auto& b_trk : billoir_tracks_1)
+    pair_tracks_1.push_back(pairTrack(b_trk));
+  for (auto& b_trk : billoir_tracks_2)
+    pair_tracks_2.push_back(pairTrack(b_trk));
+
+  pairs_.clear();
+  for (unsigned int i_1 = 0; i_1 < pair_tracks_1.size(); i_1++) {
+    for (unsigned int i_2 = 0; i_2 < pair_tracks_2.size(); i_2++) {
+      if (passPairPrefilter(pair_tracks_1[i_1], pair_tracks_2[i_2]))
+        pairs_.emplace_back(i_1, i_2);
+    }  // loop on second set of tracks
+  }    // loop on first set
+  npairs_ += pair_tracks_1.size() * pair_tracks_2.size();
+  nreconstructable_ += pairs_.size();
+
+  ldmx_log(debug) << pairs_.size() << " pairs out of "
+                  << pair_tracks_1.size() * pair_tracks_2.size()
+                  << " pass the prefilter";
+
+  // Each worker needs its own fitter state
+  std::vector<std::unique_ptr<VertexFitter::State> > states;
+  for (int worker = 0; worker < std::max(n_threads_, 1); worker++) {
+    states.push_back(std::make_unique<VertexFitter::State>(
+        sp_interpolated_bField_->makeCache(bctx_)));
+  }
 
-      ldmx_log(debug) << "Calling vertex fitter" << std::endl
-                      << "Track 1 parameters" << std::endl
-                      << b_trk_1 << std::endl
-                      << "Track 2 parameters" << std::endl
-                      << b_trk_2 << std::endl;
+  std::vector<std::optional<Acts::Vertex<Acts::BoundTrackParameters> > >
+      pair_vertices(pairs_.size());
 
-      //  std::cout << "Perigee Surface" << std::endl;
-      //  perigeeSurface->toStream(gctx_, std::cout);
-      //  std::cout << std::endl;
+  auto fitPair = [&](std::size_t i_pair, int worker) {
+    std::vector<const Acts::BoundTrackParameters*> fit_tracks_ptr{
+        &billoir_tracks_1[pairs_[i_pair].first],
+        &billoir_tracks_2[pairs_[i_pair].second]};
 
-    }  // loop on second set of tracks
+    auto fit_result = billoirFitter.fit(fit_tracks_ptr, linearizer, vfOptions,
+                                        *states[worker]);
+    if (fit_result.ok()) pair_vertices[i_pair] = std::move(*fit_result);
+  };
 
-    nreconstructable_++;
-    try {
-      // Acts::Vertex<Acts::BoundTrackParameters> fitVtx =
-      // billoirFitter.fit(fit_tracks_ptr, linearizer, vfOptions,
-      // state).value(); fit_vertices.push_back(fitVtx);
-      nvertices_++;
+  framework::parallelFor(pairs_.size(), n_threads_, fitPair);
 
-    } catch (...) {
+  for (std::size_t i_pair = 0; i_pair < pairs_.size(); i_pair++) {
+    if (!pair_vertices[i_pair]) {
       ldmx_log(warn) << "Vertex fit failed" << std::endl;
+      continue;
     }
-
-  }  // loop on first set
+    nvertices_++;
+  }
 
   // Convert the vertices in the ldmx EDM and store them
 }
 
 void Vertexer::onProcessEnd() {
   ldmx_log(info) << "Reconstructed " << nvertices_ << " vertices over "
-                 << nreconstructable_ << " reconstructable" << std::endl;
+                 << nreconstructable_ << " reconstructable out of " << npairs_
+                 << " track pairs" << std::endl;
 
   TFile* outfile_ = new TFile((getName() + ".root").c_str(), "RECREATE");
   outfile_->cd();
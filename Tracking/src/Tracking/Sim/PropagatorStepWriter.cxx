@@ -1,5 +1,7 @@
 #include "Tracking/Sim/PropagatorStepWriter.h"
 
+#include <algorithm>
+
 //--- ACTS --- //
 #include <Acts/Geometry/GeometryIdentifier.hpp>
 #include <Acts/Geometry/TrackingVolume.hpp>
@@ -34,7 +36,6 @@ PropagatorStepWriter::PropagatorStepWriter(
   if (m_outputTree == nullptr) throw std::bad_alloc();
 
   // Set the branches
-  m_outputTree->Branch("event_nr", &m_eventNr);
   m_outputTree->Branch("volume_id", &m_volumeID);
   m_outputTree->Branch("boundary_id", &m_boundaryID);
   m_outputTree->Branch("layer_id", &m_layerID);
@@ -51,15 +52,35 @@ PropagatorStepWriter::PropagatorStepWriter(
   m_outputTree->Branch("step_act", &m_step_act);
   m_outputTree->Branch("step_abt", &m_step_abt);
   m_outputTree->Branch("step_usr", &m_step_usr);
+  m_outputTree->Branch("event_nr", &m_eventNr);
+  m_outputTree->Branch("track_nr", &m_trackNr);
+  m_outputTree->Branch("n_steps", &m_nSteps);
+  m_outputTree->Branch("start_x", &m_start_x);
+  m_outputTree->Branch("start_y", &m_start_y);
+  m_outputTree->Branch("start_z", &m_start_z);
+  m_outputTree->Branch("start_px", &m_start_px);
+  m_outputTree->Branch("start_py", &m_start_py);
+  m_outputTree->Branch("start_pz", &m_start_pz);
+  m_outputTree->Branch("hit_event_nr", &m_hit_eventNr);
   m_outputTree->Branch("hit_x", &m_hit_x);
   m_outputTree->Branch("hit_y", &m_hit_y);
   m_outputTree->Branch("hit_z", &m_hit_z);
-  m_outputTree->Branch("start_pos", &m_start_pos);
-  m_outputTree->Branch("start_mom", &m_start_mom);
+
+  // Every step column holds up to a batch of steps
+  for (auto* buffer : {&m_x, &m_y, &m_z, &m_dx, &m_dy, &m_dz, &m_step_acc,
+                       &m_step_act, &m_step_abt, &m_step_usr})
+    buffer->reserve(m_cfg.flushSteps);
+  for (auto* buffer : {&m_volumeID, &m_boundaryID, &m_layerID, &m_approachID,
+                       &m_sensitiveID, &m_step_type})
+    buffer->reserve(m_cfg.flushSteps);
 
 }  // constructor
 
 PropagatorStepWriter::~PropagatorStepWriter() {
+  {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    flushBuffer();
+  }
   /// Close the file if it's yours
   if (m_cfg.rootFile == nullptr) {
     m_outputFile->cd();
@@ -68,59 +89,63 @@ PropagatorStepWriter::~PropagatorStepWriter() {
   }
 }  // destructor
 
+bool PropagatorStepWriter::acceptStep(int volumeID, int layerID) const {
+  if (!m_cfg.volumes.empty() &&
+      std::find(m_cfg.volumes.begin(), m_cfg.volumes.end(), volumeID) ==
+          m_cfg.volumes.end())
+    return false;
+  if (!m_cfg.layers.empty() &&
+      std::find(m_cfg.layers.begin(), m_cfg.layers.end(), layerID) ==
+          m_cfg.layers.end())
+    return false;
+  return true;
+}
+
+void PropagatorStepWriter::Flush() {
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  flushBuffer();
+}
+
+void PropagatorStepWriter::flushBuffer() {
+  if (m_eventNr.empty() && m_hit_eventNr.empty()) return;
+  m_outputFile->cd();
+  m_outputTree->Fill();
+  clearBuffer();
+}
+
+void PropagatorStepWriter::clearBuffer() {
+  for (auto* buffer : {&m_volumeID, &m_boundaryID, &m_layerID, &m_approachID,
+                       &m_sensitiveID, &m_step_type, &m_eventNr, &m_trackNr,
+                       &m_nSteps, &m_hit_eventNr})
+    buffer->clear();
+  for (auto* buffer :
+       {&m_x, &m_y, &m_z, &m_dx, &m_dy, &m_dz, &m_step_acc, &m_step_act,
+        &m_step_abt, &m_step_usr, &m_start_x, &m_start_y, &m_start_z,
+        &m_start_px, &m_start_py, &m_start_pz, &m_hit_x, &m_hit_y, &m_hit_z})
+    buffer->clear();
+}
+
 bool PropagatorStepWriter::WriteSteps(
     framework::Event& event,
     const std::vector<PropagationSteps>& stepCollection,
     const std::vector<ldmx::Measurement>& measurements,
     const Acts::Vector3& start_pos, const Acts::Vector3& start_mom) {
-  // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
-
-  m_outputFile->cd();
-
   // we get the event number
-  m_eventNr = event.getEventNumber();
-
-  // fill the hits
-  m_hit_x.clear();
-  m_hit_y.clear();
-  m_hit_z.clear();
-  // m_hit_erru.clear();
-  // m_hit_errv.clear();
-
-  m_start_pos.clear();
-  m_start_mom.clear();
-
-  for (auto& meas : measurements) {
-    m_hit_x.push_back(meas.getGlobalPosition()[0]);
-    m_hit_y.push_back(meas.getGlobalPosition()[1]);
-    m_hit_z.push_back(meas.getGlobalPosition()[2]);
-  }
-
-  for (unsigned int i = 0; i < 3; i++) {
-    m_start_pos.push_back(start_pos(i));
-    m_start_mom.push_back(start_mom(i));
-  }
+  int eventNr = event.getEventNumber();
+  if (m_cfg.eventSampling > 1 &&
+      static_cast<std::size_t>(eventNr) % m_cfg.eventSampling != 0)
+    return false;
+  // there is no tree entry to attach the hits to without a propagation
+  if (stepCollection.empty()) return false;
+
+  // Exclusive access to the buffers while writing
+  std::lock_guard<std::mutex> lock(m_writeMutex);
 
   // loop over the step vector of each test propagation in this
-  for (auto& steps : stepCollection) {
-    // clear the vectors for each collection
-    m_volumeID.clear();
-    m_boundaryID.clear();
-    m_layerID.clear();
-    m_approachID.clear();
-    m_sensitiveID.clear();
-    m_x.clear();
-    m_y.clear();
-    m_z.clear();
-    m_dx.clear();
-    m_dy.clear();
-    m_dz.clear();
-    m_step_type.clear();
-    m_step_acc.clear();
-    m_step_act.clear();
-    m_step_abt.clear();
-    m_step_usr.clear();
+  for (std::size_t trackNr = 0; trackNr < stepCollection.size();
+       trackNr += std::max<std::size_t>(m_cfg.trackSampling, 1)) {
+    const auto& steps = stepCollection[trackNr];
+    std::size_t first_step = m_x.size();
 
     // loop over single steps
     for (auto& step : steps) {
@@ -143,6 +168,8 @@ bool PropagatorStepWriter::WriteSteps(
       if (step.volume) {
         volumeID = step.volume->geometryId().volume();
       }
+      if (!acceptStep(volumeID, layerID)) continue;
+
       // now fill
       m_sensitiveID.push_back(sensitiveID);
       m_approachID.push_back(approachID);
@@ -185,8 +212,29 @@ bool PropagatorStepWriter::WriteSteps(
       m_step_abt.push_back(aborter);
       m_step_usr.push_back(user);
     }
-    m_outputTree->Fill();
+
+    // the propagation
+    m_eventNr.push_back(eventNr);
+    m_trackNr.push_back(trackNr);
+    m_nSteps.push_back(m_x.size() - first_step);
+    m_start_x.push_back(start_pos(0));
+    m_start_y.push_back(start_pos(1));
+    m_start_z.push_back(start_pos(2));
+    m_start_px.push_back(start_mom(0));
+    m_start_py.push_back(start_mom(1));
+    m_start_pz.push_back(start_mom(2));
+  }
+
+  // fill the hits, now that the event has a propagation
+  for (auto& meas : measurements) {
+    m_hit_eventNr.push_back(eventNr);
+    m_hit_x.push_back(meas.getGlobalPosition()[0]);
+    m_hit_y.push_back(meas.getGlobalPosition()[1]);
+    m_hit_z.push_back(meas.getGlobalPosition()[2]);
   }
+
+  // Write a batch once enough steps are buffered
+  if (m_x.size() >= m_cfg.flushSteps) flushBuffer();
   return true;
 }
 }  // namespace sim
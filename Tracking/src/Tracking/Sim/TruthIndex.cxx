@@ -0,0 +1,125 @@
+#include "Tracking/Sim/TruthIndex.h"
+
+#include <algorithm>
+
+#include "Tracking/Sim/TrackingUtils.h"
+
+namespace tracking {
+namespace sim {
+
+void TruthIndex::setParticles(
+    const std::map<int, ldmx::SimParticle>& particles) {
+  particle_ids_.clear();
+  particles_.clear();
+  particle_ids_.reserve(particles.size());
+  particles_.reserve(particles.size());
+  // The map is already sorted by track ID
+  for (const auto& [track_id, particle] : particles) {
+    particle_ids_.push_back(track_id);
+    particles_.push_back(&particle);
+  }
+}
+
+const ldmx::SimParticle* TruthIndex::particle(int track_id) const {
+  auto it =
+      std::lower_bound(particle_ids_.begin(), particle_ids_.end(), track_id);
+  if (it == particle_ids_.end() || *it != track_id) return nullptr;
+  return particles_[it - particle_ids_.begin()];
+}
+
+int TruthIndex::pdgID(int track_id) const {
+  const auto* p = particle(track_id);
+  return p ? p->getPdgID() : 0;
+}
+
+double TruthIndex::charge(int track_id) const {
+  const auto* p = particle(track_id);
+  return p ? p->getCharge() : 0.;
+}
+
+void TruthIndex::setMeasurements(
+    const std::vector<ldmx::Measurement>& measurements) {
+  meas_offsets_.assign(1, 0);
+  meas_track_ids_.clear();
+  meas_offsets_.reserve(measurements.size() + 1);
+  for (const auto& meas : measurements) {
+    const auto& track_ids = meas.getTrackIds();
+    meas_track_ids_.insert(meas_track_ids_.end(), track_ids.begin(),
+                           track_ids.end());
+    meas_offsets_.push_back(meas_track_ids_.size());
+  }
+}
+
+TruthIndex::TrackIdRange TruthIndex::measurementTrackIds(
+    std::size_t meas_idx) const {
+  return TrackIdRange(meas_track_ids_.begin() + meas_offsets_.at(meas_idx),
+                      meas_track_ids_.begin() + meas_offsets_.at(meas_idx + 1));
+}
+
+void TruthIndex::setTruthTracks(const std::vector<ldmx::Track>& truth_tracks) {
+  truth_tracks_.clear();
+  truth_tracks_.reserve(truth_tracks.size());
+  for (int i = 0; i < int(truth_tracks.size()); i++)
+    truth_tracks_.emplace_back(truth_tracks[i].getTrackID(), i);
+  // Keeps the first truth track of each track ID first
+  std::sort(truth_tracks_.begin(), truth_tracks_.end());
+}
+
+int TruthIndex::truthTrack(int track_id) const {
+  auto it = std::lower_bound(truth_tracks_.begin(), truth_tracks_.end(),
+                             std::make_pair(track_id, 0));
+  if (it == truth_tracks_.end() || it->first != track_id) return -1;
+  return it->second;
+}
+
+void TrackerHitIndex::build(const std::vector<ldmx::SimTrackerHit>& sim_hits) {
+  keys_.clear();
+  keys_.reserve(sim_hits.size());
+  for (int i = 0; i < int(sim_hits.size()); i++) {
+    const auto& sim_hit = sim_hits[i];
+    keys_.push_back({sim_hit.getTrackID(), utils::getSensorID(sim_hit), i});
+  }
+
+  // Keep the first hit of each track on each sensor
+  std::sort(keys_.begin(), keys_.end(), [](const auto& a, const auto& b) {
+    if (a.track != b.track) return a.track < b.track;
+    if (a.sensor != b.sensor) return a.sensor < b.sensor;
+    return a.index < b.index;
+  });
+  keys_.erase(std::unique(keys_.begin(), keys_.end(),
+                          [](const auto& a, const auto& b) {
+                            return a.track == b.track && a.sensor == b.sensor;
+                          }),
+              keys_.end());
+
+  // and put the hits of each track back in collection order
+  std::sort(keys_.begin(), keys_.end(), [](const auto& a, const auto& b) {
+    if (a.track != b.track) return a.track < b.track;
+    return a.index < b.index;
+  });
+
+  track_ids_.clear();
+  offsets_.clear();
+  hit_indices_.clear();
+  hit_indices_.reserve(keys_.size());
+  for (const auto& key : keys_) {
+    if (track_ids_.empty() || track_ids_.back() != key.track) {
+      track_ids_.push_back(key.track);
+      offsets_.push_back(hit_indices_.size());
+    }
+    hit_indices_.push_back(key.index);
+  }
+  offsets_.push_back(hit_indices_.size());
+}
+
+TrackerHitIndex::IndexRange TrackerHitIndex::hits(int track_id) const {
+  auto it = std::lower_bound(track_ids_.begin(), track_ids_.end(), track_id);
+  if (it == track_ids_.end() || *it != track_id)
+    return IndexRange(hit_indices_.end(), hit_indices_.end());
+  auto i_track = it - track_ids_.begin();
+  return IndexRange(hit_indices_.begin() + offsets_[i_track],
+                    hit_indices_.begin() + offsets_[i_track + 1]);
+}
+
+}  // namespace sim
+}  // namespace tracking
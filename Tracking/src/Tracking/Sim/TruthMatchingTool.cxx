@@ -1,42 +1,42 @@
 #include "Tracking/Reco/TruthMatchingTool.h"
 
+#include <algorithm>
+#include <iostream>
+
 namespace tracking {
 namespace sim {
 
 TruthMatchingTool::TruthInfo TruthMatchingTool::Evaluate(
-    const std::unordered_map<unsigned int, unsigned int>& trk_trackIDs,
-    int n_meas) {
+    std::vector<unsigned int>& trk_trackIDs, int n_meas) const {
   TruthInfo ti;
   ti.truthProb = 0.;
   ti.trackID = -1;
   ti.pdgID = 0;
 
-  for (std::unordered_map<unsigned int, unsigned int>::const_iterator it =
-           trk_trackIDs.begin();
-       it != trk_trackIDs.end(); it++) {
-    double currentTruthProb = (double)it->second / (double)n_meas;
+  // Count the track IDs by runs of equal values
+  std::sort(trk_trackIDs.begin(), trk_trackIDs.end());
+  for (auto it = trk_trackIDs.begin(); it != trk_trackIDs.end();) {
+    auto run_end = std::upper_bound(it, trk_trackIDs.end(), *it);
+    double currentTruthProb = (double)(run_end - it) / (double)n_meas;
     if (currentTruthProb > ti.truthProb) {
       ti.truthProb = currentTruthProb;
-      ti.trackID = it->first;
+      ti.trackID = *it;
     }
+    it = run_end;
   }
 
-  if (ti.trackID > 0) ti.pdgID = map_[ti.trackID].getPdgID();
+  if (ti.trackID > 0) ti.pdgID = truth_index_->pdgID(ti.trackID);
 
   return ti;
 }
 
 TruthMatchingTool::TruthInfo TruthMatchingTool::TruthMatch(
-    const std::vector<ldmx::Measurement>& vmeas) {
-  std::unordered_map<unsigned int, unsigned int> trk_trackIDs;
-
-  for (auto meas : vmeas) {
-    for (auto trkId : meas.getTrackIds()) {
-      if (trk_trackIDs.find(trkId) != trk_trackIDs.end())
-        trk_trackIDs[trkId]++;
-      else
-        trk_trackIDs[trkId] = 1;
-    }
+    const std::vector<ldmx::Measurement>& vmeas) const {
+  std::vector<unsigned int> trk_trackIDs;
+
+  for (const auto& meas : vmeas) {
+    const auto& trackIds = meas.getTrackIds();
+    trk_trackIDs.insert(trk_trackIDs.end(), trackIds.begin(), trackIds.end());
   }  // loop on measurements
 
   return Evaluate(trk_trackIDs, vmeas.size());
@@ -52,35 +52,18 @@ TruthMatchingTool::TruthInfo TruthMatchingTool::TruthMatch(
  */
 
 TruthMatchingTool::TruthInfo TruthMatchingTool::TruthMatch(
-    const ldmx::Track& trk) {
-  // Map holding all tracksIds and their frequency
-  std::unordered_map<unsigned int, unsigned int> trk_trackIDs;
+    const ldmx::Track& trk) const {
+  // All trackIds of the measurements on track
+  std::vector<unsigned int> trk_trackIDs;
 
   for (auto measID : trk.getMeasurementsIdxs()) {
-    auto meas = measurements_.at(measID);
+    auto trackIds = truth_index_->measurementTrackIds(measID);
     if (debug_) {
       std::cout << "Getting measurement at ID:" << measID << std::endl;
-      std::cout << meas << std::endl;
-      std::cout << meas.getTrackIds().size() << std::endl;
+      std::cout << trackIds.size() << std::endl;
     }
 
-    for (auto trkId : meas.getTrackIds()) {
-      if (trk_trackIDs.find(trkId) != trk_trackIDs.end()) {
-        trk_trackIDs[trkId]++;
-      } else {
-        trk_trackIDs[trkId] = 1;
-      }
-
-    }  // loop on measurements trackIDs
-
-    if (debug_) {
-      std::cout << "The trackIDs maps look like:" << std::endl;
-      for (std::unordered_map<unsigned int, unsigned int>::iterator it =
-               trk_trackIDs.begin();
-           it != trk_trackIDs.end(); it++) {
-        std::cout << it->first << " " << it->second << std::endl;
-      }
-    }
+    trk_trackIDs.insert(trk_trackIDs.end(), trackIds.begin(), trackIds.end());
   }  // loop on measurements
 
   return Evaluate(trk_trackIDs, trk.getMeasurementsIdxs().size());
@@ -45,6 +45,7 @@ void TrackingRecoDQM::analyze(const framework::Event& event) {
   if (event.exists(truthCollection_)) {
     truthTrackCollection_ = std::make_shared<ldmx::Tracks>(
         event.getCollection<ldmx::Track>(truthCollection_));
+    truth_index_.setTruthTracks(*truthTrackCollection_);
     doTruthComparison = true;
   }
 
@@ -181,16 +182,12 @@ void TrackingRecoDQM::EfficiencyPlots(const std::vector<ldmx::Track>& tracks,
     // Match the tracks to truth
     ldmx::Track* truth_trk = nullptr;
 
-    auto it =
-        std::find_if(truthTrackCollection_->begin(),
-                     truthTrackCollection_->end(), [&](const ldmx::Track& tt) {
-                       return tt.getTrackID() == track.getTrackID();
-                     });
+    int i_truth = truth_index_.truthTrack(track.getTrackID());
 
     double trackTruthProb = track.getTruthProb();
 
-    if (it != truthTrackCollection_->end() && trackTruthProb >= trackProb_cut_)
-      truth_trk = &(*it);
+    if (i_truth >= 0 && trackTruthProb >= trackProb_cut_)
+      truth_trk = &truthTrackCollection_->at(i_truth);
 
     // Match not found
     if (!truth_trk) return;
@@ -346,17 +343,12 @@ void TrackingRecoDQM::TrackMonitoring(const std::vector<ldmx::Track>& tracks,
       // Match to the truth track
       ldmx::Track* truth_trk = nullptr;
 
-      auto it = std::find_if(truthTrackCollection_->begin(),
-                             truthTrackCollection_->end(),
-                             [&](const ldmx::Track& tt) {
-                               return tt.getTrackID() == track.getTrackID();
-                             });
+      int i_truth = truth_index_.truthTrack(track.getTrackID());
 
       double trackTruthProb = track.getTruthProb();
 
-      if (it != truthTrackCollection_->end() &&
-          trackTruthProb >= trackProb_cut_)
-        truth_trk = &(*it);
+      if (i_truth >= 0 && trackTruthProb >= trackProb_cut_)
+        truth_trk = &truthTrackCollection_->at(i_truth);
 
       // Found matched track
       if (truth_trk) {
@@ -449,16 +441,12 @@ void TrackingRecoDQM::TrackStateMonitoring(const ldmx::Tracks& tracks,
     // Match the tracks to truth
     ldmx::Track* truth_trk = nullptr;
 
-    auto it =
-        std::find_if(truthTrackCollection_->begin(),
-                     truthTrackCollection_->end(), [&](const ldmx::Track& tt) {
-                       return tt.getTrackID() == track.getTrackID();
-                     });
+    int i_truth = truth_index_.truthTrack(track.getTrackID());
 
     double trackTruthProb = track.getTruthProb();
 
-    if (it != truthTrackCollection_->end() && trackTruthProb >= trackProb_cut_)
-      truth_trk = &(*it);
+    if (i_truth >= 0 && trackTruthProb >= trackProb_cut_)
+      truth_trk = &truthTrackCollection_->at(i_truth);
 
     // Match not found, skip track
     if (!truth_trk) continue;
@@ -2,30 +2,161 @@
 
 #include "Tracking/geo/GeoUtils.h"
 
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "Framework/FileCache.h"
+
 namespace tracking::geo {
 
+namespace {
+
+/// Identifies a tracking geometry cache file
+constexpr char CACHE_MAGIC[8] = {'L', 'D', 'M', 'X', 'T', 'G', 'E', 'O'};
+
+/// Format of the cache file, a cache in any other format is rebuilt
+constexpr std::uint32_t CACHE_VERSION = 1;
+
+/// Bounds on the sizes read back, to reject corrupted files early
+constexpr std::uint32_t MAX_CACHE_ENTRIES = 4096;
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeString(std::ostream& out, const std::string& str) {
+  writeValue(out, static_cast<std::uint32_t>(str.size()));
+  out.write(str.data(), str.size());
+}
+
+bool readString(std::istream& in, std::string& str) {
+  std::uint32_t size;
+  if (!readValue(in, size) or size > MAX_CACHE_ENTRIES) return false;
+  str.resize(size);
+  return static_cast<bool>(in.read(str.data(), size));
+}
+
+/**
+ * Hash the names and contents of all the GDML files in the directory of the
+ * detector GDML, since the detector GDML includes the sub-detector files.
+ */
+std::uint64_t hashGDML(const std::string& gdml) {
+  boost::filesystem::path dir = boost::filesystem::path(gdml).parent_path();
+  if (dir.empty()) dir = ".";
+  std::vector<boost::filesystem::path> files;
+  for (const auto& entry : boost::filesystem::directory_iterator(dir)) {
+    if (boost::filesystem::is_regular_file(entry.path()) and
+        entry.path().extension() == ".gdml")
+      files.push_back(entry.path());
+  }
+  std::sort(files.begin(), files.end());
+
+  std::uint64_t hash = framework::FileCache::HASH_SEED;
+  for (const auto& file : files) {
+    hash = framework::FileCache::hash(file.filename().string(), hash);
+    std::ifstream in(file.string(), std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    hash = framework::FileCache::hash(contents, hash);
+  }
+  return hash;
+}
+
+void writeLayout(std::ostream& out,
+                 const TrackersTrackingGeometry::TrackerLayout& layout) {
+  for (int i = 0; i < 3; ++i) writeValue(out, layout.position(i));
+  writeValue(out, layout.x_length);
+  writeValue(out, static_cast<std::uint32_t>(layout.layers.size()));
+  for (const auto& [name, sensors] : layout.layers) {
+    writeString(out, name);
+    writeValue(out, static_cast<std::uint32_t>(sensors.size()));
+    for (const auto& sensor : sensors) {
+      for (int row = 0; row < 4; ++row)
+        for (int col = 0; col < 4; ++col)
+          writeValue(out, sensor.transform.matrix()(row, col));
+      writeValue(out, sensor.half_x);
+      writeValue(out, sensor.half_y);
+      writeValue(out, sensor.thickness);
+    }
+  }
+}
+
+bool readLayout(std::istream& in,
+                TrackersTrackingGeometry::TrackerLayout& layout) {
+  for (int i = 0; i < 3; ++i)
+    if (!readValue(in, layout.position(i))) return false;
+  std::uint32_t n_layers;
+  if (!readValue(in, layout.x_length) or !readValue(in, n_layers) or
+      n_layers > MAX_CACHE_ENTRIES)
+    return false;
+  for (std::uint32_t i_layer = 0; i_layer < n_layers; ++i_layer) {
+    std::string name;
+    std::uint32_t n_sensors;
+    if (!readString(in, name) or !readValue(in, n_sensors) or
+        n_sensors == 0 or n_sensors > MAX_CACHE_ENTRIES)
+      return false;
+    auto& sensors = layout.layers[name];
+    sensors.resize(n_sensors);
+    for (auto& sensor : sensors) {
+      for (int row = 0; row < 4; ++row)
+        for (int col = 0; col < 4; ++col)
+          if (!readValue(in, sensor.transform.matrix()(row, col)))
+            return false;
+      if (!readValue(in, sensor.half_x) or !readValue(in, sensor.half_y) or
+          !readValue(in, sensor.thickness))
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 const std::string TrackersTrackingGeometry::NAME = "TrackersTrackingGeometry";
 
 TrackersTrackingGeometry::TrackersTrackingGeometry(
-    const Acts::GeometryContext& gctx, const std::string& gdml, bool debug)
+    const Acts::GeometryContext& gctx, const std::string& gdml, bool debug,
+    const std::string& cache_dir, bool use_cache)
     : TrackingGeometry(NAME, gctx, gdml, debug) {
-  if (debug_) std::cout << "Looking for Tagger and Recoil volumes" << std::endl;
+  std::string cache_path;
+  if (use_cache) {
+    gdml_hash_ = hashGDML(gdml_);
+    cache_path = cachePath(cache_dir);
+  }
 
-  Tagger_ = findDaughterByName(fWorldPhysVol_, "tagger_PV");
-  // v12
-  // BuildTaggerLayoutMap(Tagger_, "LDMXTaggerModuleVolume_physvol");
-  // v14
-  BuildTaggerLayoutMap(Tagger_, "tagger");
-  Acts::CuboidVolumeBuilder::VolumeConfig tagger_volume_cfg =
-      buildTrackerVolume();
+  if (!cache_path.empty() and readLayoutCache(cache_path)) {
+    if (debug_)
+      std::cout << "Read the tracker layouts from " << cache_path << std::endl;
+  } else {
+    loadGDML();
 
-  Recoil_ = findDaughterByName(fWorldPhysVol_, "recoil_PV");
-  BuildRecoilLayoutMap(Recoil_, "recoil");
-  Acts::CuboidVolumeBuilder::VolumeConfig recoil_volume_cfg =
-      buildRecoilVolume();
+    if (debug_)
+      std::cout << "Looking for Tagger and Recoil volumes" << std::endl;
+
+    Tagger_ = findDaughterByName(fWorldPhysVol_, "tagger_PV");
+    // v12
+    // BuildTaggerLayoutMap(Tagger_, "LDMXTaggerModuleVolume_physvol");
+    // v14
+    BuildTaggerLayoutMap(Tagger_, "tagger");
+
+    Recoil_ = findDaughterByName(fWorldPhysVol_, "recoil_PV");
+    BuildRecoilLayoutMap(Recoil_, "recoil");
+
+    // The cache is only an optimization and FileCache warns if it can't be
+    // written, so carry on either way
+    if (!cache_path.empty()) writeLayoutCache(cache_path);
+  }
 
   std::vector<Acts::CuboidVolumeBuilder::VolumeConfig> volBuilderConfigs{
-      tagger_volume_cfg, recoil_volume_cfg};
+      buildVolume("Tagger", tagger_layout),
+      buildVolume("Recoil", recoil_layout)};
 
   // Create the builder
   Acts::CuboidVolumeBuilder cvb;
@@ -50,11 +181,55 @@ TrackersTrackingGeometry::TrackersTrackingGeometry(
   makeLayerSurfacesMap();
 }
 
-// This is basically a copy of the Tagger. TODO:: Make a single method!
-Acts::CuboidVolumeBuilder::VolumeConfig
-TrackersTrackingGeometry::buildRecoilVolume() {
-  Acts::CuboidVolumeBuilder::VolumeConfig subDetVolumeConfig;
-  Acts::Transform3 subDet_transform = GetTransform(*Recoil_, true);
+std::string TrackersTrackingGeometry::cachePath(
+    const std::string& cache_dir) const {
+  std::string dir = framework::FileCache::directory(cache_dir);
+  if (dir.empty()) return "";
+  std::string detector =
+      boost::filesystem::path(gdml_).parent_path().filename().string();
+  if (detector.empty() or detector == ".") detector = "detector";
+  return dir + "/" + detector + "_tracking_" +
+         framework::FileCache::hex(gdml_hash_) + ".bin";
+}
+
+bool TrackersTrackingGeometry::readLayoutCache(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+
+  char magic[sizeof(CACHE_MAGIC)];
+  std::uint32_t version;
+  std::uint64_t hash;
+  if (!in.read(magic, sizeof(magic)) or
+      !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) or
+      !readValue(in, version) or version != CACHE_VERSION or
+      !readValue(in, hash) or hash != gdml_hash_)
+    return false;
+
+  TrackerLayout tagger, recoil;
+  if (!readLayout(in, tagger) or !readLayout(in, recoil) or
+      in.peek() != std::ifstream::traits_type::eof())
+    return false;
+
+  tagger_layout = std::move(tagger);
+  recoil_layout = std::move(recoil);
+  return true;
+}
+
+bool TrackersTrackingGeometry::writeLayoutCache(const std::string& path) const {
+  return framework::FileCache::write(path, [this](std::ostream& out) {
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    writeValue(out, CACHE_VERSION);
+    writeValue(out, gdml_hash_);
+    writeLayout(out, tagger_layout);
+    writeLayout(out, recoil_layout);
+    return static_cast<bool>(out);
+  });
+}
+
+void TrackersTrackingGeometry::GetVolumePlacement(
+    const G4VPhysicalVolume& pvol, TrackerLayout& layout) const {
+  // Get the transform wrt the world volume in tracker frame
+  Acts::Transform3 subDet_transform = GetTransform(pvol, true);
   if (debug_) {
     std::cout << subDet_transform.translation() << std::endl;
     std::cout << subDet_transform.rotation() << std::endl;
@@ -62,99 +237,25 @@ TrackersTrackingGeometry::buildRecoilVolume() {
 
   // Add 1mm to not make it sit on the first layer surface  -  Ask Omar if it's
   // OK
-  Acts::Vector3 sub_det_position = {
+  layout.position = {
       subDet_transform.translation()(0) - 1,
       subDet_transform.translation()(1),
       subDet_transform.translation()(2),
   };
 
   // Get the size of the volume
-  G4Box* subDetBox = (G4Box*)(Recoil_->GetLogicalVolume()->GetSolid());
+  G4Box* subDetBox = (G4Box*)(pvol.GetLogicalVolume()->GetSolid());
 
   // In tracker coordinates. I add 1mm so that it compensates with the 1mm
   // movement of above
-  double x_length =
+  layout.x_length =
       2 * (subDetBox->GetZHalfLength() + 1) * Acts::UnitConstants::mm;
-
-  // double y_length  = 2*subDetBox->GetXHalfLength() * Acts::UnitConstants::mm;
-  // double z_length  = 2*subDetBox->GetYHalfLength() * Acts::UnitConstants::mm;
-
-  // The bField is defined only between -70, 70 along ACTS Z Axis (-130,130 in
-  // the extended version)
-  double y_length = TrackerYLength_;
-  double z_length = TrackerZLength_;
-
-  if (debug_) {
-    std::cout << Recoil_->GetName() << std::endl;
-    std::cout << "position" << std::endl;
-    std::cout << sub_det_position << std::endl;
-    std::cout << "x_length " << x_length << " y_length " << y_length
-              << " z_length " << z_length << std::endl;
-  }
-
-  subDetVolumeConfig.position = sub_det_position;
-  subDetVolumeConfig.length = {x_length, y_length, z_length};
-  subDetVolumeConfig.name = "Recoil";
-
-  // Vacuum material
-  Acts::Material subdet_mat = Acts::Material();
-  subDetVolumeConfig.volumeMaterial =
-      std::make_shared<Acts::HomogeneousVolumeMaterial>(subdet_mat);
-
-  std::vector<Acts::CuboidVolumeBuilder::LayerConfig> layerConfig;
-
-  // Prepare the layers
-  for (auto& layer : recoil_layout) {
-    if (debug_) {
-      std::cout << layer.first << " : surfaces==>" << layer.second.size()
-                << std::endl;
-    }
-
-    Acts::CuboidVolumeBuilder::LayerConfig lcfg;
-    lcfg.surfaces = layer.second;
-    // Get the surface thickness
-    double clearance = 0.01;
-    double thickness = layer.second.front()
-                           ->surfaceMaterial()
-                           ->materialSlab(Acts::Vector2{0., 0.})
-                           .thickness();
-
-    // std::cout<<"Sensor Thickness from Material slab "<< thickness<<std::endl;
-
-    lcfg.envelopeX = std::array<double, 2>{thickness / 2. + clearance,
-                                           thickness / 2. + clearance};
-    lcfg.active = true;
-    layerConfig.push_back(lcfg);
-  }
-
-  subDetVolumeConfig.layerCfg = layerConfig;
-
-  return subDetVolumeConfig;
 }
 
-Acts::CuboidVolumeBuilder::VolumeConfig
-TrackersTrackingGeometry::buildTrackerVolume() {
+Acts::CuboidVolumeBuilder::VolumeConfig TrackersTrackingGeometry::buildVolume(
+    const std::string& name, const TrackerLayout& layout) {
   Acts::CuboidVolumeBuilder::VolumeConfig subDetVolumeConfig;
 
-  // Get the transform wrt the world volume in tracker frame
-  Acts::Transform3 subDet_transform = GetTransform(*Tagger_, true);
-
-  // Add 1mm to not make it sit on the first layer surface  -  Ask Omar if it's
-  // OK
-  Acts::Vector3 sub_det_position = {
-      subDet_transform.translation()(0) - 1,
-      subDet_transform.translation()(1),
-      subDet_transform.translation()(2),
-  };
-
-  // Get the size of the volume
-  G4Box* subDetBox = (G4Box*)(Tagger_->GetLogicalVolume()->GetSolid());
-
-  // In tracker coordinates. I add 1mm so that it compensates with the 1mm
-  // movement of above
-  double x_length =
-      2 * (subDetBox->GetZHalfLength() + 1) * Acts::UnitConstants::mm;
-
   // double y_length  = 2*subDetBox->GetXHalfLength() * Acts::UnitConstants::mm;
   // double z_length  = 2*subDetBox->GetYHalfLength() * Acts::UnitConstants::mm;
 
@@ -164,19 +265,16 @@ TrackersTrackingGeometry::buildTrackerVolume() {
   double z_length = TrackerZLength_;
 
   if (debug_) {
-    std::cout << Tagger_->GetName() << std::endl;
+    std::cout << name << std::endl;
     std::cout << "position" << std::endl;
-    std::cout << sub_det_position << std::endl;
-    std::cout << "x_length " << x_length << " y_length " << y_length
+    std::cout << layout.position << std::endl;
+    std::cout << "x_length " << layout.x_length << " y_length " << y_length
               << " z_length " << z_length << std::endl;
-
-    std::cout << subDet_transform.translation() << std::endl;
-    std::cout << subDet_transform.rotation() << std::endl;
   }
 
-  subDetVolumeConfig.position = sub_det_position;
-  subDetVolumeConfig.length = {x_length, y_length, z_length};
-  subDetVolumeConfig.name = "Tagger";
+  subDetVolumeConfig.position = layout.position;
+  subDetVolumeConfig.length = {layout.x_length, y_length, z_length};
+  subDetVolumeConfig.name = name;
 
   // Vacuum material
   Acts::Material subdet_mat = Acts::Material();
@@ -186,23 +284,20 @@ TrackersTrackingGeometry::buildTrackerVolume() {
   std::vector<Acts::CuboidVolumeBuilder::LayerConfig> layerConfig;
 
   // Prepare the layers
-  for (auto& layer : tagger_layout) {
+  for (auto& layer : layout.layers) {
     if (debug_) {
       std::cout << layer.first << " : surfaces==>" << layer.second.size()
                 << std::endl;
-      for (auto& surface : layer.second) surface->toStream(gctx_, std::cout);
     }
 
     Acts::CuboidVolumeBuilder::LayerConfig lcfg;
-    lcfg.surfaces = layer.second;
+    for (auto& sensor : layer.second) {
+      lcfg.surfaces.push_back(makeSurface(sensor));
+      if (debug_) lcfg.surfaces.back()->toStream(gctx_, std::cout);
+    }
     // Get the surface thickness
     double clearance = 0.01;
-    double thickness = layer.second.front()
-                           ->surfaceMaterial()
-                           ->materialSlab(Acts::Vector2{0., 0.})
-                           .thickness();
-
-    // std::cout<<"Sensor Thickness from Material slab "<< thickness<<std::endl;
+    double thickness = layer.second.front().thickness;
 
     lcfg.envelopeX = std::array<double, 2>{thickness / 2. + clearance,
                                            thickness / 2. + clearance};
@@ -223,6 +318,8 @@ void TrackersTrackingGeometry::BuildRecoilLayoutMap(G4VPhysicalVolume* pvol,
     getAllDaughters(pvol);
   }
 
+  GetVolumePlacement(*pvol, recoil_layout);
+
   // Get the global transform
   Acts::Transform3 tracker_transform = GetTransform(*pvol);
 
@@ -286,25 +383,25 @@ void TrackersTrackingGeometry::BuildRecoilLayoutMap(G4VPhysicalVolume* pvol,
       if (_Component0Volume)
         ref2_transform = GetTransform(*(_Component0Volume));
 
-      std::shared_ptr<Acts::PlaneSurface> sensorSurface = GetSurface(
+      SensorPlacement sensor = GetSensorPlacement(
           _ActiveSensor, tracker_transform * ref1_transform * ref2_transform);
 
       // Build the layout
       if (sln == "recoil_l1_axial" || sln == "recoil_l1_stereo" ||
           SensorCopyNr == 10 || SensorCopyNr == 20)
-        recoil_layout["recoil_tracker_L1"].push_back(sensorSurface);
+        recoil_layout.layers["recoil_tracker_L1"].push_back(sensor);
 
       if (sln == "recoil_l2_axial" || sln == "recoil_l2_stereo" ||
           SensorCopyNr == 30 || SensorCopyNr == 40)
-        recoil_layout["recoil_tracker_L2"].push_back(sensorSurface);
+        recoil_layout.layers["recoil_tracker_L2"].push_back(sensor);
 
       if (sln == "recoil_l3_axial" || sln == "recoil_l3_stereo" ||
           SensorCopyNr == 50 || SensorCopyNr == 60)
-        recoil_layout["recoil_tracker_L3"].push_back(sensorSurface);
+        recoil_layout.layers["recoil_tracker_L3"].push_back(sensor);
 
       if (sln == "recoil_l4_axial" || sln == "recoil_l4_stereo" ||
           SensorCopyNr == 70 || SensorCopyNr == 80)
-        recoil_layout["recoil_tracker_L4"].push_back(sensorSurface);
+        recoil_layout.layers["recoil_tracker_L4"].push_back(sensor);
 
       if (sln == "recoil_l5_sensor1" || sln == "recoil_l5_sensor2" ||
           sln == "recoil_l5_sensor3" || sln == "recoil_l5_sensor4" ||
@@ -313,7 +410,7 @@ void TrackersTrackingGeometry::BuildRecoilLayoutMap(G4VPhysicalVolume* pvol,
           sln == "recoil_l5_sensor9" || sln == "recoil_l5_sensor10" ||
           (SensorCopyNr >= 90 && SensorCopyNr <= 99))
 
-        recoil_layout["recoil_tracker_L5"].push_back(sensorSurface);
+        recoil_layout.layers["recoil_tracker_L5"].push_back(sensor);
 
       if (sln == "recoil_l6_sensor1" || sln == "recoil_l6_sensor2" ||
           sln == "recoil_l6_sensor3" || sln == "recoil_l6_sensor4" ||
@@ -321,7 +418,7 @@ void TrackersTrackingGeometry::BuildRecoilLayoutMap(G4VPhysicalVolume* pvol,
           sln == "recoil_l6_sensor7" || sln == "recoil_l6_sensor8" ||
           sln == "recoil_l6_sensor9" || sln == "recoil_l6_sensor10" ||
           (SensorCopyNr >= 100 && SensorCopyNr <= 109))
-        recoil_layout["recoil_tracker_L6"].push_back(sensorSurface);
+        recoil_layout.layers["recoil_tracker_L6"].push_back(sensor);
 
     }  // found the daughter
   }    // loop on daughters
@@ -338,6 +435,8 @@ void TrackersTrackingGeometry::BuildTaggerLayoutMap(G4VPhysicalVolume* pvol,
     getAllDaughters(pvol);
   }
 
+  GetVolumePlacement(*pvol, tagger_layout);
+
   // Get the global transform
   Acts::Transform3 tracker_transform = GetTransform(*pvol);
 
@@ -400,53 +499,54 @@ void TrackersTrackingGeometry::BuildTaggerLayoutMap(G4VPhysicalVolume* pvol,
       }
 
       // Get the surface
-      std::shared_ptr<Acts::PlaneSurface> sensorSurface = GetSurface(
+      SensorPlacement sensor = GetSensorPlacement(
           _ActiveSensor, tracker_transform * ref1_transform * ref2_transform);
 
       if (sln == "LDMXTaggerModuleVolume_physvol1" ||
           sln == "LDMXTaggerModuleVolume_physvol2" || SensorCopyNr == 130 ||
           SensorCopyNr == 140)
-        tagger_layout["tagger_tracker_L1"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L1"].push_back(sensor);
 
       if (sln == "LDMXTaggerModuleVolume_physvol3" ||
           sln == "LDMXTaggerModuleVolume_physvol4" || SensorCopyNr == 110 ||
           SensorCopyNr == 120)
-        tagger_layout["tagger_tracker_L2"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L2"].push_back(sensor);
 
       if (sln == "LDMXTaggerModuleVolume_physvol5" ||
           sln == "LDMXTaggerModuleVolume_physvol6" || SensorCopyNr == 90 ||
           SensorCopyNr == 100)
-        tagger_layout["tagger_tracker_L3"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L3"].push_back(sensor);
 
       if (sln == "LDMXTaggerModuleVolume_physvol7" ||
           sln == "LDMXTaggerModuleVolume_physvol8" || SensorCopyNr == 70 ||
           SensorCopyNr == 80)
-        tagger_layout["tagger_tracker_L4"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L4"].push_back(sensor);
 
       if (sln == "LDMXTaggerModuleVolume_physvol9" ||
           sln == "LDMXTaggerModuleVolume_physvol10" || SensorCopyNr == 50 ||
           SensorCopyNr == 60)
-        tagger_layout["tagger_tracker_L5"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L5"].push_back(sensor);
 
       if (sln == "LDMXTaggerModuleVolume_physvol11" ||
           sln == "LDMXTaggerModuleVolume_physvol12" || SensorCopyNr == 30 ||
           SensorCopyNr == 40)
-        tagger_layout["tagger_tracker_L6"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L6"].push_back(sensor);
 
       if (sln == "LDMXTaggerModuleVolume_physvol13" ||
           sln == "LDMXTaggerModuleVolume_physvol14" || SensorCopyNr == 10 ||
           SensorCopyNr == 20)
-        tagger_layout["tagger_tracker_L7"].push_back(sensorSurface);
+        tagger_layout.layers["tagger_tracker_L7"].push_back(sensor);
 
     }  // found a silicon surface
   }    // loop on daughters
 }  // build the layout
 
-std::shared_ptr<Acts::PlaneSurface> TrackersTrackingGeometry::GetSurface(
-    G4VPhysicalVolume* pvol, Acts::Transform3 ref_trans) {
+TrackersTrackingGeometry::SensorPlacement
+TrackersTrackingGeometry::GetSensorPlacement(G4VPhysicalVolume* pvol,
+                                             Acts::Transform3 ref_trans) const {
   if (!pvol)
     throw std::runtime_error(
-        "TrackersTrackingGeometry::GetSurface:: pvol is nullptr");
+        "TrackersTrackingGeometry::GetSensorPlacement:: pvol is nullptr");
 
   // Get the surface transform
   Acts::Transform3 surface_transform = GetTransform(*pvol);
@@ -472,6 +572,27 @@ std::shared_ptr<Acts::PlaneSurface> TrackersTrackingGeometry::GetSurface(
     std::cout << surface_transform_tracker.rotation() << std::endl;
   }
 
+  // Get the active sensor box
+  G4Box* surfaceSolid = (G4Box*)(pvol->GetLogicalVolume()->GetSolid());
+
+  if (debug_) {
+    std::cout << "Sensor Dimensions" << std::endl;
+    std::cout << surfaceSolid->GetXHalfLength() << " "
+              << surfaceSolid->GetYHalfLength() << " "
+              << surfaceSolid->GetZHalfLength() << " " << std::endl;
+  }
+
+  SensorPlacement placement;
+  placement.transform = surface_transform_tracker;
+  placement.half_x = surfaceSolid->GetXHalfLength() * Acts::UnitConstants::mm;
+  placement.half_y = surfaceSolid->GetYHalfLength() * Acts::UnitConstants::mm;
+  placement.thickness =
+      2 * surfaceSolid->GetZHalfLength() * Acts::UnitConstants::mm;
+  return placement;
+}
+
+std::shared_ptr<Acts::PlaneSurface> TrackersTrackingGeometry::makeSurface(
+    const SensorPlacement& placement) {
   // This material is defined in different units with respect what acts expects.
   // I decided to hardcode here. TODO: fix this
 
@@ -501,30 +622,17 @@ std::shared_ptr<Acts::PlaneSurface> TrackersTrackingGeometry::GetSurface(
       95.7 * Acts::UnitConstants::mm, 465.2 * Acts::UnitConstants::mm, 28.03,
       14., 2.32 * Acts::UnitConstants::g / Acts::UnitConstants::cm3);
 
-  // Get the active sensor box
-  G4Box* surfaceSolid = (G4Box*)(pvol->GetLogicalVolume()->GetSolid());
-
-  if (debug_) {
-    std::cout << "Sensor Dimensions" << std::endl;
-    std::cout << surfaceSolid->GetXHalfLength() << " "
-              << surfaceSolid->GetYHalfLength() << " "
-              << surfaceSolid->GetZHalfLength() << " " << std::endl;
-  }
-
   // Form the material slab
-  double thickness =
-      2 * surfaceSolid->GetZHalfLength() * Acts::UnitConstants::mm;
-  Acts::MaterialSlab silicon_slab(silicon, thickness);
+  Acts::MaterialSlab silicon_slab(silicon, placement.thickness);
 
   // Get the bounds
   std::shared_ptr<const Acts::RectangleBounds> rect_bounds =
-      std::make_shared<const Acts::RectangleBounds>(Acts::RectangleBounds(
-          surfaceSolid->GetXHalfLength() * Acts::UnitConstants::mm,
-          surfaceSolid->GetYHalfLength() * Acts::UnitConstants::mm));
+      std::make_shared<const Acts::RectangleBounds>(
+          Acts::RectangleBounds(placement.half_x, placement.half_y));
 
   // Form the active sensor surface
   std::shared_ptr<Acts::PlaneSurface> surface =
-      Acts::Surface::makeShared<Acts::PlaneSurface>(surface_transform_tracker,
+      Acts::Surface::makeShared<Acts::PlaneSurface>(placement.transform,
                                                     rect_bounds);
   surface->assignSurfaceMaterial(
       std::make_shared<Acts::HomogeneousSurfaceMaterial>(silicon_slab));
@@ -533,7 +641,7 @@ std::shared_ptr<Acts::PlaneSurface> TrackersTrackingGeometry::GetSurface(
   // The default transformation is the surface parsed transformation
 
   auto detElement = std::make_shared<DetectorElement>(
-      surface, surface_transform_tracker, thickness);
+      surface, placement.transform, placement.thickness);
 
   // This is the call that modify the behaviour of surface->transform(gctx)
   // After this call each surface will use the underlying detectorElement
@@ -34,6 +34,10 @@ class TrackersTrackingGeometryProvider
   std::string detector_;
   /// whether to have debug information or not
   bool debug_;
+  /// whether to read and write the tracker layouts from a geometry cache
+  bool use_geometry_cache_;
+  /// directory of the geometry cache, the user cache directory if empty
+  std::string geometry_cache_dir_;
 };
 
 TrackersTrackingGeometryProvider::TrackersTrackingGeometryProvider(
@@ -43,6 +47,10 @@ TrackersTrackingGeometryProvider::TrackersTrackingGeometryProvider(
     : framework::ConditionsObjectProvider(name, tag_name, parameters, process) {
   detector_ = parameters.getParameter<std::string>("detector");
   debug_ = parameters.getParameter<bool>("debug");
+  use_geometry_cache_ =
+      parameters.getParameter<bool>("use_geometry_cache", true);
+  geometry_cache_dir_ =
+      parameters.getParameter<std::string>("geometry_cache_dir", "");
 }
 
 std::pair<const framework::ConditionsObject*, framework::ConditionsIOV>
@@ -69,7 +77,9 @@ TrackersTrackingGeometryProvider::getCondition(
    * currently-designed conditions system.
    */
   return std::make_pair(
-      new TrackersTrackingGeometry(the_context->get(), detector_, debug_), iov);
+      new TrackersTrackingGeometry(the_context->get(), detector_, debug_,
+                                   geometry_cache_dir_, use_geometry_cache_),
+      iov);
 }
 }  // namespace tracking::geo
 
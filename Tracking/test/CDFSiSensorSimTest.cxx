@@ -0,0 +1,167 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "Tracking/Digitization/CDFSiSensorSim.h"
+
+using Catch::Approx;
+
+namespace tracking {
+namespace test {
+
+/// Energy deposited by each test hit [MeV]
+static const double EDEP = 0.1;
+
+/// Electrons released by each test hit, 3.62 eV per electron-hole pair
+static const double CHARGE = EDEP * 1e6 / 3.62;
+
+/**
+ * Make a hit in the sensor local frame, centered at (u, 0, w) and going
+ * through the full thickness of the default sensor along the input
+ * direction.
+ */
+ldmx::SimTrackerHit makeHit(double u, double w, double du = 0.,
+                            double dw = 1.) {
+  const double thickness = 0.320;
+  ldmx::SimTrackerHit hit;
+  hit.setPosition(u, 0., w);
+  hit.setMomentum(du, 0., dw);
+  hit.setEdep(EDEP);
+  hit.setPathLength(thickness * std::hypot(du, dw) / std::abs(dw));
+  return hit;
+}
+
+/// Total charge collected on all strips in the last simulation
+double totalCharge(const digitization::CDFSiSensorSim& sim) {
+  const auto& charge = sim.getStripCharge();
+  return std::accumulate(charge.begin(), charge.end(), 0.);
+}
+
+}  // namespace test
+}  // namespace tracking
+
+/**
+ * Is all of the charge of the hits collected on the strips?
+ */
+TEST_CASE("CDFSiSensorSim charge conservation", "[Tracking][functionality]") {
+  using tracking::test::CHARGE;
+  using tracking::test::makeHit;
+  using tracking::test::totalCharge;
+
+  tracking::digitization::CDFSiSensorSim::Sensor sensor;
+  tracking::digitization::CDFSiSensorSim sim(sensor);
+  const auto identity = Acts::Transform3::Identity();
+
+  SECTION("Single hit") {
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(0.01, 0.)};
+    sim.computeElectrodeData(hits, identity);
+    CHECK(sim.getStripCharge().size() == std::size_t(sensor.n_strips));
+    CHECK(totalCharge(sim) == Approx(CHARGE));
+
+    // the readout holds the same charge, split over neighboring strips
+    auto strips = sim.getReadoutStrips();
+    REQUIRE(strips.size() > 1);
+    double readout{0.};
+    for (const auto& strip : strips) {
+      readout += strip.charge;
+      CHECK(strip.hits == std::vector<std::size_t>{0});
+    }
+    CHECK(readout == Approx(CHARGE));
+  }
+
+  SECTION("Inclined hits with Lorentz drift") {
+    sensor.tan_lorentz = 0.1;
+    tracking::digitization::CDFSiSensorSim lorentz_sim(sensor);
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(-3., 0., 0.5),
+                                          makeHit(2., 0.01, -0.2)};
+    lorentz_sim.computeElectrodeData(hits, identity);
+    CHECK(totalCharge(lorentz_sim) == Approx(2 * CHARGE));
+  }
+
+  SECTION("Trapping removes charge") {
+    sim.setTrapping(0.2);
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(0.01, 0.)};
+    sim.computeElectrodeData(hits, identity);
+    CHECK(totalCharge(sim) < CHARGE);
+    CHECK(totalCharge(sim) > 0.);
+  }
+
+  SECTION("Hits are simulated in the sensor frame") {
+    Acts::Transform3 global_to_local{
+        Acts::Transform3::Identity() *
+        Eigen::AngleAxisd(0.5 * M_PI, Acts::Vector3::UnitX())};
+    // the normal of the sensor is along -y in the global frame
+    ldmx::SimTrackerHit hit;
+    hit.setPosition(0.01, 0., 0.);
+    hit.setMomentum(0., -1., 0.);
+    hit.setEdep(tracking::test::EDEP);
+    hit.setPathLength(0.320);
+    std::vector<ldmx::SimTrackerHit> hits{hit};
+    sim.computeElectrodeData(hits, global_to_local);
+    CHECK(totalCharge(sim) == Approx(CHARGE));
+  }
+
+  SECTION("Each call replaces the previous result") {
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(0.01, 0.)};
+    sim.computeElectrodeData(hits, identity);
+    sim.computeElectrodeData(hits, identity);
+    CHECK(totalCharge(sim) == Approx(CHARGE));
+  }
+}
+
+/**
+ * Is the charge clamped to the sensor, never leaving the strip range and
+ * never drifting further than the thickness of the sensor?
+ */
+TEST_CASE("CDFSiSensorSim sensor edges", "[Tracking][functionality]") {
+  using tracking::test::CHARGE;
+  using tracking::test::makeHit;
+  using tracking::test::totalCharge;
+
+  tracking::digitization::CDFSiSensorSim::Sensor sensor;
+  tracking::digitization::CDFSiSensorSim sim(sensor);
+  const auto identity = Acts::Transform3::Identity();
+  const double half_width = 0.5 * sensor.n_strips * sensor.pitch;
+
+  SECTION("Hit on the edge of the strips") {
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(half_width, 0.)};
+    sim.computeElectrodeData(hits, identity);
+    CHECK(sim.getStripCharge().size() == std::size_t(sensor.n_strips));
+    // half of the charge spreads past the last strip
+    CHECK(totalCharge(sim) == Approx(0.5 * CHARGE).epsilon(0.01));
+    auto strips = sim.getReadoutStrips();
+    REQUIRE_FALSE(strips.empty());
+    CHECK(strips.back().strip == sensor.n_strips - 1);
+    for (const auto& strip : strips) {
+      CHECK(strip.strip >= 0);
+      CHECK(strip.strip < sensor.n_strips);
+    }
+  }
+
+  SECTION("Hits outside of the strips") {
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(-half_width - 1., 0.),
+                                          makeHit(half_width + 1., 0.)};
+    sim.computeElectrodeData(hits, identity);
+    CHECK(totalCharge(sim) == 0.);
+    CHECK(sim.getReadoutStrips().empty());
+  }
+
+  SECTION("Hits beyond the faces of the sensor") {
+    // centered outside of the sensor on the strip side and on the far side,
+    // the drift distance is clamped to the sensor instead of going negative
+    // or past the depletion region
+    std::vector<ldmx::SimTrackerHit> hits{makeHit(0.01, 1.),
+                                          makeHit(1.01, -1.)};
+    sim.computeElectrodeData(hits, identity);
+    CHECK(totalCharge(sim) == Approx(2 * CHARGE));
+
+    // no diffusion for the charge that is already on the strips
+    auto strips = sim.getReadoutStrips();
+    REQUIRE_FALSE(strips.empty());
+    int center_strip = int(std::floor((0.01 + half_width) / sensor.pitch));
+    CHECK(strips.front().strip == center_strip);
+    CHECK(strips.front().charge == Approx(CHARGE));
+  }
+}